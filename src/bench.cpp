@@ -0,0 +1,141 @@
+#include "bench.h"
+
+#ifdef LORASCOPE_BENCH
+
+#include "common.h"
+#include "datapath_bench.h"
+#include "point_ring.h"
+#include "display.h"
+#include "rssi_histogram.h"
+#include "rssi_pyramid.h"
+#include "event_query.h"
+#include <esp_timer.h>
+
+// 渲染数据集：固定时钟下的 1000 个点，覆盖 60 s 时间窗口
+const uint16_t RENDER_POINT_COUNT = 1000;
+const uint16_t RENDER_CHANNEL_COUNT = 200;
+const uint16_t RENDER_FRAME_COUNT = 20;
+const uint64_t RENDER_CLOCK_US = 3600ULL * US_PER_SEC;
+const uint16_t RENDER_FRAME_BYTES = 240 * 135 * 2;
+
+static const char* renderModeName(DisplayMode mode) {
+    switch (mode) {
+        case MODE_TIMELINE: return "TIMELINE";
+        case MODE_HISTOGRAM: return "HISTOGRAM";
+        case MODE_EVENTLIST: return "EVENTLIST";
+        case MODE_STATISTICS: return "STATISTICS";
+        case MODE_FREQCOMPARE: return "FREQCOMPARE";
+        case MODE_REALTIME: return "REALTIME";
+        case MODE_RADAR: return "RADAR";
+        case MODE_HEATMAP: return "HEATMAP";
+        default: return "UNKNOWN";
+    }
+}
+
+// 离屏渲染全部视图：逐帧计时并输出帧指纹。设备上的 M5GFX 与主机画布的像素不同，
+// 这里的指纹只用于对照前后两次运行；与黄金指纹的自动比对由主机构建（tools/host 的 render_test）完成
+static bool runRenderBenchmarks(Print& out) {
+    ScopeDisplay display;
+    if (!display.initHeadless()) {
+        out.println("[Bench] headless display init failed");
+        return false;
+    }
+    
+    ChannelPlanRef plan = ChannelPlan::uniform(410125000, 410125000 + (RENDER_CHANNEL_COUNT - 1) * 100000, 100000);
+    
+    PointRing points;
+    points.setCapacity(RENDER_POINT_COUNT);
+    RssiHistogram histogram;
+    histogram.setChannelCount(RENDER_CHANNEL_COUNT);
+    OccupancyHeatmap heatmap;
+    heatmap.setChannelCount(RENDER_CHANNEL_COUNT, 0);
+    heatmap.setTimeOfDay(0, 0);
+    RssiPyramid pyramid;
+    EventStats stats;
+    RadarPoint point;
+    RadarPoint evicted;
+    
+    benchSeed(0x9E3779B9);
+    uint64_t spanUs = 60 * US_PER_SEC;
+    for (uint16_t i = 0; i < RENDER_POINT_COUNT; i++) {
+        benchMakeEvent(&point, i + 1, RENDER_CLOCK_US - spanUs + spanUs * i / RENDER_POINT_COUNT);
+        point.channelIndex %= RENDER_CHANNEL_COUNT;
+        point.frequency = plan->frequencyAt(point.channelIndex);
+        points.push(point, &evicted);
+        histogram.add(point.rssi, point.channelIndex);
+        pyramid.add(point.channelIndex, point.timestampUs(), point.rssi, point.eventType != EVENT_RX_DONE);
+        // 数据集只覆盖 60 s，热力图按序号把点分散到 24 小时
+        heatmap.add(point.channelIndex, (uint64_t)(i % OCCUPANCY_HOURS) * 3600ULL * US_PER_SEC);
+        
+        stats.totalEvents++;
+        if (point.eventType == EVENT_RX_DONE) {
+            stats.rxDoneCount++;
+            stats.rssiSum += point.rssi;
+            if (stats.rxDoneCount == 1 || point.rssi > stats.maxRssi) stats.maxRssi = point.rssi;
+            if (stats.rxDoneCount == 1 || point.rssi < stats.minRssi) stats.minRssi = point.rssi;
+        } else {
+            stats.rxErrorCount++;
+        }
+    }
+    stats.avgRssi = stats.rxDoneCount ? (float)stats.rssiSum / stats.rxDoneCount : -120;
+    stats.firstEventTime = points.front().timestampUs();
+    stats.lastEventTime = points.back().timestampUs();
+    EventIndex index;
+    index.sync(points, RENDER_CHANNEL_COUNT);
+    
+    display.setClockOverride(RENDER_CLOCK_US);
+    display.setChannelPlan(plan);
+    RssiHistogramSnapshot histogramSnapshot;
+    histogram.snapshot(0, &histogramSnapshot);
+    display.setRssiHistogram(&histogramSnapshot);
+    display.setOccupancy(&heatmap);
+    display.setRssiPyramid(&pyramid);
+    display.setEventIndex(&index);
+    display.setCurrentFreq(plan->first());
+    display.setCurrentFreqIndex(0, RENDER_CHANNEL_COUNT);
+    display.setScanning(true);
+    display.setCurrentRssi(-80);
+    
+    out.println("=== Render Benchmarks ===");
+    out.println("  mode           us/frame  checksum");
+    
+    for (uint8_t m = MODE_TIMELINE; m <= MODE_HEATMAP; m++) {
+        DisplayMode mode = (DisplayMode)m;
+        display.setMode(mode);
+        
+        int64_t start = esp_timer_get_time();
+        for (uint16_t i = 0; i < RENDER_FRAME_COUNT; i++) {
+            display.update(points, stats);
+        }
+        uint32_t usPerFrame = (uint32_t)((esp_timer_get_time() - start) / RENDER_FRAME_COUNT);
+        out.printf("  %-12s %10lu  %08lx\n", renderModeName(mode), usPerFrame, display.frameChecksum());
+        
+#ifdef LORASCOPE_BENCH_DUMP
+        // 原始帧以 "FRAME <名称> <字节数>" 行开头，供离线转换为图像
+        out.printf("FRAME %s %lu\n", renderModeName(mode), (unsigned long)RENDER_FRAME_BYTES);
+        display.dumpFrame(out);
+        out.println();
+#endif
+    }
+    
+    return true;
+}
+
+bool runBenchmarks(Print& out) {
+    BenchResult results[DATAPATH_BENCH_COUNT];
+    bool ok = runDataPathBenchmarks(results, out);
+    
+    // 设备上没有基线文件可读，只输出耗时；回退检查由主机构建（tools/host）对照基线完成
+    out.println("=== Benchmarks ===");
+    out.println("  name               ops      ns/op");
+    
+    for (uint8_t i = 0; i < DATAPATH_BENCH_COUNT; i++) {
+        out.printf("  %-16s %7lu %10lu\n", results[i].name, results[i].ops, results[i].nsPerOp());
+    }
+    
+    ok = runRenderBenchmarks(out) && ok;
+    out.println(ok ? "Result: DONE" : "Result: FAILED");
+    return ok;
+}
+
+#endif // LORASCOPE_BENCH
@@ -0,0 +1,11 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+
+// 数据通路基准测试（仅在定义 LORASCOPE_BENCH 时编译，见 platformio.ini 的 m5cardputer_bench 环境）
+// 使用预先生成的合成事件流测量各热点路径的单次耗时，随后离屏渲染全部视图
+// 返回 false 表示未能完成（如离屏画布分配失败）
+bool runBenchmarks(Print& out);
+
+#endif // BENCH_H
@@ -0,0 +1,48 @@
+#include "boot_timing.h"
+#include <freertos/FreeRTOS.h>
+
+BootTiming::Mark BootTiming::marks[BootTiming::MAX_MARKS];
+volatile uint8_t BootTiming::markCount = 0;
+volatile uint32_t BootTiming::firstRxMs = 0;
+
+static portMUX_TYPE bootTimingMux = portMUX_INITIALIZER_UNLOCKED;
+
+void BootTiming::mark(const char* stage) {
+    // millis() 从芯片上电开始计时，因此记录的即为冷启动以来的时间
+    uint32_t now = millis();
+    
+    portENTER_CRITICAL(&bootTimingMux);
+    if (markCount < MAX_MARKS) {
+        marks[markCount].stage = stage;
+        marks[markCount].timeMs = now;
+        markCount++;
+    }
+    portEXIT_CRITICAL(&bootTimingMux);
+}
+
+void BootTiming::markFirstRx() {
+    if (firstRxMs != 0) return;
+    
+    firstRxMs = millis();
+    mark("first RX window");
+    report();
+}
+
+void BootTiming::report() {
+    USBSerial.println("=== Startup Timing ===");
+    
+    uint32_t prev = 0;
+    for (uint8_t i = 0; i < markCount; i++) {
+        USBSerial.printf("  %6lu ms (+%5lu) %s\n",
+            marks[i].timeMs, marks[i].timeMs - prev, marks[i].stage);
+        prev = marks[i].timeMs;
+    }
+    
+    if (firstRxMs == 0) {
+        USBSerial.println("  First RX: not reached yet");
+    } else {
+        USBSerial.printf("  Cold boot to first RX: %lu ms (budget %lu ms) %s\n",
+            firstRxMs, BOOT_FIRST_RX_BUDGET_MS,
+            firstRxMs <= BOOT_FIRST_RX_BUDGET_MS ? "OK" : "OVER BUDGET");
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <Arduino.h>
+
+// 冷启动到首个 RX 窗口打开的时间预算 (ms)
+const uint32_t BOOT_FIRST_RX_BUDGET_MS = 1500;
+
+// 启动计时：记录各启动阶段的时间点，首个 RX 窗口打开时输出报告
+class BootTiming {
+public:
+    static void mark(const char* stage);
+    static void markFirstRx();
+    static void report();
+    
+private:
+    static const uint8_t MAX_MARKS = 16;
+    
+    struct Mark {
+        const char* stage;
+        uint32_t timeMs;
+    };
+    
+    static Mark marks[MAX_MARKS];
+    static volatile uint8_t markCount;
+    static volatile uint32_t firstRxMs;
+};
+
+#endif // BOOT_TIMING_H
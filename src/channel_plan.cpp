@@ -0,0 +1,85 @@
+#include "channel_plan.h"
+#include "fingerprint.h"
+
+ChannelPlan::ChannelPlan(const std::vector<uint32_t>& frequencies)
+    : freqs(frequencies), id(0), grid(false), gridStep(0), slotMask(0) {
+    // 索引为 16 位，CHANNEL_NONE 保留
+    if (freqs.size() >= CHANNEL_NONE) {
+        freqs.resize(CHANNEL_NONE - 1);
+    }
+    id = fingerprintPayload((const uint8_t*)freqs.data(), freqs.size() * sizeof(uint32_t));
+    
+    if (freqs.size() >= 2 && freqs[1] > freqs[0]) {
+        grid = true;
+        gridStep = freqs[1] - freqs[0];
+        for (size_t i = 2; grid && i < freqs.size(); i++) {
+            grid = freqs[i] - freqs[i - 1] == gridStep && freqs[i] > freqs[i - 1];
+        }
+    } else if (freqs.size() == 1) {
+        grid = true;
+        gridStep = 1;
+    }
+    if (grid) return;
+    
+    // 装载因子不超过 1/2
+    size_t capacity = 4;
+    while (capacity < freqs.size() * 2) capacity <<= 1;
+    slots.assign(capacity, CHANNEL_NONE);
+    slotMask = capacity - 1;
+    
+    for (size_t i = 0; i < freqs.size(); i++) {
+        uint32_t slot = hashOf(freqs[i]) & slotMask;
+        while (slots[slot] != CHANNEL_NONE && freqs[slots[slot]] != freqs[i]) {
+            slot = (slot + 1) & slotMask;
+        }
+        // 重复的频率保留第一个索引
+        if (slots[slot] == CHANNEL_NONE) {
+            slots[slot] = i;
+        }
+    }
+}
+
+ChannelPlanRef ChannelPlan::create(const std::vector<uint32_t>& frequencies) {
+    return ChannelPlanRef(new ChannelPlan(frequencies));
+}
+
+ChannelPlanRef ChannelPlan::uniform(uint32_t startHz, uint32_t endHz, uint32_t stepHz) {
+    std::vector<uint32_t> frequencies;
+    if (stepHz > 0 && endHz >= startHz) {
+        frequencies.reserve((endHz - startHz) / stepHz + 1);
+        for (uint64_t freq = startHz; freq <= endHz; freq += stepHz) {
+            frequencies.push_back(freq);
+        }
+    }
+    return create(frequencies);
+}
+
+ChannelPlanRef ChannelPlan::none() {
+    static ChannelPlanRef emptyPlan(new ChannelPlan(std::vector<uint32_t>()));
+    return emptyPlan;
+}
+
+uint32_t ChannelPlan::hashOf(uint32_t frequency) {
+    // 乘法散列，频率低位多为 0，把乘积高位折到低位
+    uint32_t h = frequency * 2654435761UL;
+    return h ^ (h >> 16);
+}
+
+uint16_t ChannelPlan::indexOf(uint32_t frequency) const {
+    if (freqs.empty()) return CHANNEL_NONE;
+    
+    if (grid) {
+        if (frequency < freqs[0]) return CHANNEL_NONE;
+        uint32_t offset = frequency - freqs[0];
+        if (offset % gridStep != 0) return CHANNEL_NONE;
+        uint32_t index = offset / gridStep;
+        return index < freqs.size() ? index : CHANNEL_NONE;
+    }
+    
+    uint32_t slot = hashOf(frequency) & slotMask;
+    while (slots[slot] != CHANNEL_NONE) {
+        if (freqs[slots[slot]] == frequency) return slots[slot];
+        slot = (slot + 1) & slotMask;
+    }
+    return CHANNEL_NONE;
+}
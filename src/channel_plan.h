@@ -0,0 +1,50 @@
+#ifndef CHANNEL_PLAN_H
+#define CHANNEL_PLAN_H
+
+#include <Arduino.h>
+#include <vector>
+#include <memory>
+
+class ChannelPlan;
+// 频点计划创建后不再修改，监听器、统计与显示共享同一份
+typedef std::shared_ptr<const ChannelPlan> ChannelPlanRef;
+
+// 不在计划内的频率
+const uint16_t CHANNEL_NONE = 0xFFFF;
+
+// 频点计划：频点索引 ↔ 频率 (Hz) 双向 O(1) 转换
+// 等间隔计划直接按步进计算，其余计划用开放寻址散列表（约 4 字节/频点）
+class ChannelPlan {
+public:
+    static ChannelPlanRef create(const std::vector<uint32_t>& frequencies);
+    // [startHz, endHz] 内每 stepHz 一个频点
+    static ChannelPlanRef uniform(uint32_t startHz, uint32_t endHz, uint32_t stepHz);
+    // 共享的空计划，未配置时使用，避免到处判空
+    static ChannelPlanRef none();
+    
+    uint16_t size() const { return freqs.size(); }
+    bool empty() const { return freqs.empty(); }
+    uint32_t frequencyAt(uint16_t index) const { return index < freqs.size() ? freqs[index] : 0; }
+    uint16_t indexOf(uint32_t frequency) const;
+    uint32_t first() const { return freqs.empty() ? 0 : freqs.front(); }
+    uint32_t last() const { return freqs.empty() ? 0 : freqs.back(); }
+    const std::vector<uint32_t>& frequencies() const { return freqs; }
+    
+    // 频点列表的指纹，用于识别持久化数据所属的计划
+    uint32_t getId() const { return id; }
+    bool sameAs(const ChannelPlan& other) const { return this == &other || freqs == other.freqs; }
+    
+private:
+    explicit ChannelPlan(const std::vector<uint32_t>& frequencies);
+    
+    std::vector<uint32_t> freqs;
+    uint32_t id;
+    bool grid;                  // 等间隔计划
+    uint32_t gridStep;
+    std::vector<uint16_t> slots;    // 非等间隔计划的散列表，存频点索引
+    uint32_t slotMask;
+    
+    static uint32_t hashOf(uint32_t frequency);
+};
+
+#endif // CHANNEL_PLAN_H
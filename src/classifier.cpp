@@ -0,0 +1,201 @@
+#include "classifier.h"
+#include "fingerprint.h"
+
+static uint32_t readLE32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// LoRa APRS: "<\xFF\x01" 前缀 + "CALL>DEST:..."
+static bool matchLoRaAprs(const uint8_t* data, uint8_t length, ClassifyResult* result) {
+    if (data[0] != '<' || data[1] != 0xFF || data[2] != 0x01) {
+        return false;
+    }
+    
+    uint8_t end = 3;
+    while (end < length && end < 3 + 10 && data[end] != '>') {
+        end++;
+    }
+    if (end >= length || data[end] != '>' || end == 3) {
+        return false;
+    }
+    
+    result->hasSource = true;
+    result->sourceId = fingerprintPayload(data + 3, end - 3);
+    return true;
+}
+
+// LoRaWAN 入网请求：MHDR(MType=0) + JoinEUI(8) + DevEUI(8) + DevNonce(2) + MIC(4)
+static bool matchLoRaWanJoin(const uint8_t* data, uint8_t length, ClassifyResult* result) {
+    if (length != 23 || data[0] != 0x00) {
+        return false;
+    }
+    
+    // DevEUI 的低 32 位作为发送方
+    result->hasSource = true;
+    result->sourceId = readLE32(data + 9);
+    return true;
+}
+
+// Meshtastic 包头：dest(4) sender(4) id(4) flags(1) channel(1) next_hop(1) relay(1)
+static bool matchMeshtastic(const uint8_t* data, uint8_t length, ClassifyResult* result) {
+    uint32_t dest = readLE32(data);
+    uint32_t sender = readLE32(data + 4);
+    uint32_t packetId = readLE32(data + 8);
+    uint8_t flags = data[12];
+    uint8_t hopLimit = flags & 0x07;
+    uint8_t hopStart = flags >> 5;
+    
+    if (sender == 0 || sender == MESHTASTIC_BROADCAST || sender == dest || packetId == 0) {
+        return false;
+    }
+    // 新固件 hop_start 非零且不小于 hop_limit；旧固件 hop_start 为 0
+    if (hopStart != 0 && hopLimit > hopStart) {
+        return false;
+    }
+    result->hasSource = true;
+    result->sourceId = sender;
+    return true;
+}
+
+// LoRaWAN 数据帧：MHDR(MType 2..5, Major=0) + DevAddr(4) + FCtrl + FCnt(2) + [FOpts] + ... + MIC(4)
+static bool matchLoRaWanData(const uint8_t* data, uint8_t length, ClassifyResult* result) {
+    uint8_t mhdr = data[0];
+    uint8_t mtype = mhdr >> 5;
+    
+    if ((mhdr & 0x1F) != 0 || mtype < 2 || mtype > 5) {
+        return false;
+    }
+    
+    uint8_t fOptsLen = data[5] & 0x0F;
+    if (length < 12 + fOptsLen) {
+        return false;
+    }
+    
+    result->hasSource = true;
+    result->sourceId = readLE32(data + 1);
+    return true;
+}
+
+// 按特征强弱排序：前缀/定长特征在前，启发式在后。
+// LoRaWAN 数据帧校验 MHDR 的固定位与 FCtrl 长度，须排在只看长度和包头取值的 Meshtastic 之前，
+// 否则 16 字节以上的上行数据都会被认成 Meshtastic；Meshtastic 广播帧以 0xFF 开头，不会被误认为 LoRaWAN
+static const ProtocolClassifier CLASSIFIERS[] = {
+    { PROTO_LORA_APRS,  "LoRa APRS",      5,  matchLoRaAprs },
+    { PROTO_LORAWAN,    "LoRaWAN Join",   23, matchLoRaWanJoin },
+    { PROTO_LORAWAN,    "LoRaWAN Data",   12, matchLoRaWanData },
+    { PROTO_MESHTASTIC, "Meshtastic",     16, matchMeshtastic },
+};
+
+static const size_t NUM_CLASSIFIERS = sizeof(CLASSIFIERS) / sizeof(CLASSIFIERS[0]);
+
+ClassifyResult classifyPayload(const uint8_t* data, uint8_t length) {
+    ClassifyResult result;
+    if (!data || length == 0) {
+        return result;
+    }
+    
+    for (size_t i = 0; i < NUM_CLASSIFIERS; i++) {
+        const ProtocolClassifier& c = CLASSIFIERS[i];
+        if (length < c.minLength) continue;
+        
+        ClassifyResult candidate;
+        if (c.match(data, length, &candidate)) {
+            candidate.protocol = c.protocol;
+            return candidate;
+        }
+    }
+    
+    return result;
+}
+
+const char* protocolShortName(uint8_t protocol) {
+    switch (protocol) {
+        case PROTO_PENDING:
+            return "...";
+        case PROTO_LORAWAN:
+            return "WAN";
+        case PROTO_MESHTASTIC:
+            return "MSH";
+        case PROTO_LORA_APRS:
+            return "APRS";
+        default:
+            return "?";
+    }
+}
+
+ClassificationStage::ClassificationStage()
+    : queue(nullptr), taskHandle(nullptr), payloadPool(nullptr),
+      callback(nullptr), callbackContext(nullptr),
+      classifiedCount(0), droppedCount(0), staleCount(0) {
+}
+
+ClassificationStage::~ClassificationStage() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+    }
+    if (queue) {
+        vQueueDelete(queue);
+    }
+}
+
+bool ClassificationStage::begin(const PayloadPool* pool, ClassifyCallback cb, void* context) {
+    payloadPool = pool;
+    callback = cb;
+    callbackContext = context;
+    
+    if (taskHandle) return true;
+    
+    queue = xQueueCreate(QUEUE_LENGTH, sizeof(ClassifyJob));
+    if (!queue) {
+        USBSerial.println("[Classifier] Failed to create queue");
+        return false;
+    }
+    
+    // 优先级低于监听任务，解析永远不会抢占无线电处理
+    if (xTaskCreate(workerTask, "ClassifyTask", 3072, this, 0, &taskHandle) != pdPASS) {
+        USBSerial.println("[Classifier] Failed to create worker task");
+        taskHandle = nullptr;
+        return false;
+    }
+    
+    return true;
+}
+
+bool ClassificationStage::submit(const ClassifyJob& job) {
+    if (!queue || xQueueSend(queue, &job, 0) != pdTRUE) {
+        droppedCount++;
+        return false;
+    }
+    return true;
+}
+
+void ClassificationStage::workerTask(void* pvParameters) {
+    ClassificationStage* stage = static_cast<ClassificationStage*>(pvParameters);
+    ClassifyJob job;
+    
+    while (true) {
+        if (xQueueReceive(stage->queue, &job, portMAX_DELAY) == pdTRUE) {
+            stage->processJob(job);
+        }
+    }
+}
+
+void ClassificationStage::processJob(const ClassifyJob& job) {
+    ClassifyResult result;
+    
+    // 直接解析池内存，解析完成后复核句柄，期间被覆盖则结果作废
+    PayloadView payload = payloadPool ? payloadPool->get(job.payload) : PayloadView();
+    if (!payload.empty()) {
+        result = classifyPayload(payload.data, payload.length);
+        
+        if (!payloadPool->isValid(job.payload)) {
+            staleCount++;
+            return;
+        }
+    }
+    
+    classifiedCount++;
+    if (callback) {
+        callback(callbackContext, job, result);
+    }
+}
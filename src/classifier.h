@@ -0,0 +1,72 @@
+#ifndef CLASSIFIER_H
+#define CLASSIFIER_H
+
+#include "common.h"
+#include "payload_pool.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+// 分类结果
+struct ClassifyResult {
+    ProtocolId protocol;
+    bool hasSource;
+    uint32_t sourceId;       // 协议内的发送方地址（DevAddr / 节点号 / 呼号哈希）
+    
+    ClassifyResult() : protocol(PROTO_UNKNOWN), hasSource(false), sourceId(0) {}
+};
+
+// 协议识别表项：按表顺序匹配，第一个命中的即为结果
+// 新增协议只需实现一个 match 函数并加入表中
+struct ProtocolClassifier {
+    ProtocolId protocol;
+    const char* name;
+    uint8_t minLength;
+    bool (*match)(const uint8_t* data, uint8_t length, ClassifyResult* result);
+};
+
+ClassifyResult classifyPayload(const uint8_t* data, uint8_t length);
+const char* protocolShortName(uint8_t protocol);
+
+// 待分类的接收事件
+struct ClassifyJob {
+    uint32_t sequence;       // 雷达点序号
+    PayloadHandle payload;
+    uint16_t channelIndex;
+    bool duplicate;
+};
+
+typedef void (*ClassifyCallback)(void* context, const ClassifyJob& job, const ClassifyResult& result);
+
+// 异步分类阶段：监听任务只做非阻塞入队，解析在独立的工作任务中完成
+class ClassificationStage {
+public:
+    static const uint8_t QUEUE_LENGTH = 32;
+    
+    ClassificationStage();
+    ~ClassificationStage();
+    
+    bool begin(const PayloadPool* pool, ClassifyCallback callback, void* context);
+    // 非阻塞提交，队列满时丢弃并计数
+    bool submit(const ClassifyJob& job);
+    
+    uint32_t getClassifiedCount() const { return classifiedCount; }
+    uint32_t getDroppedCount() const { return droppedCount; }
+    uint32_t getStaleCount() const { return staleCount; }
+    
+private:
+    QueueHandle_t queue;
+    TaskHandle_t taskHandle;
+    const PayloadPool* payloadPool;
+    ClassifyCallback callback;
+    void* callbackContext;
+    
+    volatile uint32_t classifiedCount;
+    volatile uint32_t droppedCount;
+    volatile uint32_t staleCount;
+    
+    static void workerTask(void* pvParameters);
+    void processJob(const ClassifyJob& job);
+};
+
+#endif // CLASSIFIER_H
@@ -2,7 +2,18 @@
 #define COMMON_H
 
 #include <Arduino.h>
+#include <esp_timer.h>
 #include <vector>
+#include "channel_plan.h"
+
+// 时间单位换算
+const uint64_t US_PER_MS = 1000ULL;
+const uint64_t US_PER_SEC = 1000000ULL;
+
+// 单调 64 位微秒时基（esp_timer，自启动起计，不会回绕）
+inline uint64_t nowMicros() {
+    return (uint64_t)esp_timer_get_time();
+}
 
 // LoRa 模块类型枚举
 enum LoRaModuleType {
@@ -39,31 +50,38 @@ struct FrequencyConfig {
 // 扫描样本
 struct ScanSample {
     uint32_t frequency;
+    uint16_t channelIndex;   // 频点计划中的索引，统计按索引归类
     int16_t rssi;            // 信号强度 (dBm)
     int16_t snr;             // 信噪比 (dB)
     bool packetReceived;     // 是否接收到有效数据包
-    uint32_t timestamp;
+    uint64_t timestamp;      // 时间戳 (µs)
     uint8_t errorCount;      // CRC错误计数
     
     ScanSample() 
-        : frequency(0), rssi(-120), snr(-20), packetReceived(false), 
+        : frequency(0), channelIndex(CHANNEL_NONE), rssi(-120), snr(-20), packetReceived(false), 
           timestamp(0), errorCount(0) {}
 };
 
 // 频点统计信息
 struct FrequencyStats {
     uint32_t frequency;
+    uint16_t channelIndex;    // 频点计划中的索引
     uint16_t sampleCount;     // 采样次数
     int16_t avgRssi;         // 平均 RSSI
     int16_t maxRssi;         // 最大 RSSI
     int16_t minRssi;         // 最小 RSSI
+    int16_t p10Rssi;         // RSSI 分位数（全程，分位数草图）
+    int16_t p50Rssi;
+    int16_t p90Rssi;
+    int16_t p99Rssi;
     uint16_t packetCount;    // 接收到的有效包数
     float activityScore;     // 活动评分 (0.0-1.0)
-    uint32_t lastSeen;       // 最后检测到活动的时间
+    uint64_t lastSeen;       // 最后检测到活动的时间 (µs)
     
     FrequencyStats() 
-        : frequency(0), sampleCount(0), avgRssi(-120), maxRssi(-120), 
-          minRssi(-120), packetCount(0), activityScore(0.0), lastSeen(0) {}
+        : frequency(0), channelIndex(CHANNEL_NONE), sampleCount(0), avgRssi(-120), maxRssi(-120), 
+          minRssi(-120), p10Rssi(-120), p50Rssi(-120), p90Rssi(-120), p99Rssi(-120),
+          packetCount(0), activityScore(0.0), lastSeen(0) {}
 };
 
 // 扫描配置
@@ -86,60 +104,147 @@ enum DisplayMode {
     MODE_STATISTICS,    // 统计视图
     MODE_FREQCOMPARE,   // 频点对比视图
     MODE_REALTIME,      // 实时监测视图
-    MODE_RADAR          // 雷达视图
+    MODE_RADAR,         // 雷达视图
+    MODE_HEATMAP        // 占用热力图（频点 × 小时）
 };
 
 // 事件类型
-enum EventType {
+enum EventType : uint8_t {
     EVENT_RX_DONE,        // 成功接收
     EVENT_RX_CRC_ERROR,   // CRC 错误
     EVENT_RX_TIMEOUT      // 超时（不记录为雷达点）
 };
 
+// 协议类型（由异步分类阶段填写）
+enum ProtocolId : uint8_t {
+    PROTO_PENDING,        // 尚未分类
+    PROTO_UNKNOWN,        // 未识别
+    PROTO_LORAWAN,        // LoRaWAN
+    PROTO_MESHTASTIC,     // Meshtastic
+    PROTO_LORA_APRS,      // LoRa APRS
+    PROTO_COUNT
+};
+
 // 雷达点（时频接收事件）
+// 字段按宽度从大到小排列，中间不留填充：4 字节 × 6 + 2 字节 × 3 + 1 字节 × 6 = 36 字节
 struct RadarPoint {
-    uint32_t timestamp;      // 时间戳 (ms)
+    uint32_t timestampLo;    // 时间戳低 32 位 (µs)
     uint32_t frequency;      // 频率 (Hz)
+    uint32_t payload;        // 负载句柄 (PayloadPool)，0 表示无负载
+    uint32_t fingerprint;    // 负载指纹
+    uint32_t sequence;       // 事件序号，单调递增
+    uint32_t epoch;          // 最近一次写入/修改该点时的数据纪元
+    uint16_t timestampHi;    // 时间戳高 16 位，合计 48 位 µs，约 8.9 年不回绕
+    uint16_t channelIndex;   // 频点索引
     int16_t rssi;            // 信号强度 (dBm)
-    int16_t snr;             // 信噪比 (dB)
+    int8_t snr;              // 信噪比 (dB)，LoRa 的范围在 ±32 以内
+    uint8_t dataRateIndex;   // 接收时使用的 (SF, BW) 组合在扫描表中的序号
     uint8_t packetLength;    // 数据包长度
     EventType eventType;     // 事件类型
+    bool duplicate;          // 是否为短窗口内的重复包
+    uint8_t protocol;        // 协议类型 (ProtocolId)
     
     RadarPoint() 
-        : timestamp(0), frequency(0), rssi(-120), snr(-20), 
-          packetLength(0), eventType(EVENT_RX_TIMEOUT) {}
+        : timestampLo(0), frequency(0), payload(0), fingerprint(0), sequence(0), epoch(0),
+          timestampHi(0), channelIndex(0), rssi(-120), snr(-20), dataRateIndex(0), packetLength(0),
+          eventType(EVENT_RX_TIMEOUT), duplicate(false), protocol(PROTO_PENDING) {}
+    uint64_t timestampUs() const {
+        return ((uint64_t)timestampHi << 32) | timestampLo;
+    }
+    
+    void setTimestampUs(uint64_t us) {
+        timestampLo = (uint32_t)us;
+        timestampHi = (uint16_t)(us >> 32);
+    }
 };
 
+// 环形缓冲区按点数预分配，尺寸变化直接影响内存预算
+static_assert(sizeof(RadarPoint) == 36, "RadarPoint layout must stay free of padding");
+
 // 事件统计信息
 struct EventStats {
     uint32_t totalEvents;      // 总事件数
     uint32_t rxDoneCount;      // RX_DONE 次数
     uint32_t rxErrorCount;     // RX_ERROR 次数
-    int16_t avgRssi;           // 平均 RSSI
+    float avgRssi;             // 平均 RSSI，由 rssiSum 计算，不累积截断误差
     int16_t maxRssi;           // 最大 RSSI
     int16_t minRssi;           // 最小 RSSI
-    uint32_t lastEventTime;    // 最后一次事件时间
-    uint32_t firstEventTime;   // 第一次事件时间
+    int64_t rssiSum;           // RX_DONE 的 RSSI 总和
+    int16_t rssiP10;           // RSSI 分位数（分位数草图）
+    int16_t rssiP50;
+    int16_t rssiP90;
+    int16_t rssiP99;
+    uint64_t lastEventTime;    // 最后一次事件时间 (µs)
+    uint64_t firstEventTime;   // 第一次事件时间 (µs)
+    uint32_t duplicateCount;   // 重复包数
+    uint32_t distinctSources;  // 不同发送方估计值 (HyperLogLog)
     
     EventStats() 
         : totalEvents(0), rxDoneCount(0), rxErrorCount(0), 
-          avgRssi(-120), maxRssi(-120), minRssi(-120), 
-          lastEventTime(0), firstEventTime(0) {}
+          avgRssi(-120), maxRssi(-120), minRssi(-120), rssiSum(0),
+          rssiP10(-120), rssiP50(-120), rssiP90(-120), rssiP99(-120),
+          lastEventTime(0), firstEventTime(0),
+          duplicateCount(0), distinctSources(0) {}
 };
 
 // 监听配置
+// 扫描用的 (SF, BW) 组合
+struct DataRate {
+    uint8_t spreadingFactor;
+    uint16_t bandwidth;         // kHz
+    
+    DataRate(uint8_t sf = 9, uint16_t bw = 125)
+        : spreadingFactor(sf), bandwidth(bw) {}
+};
+
+// 按 (频点, SF, BW) 单元统计
+struct SweepCellStats {
+    uint16_t windows;           // 监听窗口数
+    uint16_t rxDone;
+    uint16_t rxError;
+    int16_t maxRssi;
+    
+    SweepCellStats() : windows(0), rxDone(0), rxError(0), maxRssi(-120) {}
+};
+
+// 频点切换方式
+enum HopMode : uint8_t {
+    HOP_FIXED,          // 停留在当前频点，仅手动切换
+    HOP_ROUND_ROBIN,    // 每个 RX 窗口后切到下一个频点
+    HOP_PREDICTIVE,     // 轮询探索，在周期性发送预计到达前切回对应频点
+    HOP_MODE_COUNT
+};
+
+// 按窗口类型（0 = 探索，1 = 预测）统计的收包效率
+struct HopStats {
+    uint32_t windows[2];
+    uint32_t events[2];
+    uint64_t listenMs[2];
+    
+    HopStats() {
+        memset(windows, 0, sizeof(windows));
+        memset(events, 0, sizeof(events));
+        memset(listenMs, 0, sizeof(listenMs));
+    }
+};
+
 struct ListenerConfig {
-    std::vector<FrequencyConfig> frequencies;
+    ChannelPlanRef plan;                // 共享的频点计划，不可修改
     uint16_t currentFreqIndex;
     uint16_t rxWindowMs;
     uint16_t bandwidth;
     uint8_t spreadingFactor;
     uint8_t codingRate;
     uint16_t maxPoints;
+    uint8_t hopMode;
+    std::vector<int16_t> rssiBinEdges;  // 直方图区间边界，空则为 -120 ~ -50 dBm 均分 10 格
+    bool cumulativeHistogram;           // 额外维护不随 maxPoints 淘汰的累计直方图
+    std::vector<DataRate> dataRates;    // 轮换扫描的 (SF, BW) 组合，空则固定使用上面的参数
     
     ListenerConfig() 
-        : currentFreqIndex(0), rxWindowMs(1000), bandwidth(125), 
-          spreadingFactor(7), codingRate(5), maxPoints(100) {}
+        : plan(ChannelPlan::none()), currentFreqIndex(0), rxWindowMs(1000), bandwidth(125), 
+          spreadingFactor(7), codingRate(5), maxPoints(100), hopMode(HOP_FIXED),
+          cumulativeHistogram(false) {}
 };
 
 // 颜色定义
@@ -4,6 +4,31 @@
 #include <vector>
 #include "common.h"
 
+// E220 模块引脚（-1 表示未连接，可在 build_flags 中覆盖）
+#ifndef LORA_E220_RX_PIN
+#define LORA_E220_RX_PIN 1
+#endif
+#ifndef LORA_E220_TX_PIN
+#define LORA_E220_TX_PIN 2
+#endif
+#ifndef LORA_E220_AUX_PIN
+#define LORA_E220_AUX_PIN -1
+#endif
+#ifndef LORA_E220_M0_PIN
+#define LORA_E220_M0_PIN -1
+#endif
+#ifndef LORA_E220_M1_PIN
+#define LORA_E220_M1_PIN -1
+#endif
+// E220 工作模式下的串口波特率 (1200-115200)，提高后每帧的串口传输延迟随之降低
+// 配置模式固定为 9600，切换时主机串口随之调整，因此需要 M0/M1 接到主机
+#ifndef LORA_E220_UART_BAUD
+#define LORA_E220_UART_BAUD 9600
+#endif
+#if LORA_E220_UART_BAUD != 9600 && (LORA_E220_M0_PIN < 0 || LORA_E220_M1_PIN < 0)
+#error "LORA_E220_UART_BAUD other than 9600 requires LORA_E220_M0_PIN and LORA_E220_M1_PIN"
+#endif
+
 struct LoRaScopeConfig {
     uint32_t startFreqHz;
     uint32_t endFreqHz;
@@ -13,6 +38,10 @@ struct LoRaScopeConfig {
     uint8_t spreadingFactor;
     uint8_t codingRate;
     uint16_t maxPoints;
+    uint8_t hopMode;
+    std::vector<int16_t> rssiBinEdges;
+    bool cumulativeHistogram;
+    std::vector<DataRate> dataRates;
     
     LoRaScopeConfig()
         : startFreqHz(410125000)
@@ -22,18 +51,12 @@ struct LoRaScopeConfig {
         , bandwidth(125)
         , spreadingFactor(7)
         , codingRate(5)
-        , maxPoints(100) {}
+        , maxPoints(100)
+        , hopMode(HOP_FIXED)
+        , cumulativeHistogram(false) {}
     
-    std::vector<FrequencyConfig> getFrequencies() const {
-        std::vector<FrequencyConfig> freqs;
-        
-        uint32_t freq = startFreqHz;
-        while (freq <= endFreqHz) {
-            freqs.push_back(FrequencyConfig(freq, rxWindowMs, bandwidth, spreadingFactor, codingRate));
-            freq += freqStepHz;
-        }
-        
-        return freqs;
+    ChannelPlanRef getChannelPlan() const {
+        return ChannelPlan::uniform(startFreqHz, endFreqHz, freqStepHz);
     }
 };
 
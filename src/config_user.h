@@ -14,6 +14,12 @@ LoRaScopeConfig getUserConfig() {
     config.spreadingFactor = 9;
     config.codingRate = 5;
     config.maxPoints = 100;
+    config.hopMode = HOP_FIXED;
+    // 直方图区间边界 (dBm)，留空使用默认均分，例如：
+    // config.rssiBinEdges = {-120, -110, -100, -95, -90, -85, -80, -70, -50};
+    config.cumulativeHistogram = false;
+    // 每个频点依次轮换的 (SF, BW kHz) 组合，留空则固定使用上面的参数，例如：
+    // config.dataRates = {DataRate(9, 125), DataRate(8, 125), DataRate(7, 125)};
     
     return config;
 }
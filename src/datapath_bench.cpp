@@ -0,0 +1,237 @@
+#include "datapath_bench.h"
+
+#ifdef LORASCOPE_BENCH
+
+#include "config.h"
+#include "point_ring.h"
+#include "statistics.h"
+#include "event_codec.h"
+#include <esp_timer.h>
+
+// 合成事件流规模
+const uint32_t BENCH_EVENT_COUNT = 100000;
+const uint32_t BENCH_SAMPLE_COUNT = 20000;
+const uint32_t BENCH_CHANNEL_COUNT = 831;
+const uint16_t BENCH_RING_CAPACITY = 100;
+const uint16_t BENCH_REPEAT_COUNT = 20;
+// 预先生成的输入条数：计时循环按序号循环取用，不在计时区内生成随机数
+const uint16_t BENCH_INPUT_COUNT = 512;
+
+// xorshift32：可复现的伪随机序列，保证每次运行输入一致
+static uint32_t benchRng = 0x12345678;
+
+static uint32_t nextRandom() {
+    benchRng ^= benchRng << 13;
+    benchRng ^= benchRng >> 17;
+    benchRng ^= benchRng << 5;
+    return benchRng;
+}
+
+void benchSeed(uint32_t seed) {
+    benchRng = seed;
+}
+
+void benchMakeEvent(RadarPoint* point, uint32_t seq, uint64_t timestampUs) {
+    uint32_t r = nextRandom();
+    uint16_t ch = r % BENCH_CHANNEL_COUNT;
+    point->setTimestampUs(timestampUs);
+    point->channelIndex = ch;
+    point->frequency = 410125000 + ch * 100000;
+    point->rssi = -120 + (int16_t)((r >> 12) % 90);
+    point->snr = -20 + (int16_t)((r >> 20) % 30);
+    point->packetLength = (r >> 8) & 0xFF;
+    point->eventType = (r & 0x7) == 0 ? EVENT_RX_CRC_ERROR : EVENT_RX_DONE;
+    point->fingerprint = nextRandom();
+    point->sequence = seq;
+}
+
+// 与 benchMakeEvent 相同的 100 kHz 间隔计划
+static ChannelPlanRef benchPlan() {
+    return ChannelPlan::uniform(410125000, 410125000 + (BENCH_CHANNEL_COUNT - 1) * 100000, 100000);
+}
+
+static void makeSample(ScanSample* sample) {
+    uint32_t r = nextRandom();
+    sample->channelIndex = r % BENCH_CHANNEL_COUNT;
+    sample->frequency = 410125000 + sample->channelIndex * 100000;
+    sample->rssi = -120 + (int16_t)((r >> 12) % 90);
+    sample->snr = -20 + (int16_t)((r >> 20) % 30);
+    sample->packetReceived = (r & 0x7) != 0;
+    sample->errorCount = sample->packetReceived ? 0 : 1;
+}
+
+static RadarPoint eventInputs[BENCH_INPUT_COUNT];
+static ScanSample sampleInputs[BENCH_INPUT_COUNT];
+
+static void makeInputs() {
+    for (uint16_t i = 0; i < BENCH_INPUT_COUNT; i++) {
+        benchMakeEvent(&eventInputs[i], i + 1, (uint64_t)i * 1000);
+        makeSample(&sampleInputs[i]);
+    }
+}
+
+// 填充统计：时间戳分布在过去 2*ageMs 内，约一半样本会被 cleanup 清除；
+// 计时区内只改写样本的时间戳
+static void fillCollector(StatisticsCollector& collector, uint32_t count, uint32_t ageMs) {
+    uint64_t now = nowMicros();
+    uint64_t spanUs = (uint64_t)ageMs * 2 * US_PER_MS;
+    for (uint32_t i = 0; i < count; i++) {
+        ScanSample& sample = sampleInputs[i % BENCH_INPUT_COUNT];
+        sample.timestamp = now - spanUs + spanUs * i / count;
+        collector.addSample(sample);
+    }
+}
+
+static BenchResult benchRingPushEvict(Print& out, bool* ok) {
+    PointRing ring;
+    ring.setCapacity(BENCH_RING_CAPACITY);
+    RadarPoint evicted;
+    uint32_t evictions = 0;
+    
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < BENCH_EVENT_COUNT; i++) {
+        if (ring.push(eventInputs[i % BENCH_INPUT_COUNT], &evicted)) evictions++;
+    }
+    int64_t end = esp_timer_get_time();
+    
+    if (evictions != BENCH_EVENT_COUNT - BENCH_RING_CAPACITY) {
+        out.printf("[Bench] ring eviction count mismatch: %lu\n", (unsigned long)evictions);
+        *ok = false;
+    }
+    
+    BenchResult r = { "ring_push_evict", BENCH_EVENT_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+static BenchResult benchStatsAddSample() {
+    StatisticsCollector collector(benchPlan());
+    
+    int64_t start = esp_timer_get_time();
+    fillCollector(collector, BENCH_SAMPLE_COUNT, 60000);
+    int64_t end = esp_timer_get_time();
+    
+    BenchResult r = { "stats_add_sample", BENCH_SAMPLE_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+static BenchResult benchStatsUpdate() {
+    StatisticsCollector collector(benchPlan());
+    fillCollector(collector, BENCH_SAMPLE_COUNT, 60000);
+    
+    int64_t start = esp_timer_get_time();
+    for (uint16_t i = 0; i < BENCH_REPEAT_COUNT; i++) {
+        collector.updateStatistics();
+    }
+    int64_t end = esp_timer_get_time();
+    
+    BenchResult r = { "stats_update", BENCH_REPEAT_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+static BenchResult benchStatsGetAll(Print& out, bool* ok) {
+    StatisticsCollector collector(benchPlan());
+    fillCollector(collector, BENCH_SAMPLE_COUNT, 60000);
+    size_t total = 0;
+    
+    int64_t start = esp_timer_get_time();
+    for (uint16_t i = 0; i < BENCH_REPEAT_COUNT; i++) {
+        total += collector.getAllStats().size();
+    }
+    int64_t end = esp_timer_get_time();
+    
+    if (total == 0) {
+        out.println("[Bench] getAllStats returned no channels");
+        *ok = false;
+    }
+    
+    BenchResult r = { "stats_get_all", BENCH_REPEAT_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+static BenchResult benchStatsCleanup() {
+    uint64_t elapsed = 0;
+    
+    // cleanup 会修改状态，每轮重新填充，只统计 cleanup 本身的耗时
+    for (uint16_t i = 0; i < BENCH_REPEAT_COUNT; i++) {
+        StatisticsCollector collector(benchPlan());
+        fillCollector(collector, BENCH_SAMPLE_COUNT / BENCH_REPEAT_COUNT, 60000);
+    
+        int64_t start = esp_timer_get_time();
+        collector.cleanup(60000);
+        elapsed += esp_timer_get_time() - start;
+    }
+    
+    BenchResult r = { "stats_cleanup", BENCH_REPEAT_COUNT, elapsed };
+    return r;
+}
+
+static BenchResult benchChannelPlan(Print& out, bool* ok) {
+    LoRaScopeConfig config;
+    size_t total = 0;
+    
+    int64_t start = esp_timer_get_time();
+    for (uint16_t i = 0; i < BENCH_REPEAT_COUNT; i++) {
+        total += config.getChannelPlan()->size();
+    }
+    int64_t end = esp_timer_get_time();
+    
+    if (total == 0) {
+        out.println("[Bench] channel plan is empty");
+        *ok = false;
+    }
+    
+    BenchResult r = { "channel_plan", BENCH_REPEAT_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+static BenchResult benchEventEncode(uint8_t* records) {
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < BENCH_EVENT_COUNT; i++) {
+        encodeEvent(eventInputs[i % BENCH_INPUT_COUNT], records + (i % BENCH_RING_CAPACITY) * EVENT_RECORD_SIZE);
+    }
+    int64_t end = esp_timer_get_time();
+    
+    BenchResult r = { "event_encode", BENCH_EVENT_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+static BenchResult benchEventDecode(const uint8_t* records, Print& out, bool* ok) {
+    RadarPoint point;
+    uint32_t checksum = 0;
+    
+    int64_t start = esp_timer_get_time();
+    for (uint32_t i = 0; i < BENCH_EVENT_COUNT; i++) {
+        decodeEvent(records + (i % BENCH_RING_CAPACITY) * EVENT_RECORD_SIZE, EVENT_RECORD_SIZE, &point);
+        checksum += point.sequence;
+    }
+    int64_t end = esp_timer_get_time();
+    
+    if (checksum == 0) {
+        out.println("[Bench] decoded events are empty");
+        *ok = false;
+    }
+    
+    BenchResult r = { "event_decode", BENCH_EVENT_COUNT, (uint64_t)(end - start) };
+    return r;
+}
+
+bool runDataPathBenchmarks(BenchResult results[DATAPATH_BENCH_COUNT], Print& out) {
+    benchSeed(0x12345678);
+    makeInputs();
+    
+    static uint8_t records[BENCH_RING_CAPACITY * EVENT_RECORD_SIZE];
+    bool ok = true;
+    
+    uint8_t count = 0;
+    results[count++] = benchRingPushEvict(out, &ok);
+    results[count++] = benchStatsAddSample();
+    results[count++] = benchStatsUpdate();
+    results[count++] = benchStatsGetAll(out, &ok);
+    results[count++] = benchStatsCleanup();
+    results[count++] = benchChannelPlan(out, &ok);
+    results[count++] = benchEventEncode(records);
+    results[count++] = benchEventDecode(records, out, &ok);
+    return ok;
+}
+
+#endif // LORASCOPE_BENCH
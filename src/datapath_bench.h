@@ -0,0 +1,28 @@
+#ifndef DATAPATH_BENCH_H
+#define DATAPATH_BENCH_H
+
+#include "common.h"
+
+// 数据通路基准（仅在定义 LORASCOPE_BENCH 时编译）：雷达点写入/淘汰、统计汇总、
+// 频点表生成和事件编解码。只依赖 String/Print 与 esp_timer，
+// 设备上由 bench.cpp 调用，主机上由 tools/host 的 host_bench 调用并与基线文件比较
+
+const uint8_t DATAPATH_BENCH_COUNT = 8;
+
+struct BenchResult {
+    const char* name;
+    uint32_t ops;
+    uint64_t elapsedUs;
+    
+    uint32_t nsPerOp() const { return (uint32_t)(elapsedUs * 1000 / ops); }
+};
+
+// 按固定顺序运行全部数据通路基准，输入在计时前由固定种子生成，每次运行一致；
+// 结果自检失败时在 out 上报告并返回 false
+bool runDataPathBenchmarks(BenchResult results[DATAPATH_BENCH_COUNT], Print& out);
+
+// 可复现的合成事件（100 kHz 间隔的频点），供渲染基准生成数据集
+void benchSeed(uint32_t seed);
+void benchMakeEvent(RadarPoint* point, uint32_t seq, uint64_t timestampUs);
+
+#endif // DATAPATH_BENCH_H
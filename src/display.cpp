@@ -1,11 +1,30 @@
 #include "display.h"
+#include "classifier.h"
+#include "fingerprint.h"
+#include "metrics.h"
 #include <M5Cardputer.h>
-#include <map>
+#include <algorithm>
+
+// 时间线缩放档位（秒），默认 60 s
+static const uint32_t TIMELINE_ZOOM_SEC[] = {10, 30, 60, 300, 900, 3600, 3 * 3600, 6 * 3600, 12 * 3600, 24 * 3600};
+static const uint8_t TIMELINE_ZOOM_COUNT = sizeof(TIMELINE_ZOOM_SEC) / sizeof(TIMELINE_ZOOM_SEC[0]);
+static const uint8_t TIMELINE_ZOOM_DEFAULT = 2;
+// 事件列表的最低 RSSI 档位，0 号为不过滤
+static const int16_t EVENT_RSSI_FILTERS[] = {INT16_MIN, -110, -100, -90, -80, -70};
+static const uint8_t EVENT_RSSI_FILTER_COUNT = sizeof(EVENT_RSSI_FILTERS) / sizeof(EVENT_RSSI_FILTERS[0]);
 
 ScopeDisplay::ScopeDisplay()
-    : canvas(nullptr), canvasSystemBar(nullptr), currentMode(MODE_RADAR),
+    : canvas(nullptr), canvasSystemBar(nullptr), canvasChrome(nullptr), chromeKey(CHROME_NONE),
+      systemBarValid(false), currentMode(MODE_RADAR),
       batteryPct(100), currentRssi(-120), isScanning(false),
-      moduleName("LoRa"), currentFreq(0), currentFreqIndex(0), totalFreqCount(0) {
+      moduleName("LoRa"), currentFreq(0), currentFreqIndex(0), totalFreqCount(0), channelPlan(ChannelPlan::none()),
+      radarPhosphorStale(false), realtimeScrolledUs(0),
+      payloadPool(nullptr), rssiHistogram(nullptr), occupancy(nullptr), rssiPyramid(nullptr),
+      eventIndex(nullptr), timelineZoom(TIMELINE_ZOOM_DEFAULT), timelinePanUs(0),
+      followChannel(false), eventRssiFilter(0),
+      headless(false), clockOverrideUs(0) {
+    channelSources.reserve(DISPLAY_CHANNEL_INFO_MAX);
+    channelProtocols.reserve(DISPLAY_CHANNEL_INFO_MAX);
 }
 
 ScopeDisplay::~ScopeDisplay() {
@@ -15,6 +34,9 @@ ScopeDisplay::~ScopeDisplay() {
     if (canvasSystemBar) {
         delete canvasSystemBar;
     }
+    if (canvasChrome) {
+        delete canvasChrome;
+    }
 }
 
 bool ScopeDisplay::init() {
@@ -29,10 +51,44 @@ bool ScopeDisplay::init() {
         return false;
     }
     
+    allocateChrome();
+    return true;
+}
+
+bool ScopeDisplay::initHeadless() {
+    // 无父设备的精灵只在内存中绘制 (RGB565)，不访问屏幕
+    canvas = new M5Canvas();
+    canvasSystemBar = new M5Canvas();
+    canvas->setColorDepth(16);
+    canvasSystemBar->setColorDepth(16);
+    
+    if (!canvas->createSprite(ww, wh) || !canvasSystemBar->createSprite(sw, sh)) {
+        return false;
+    }
+    
+    allocateChrome();
+    headless = true;
     return true;
 }
 
-void ScopeDisplay::update(const std::vector<RadarPoint>& points, const EventStats& stats) {
+void ScopeDisplay::allocateChrome() {
+    // 静态部分缓存是可选的：与主画布同尺寸同色深，内存不足时每帧直接绘制
+    canvasChrome = new M5Canvas(canvas);
+    canvasChrome->setColorDepth(16);
+    if (!canvasChrome->createSprite(ww, wh) || canvasChrome->bufferLength() != canvas->bufferLength()) {
+        USBSerial.println("[Display] Chrome cache unavailable, drawing static layers per frame");
+        delete canvasChrome;
+        canvasChrome = nullptr;
+    }
+    chromeKey = CHROME_NONE;
+}
+
+void ScopeDisplay::invalidate() {
+    chromeKey = CHROME_NONE;
+    systemBarValid = false;
+}
+
+void ScopeDisplay::update(const PointRing& points, const EventStats& stats) {
     drawSystemBar();
     
     switch (currentMode) {
@@ -57,6 +113,9 @@ void ScopeDisplay::update(const std::vector<RadarPoint>& points, const EventStat
         case MODE_RADAR:
             drawRadar(points, stats);
             break;
+        case MODE_HEATMAP:
+            drawHeatmap(points, stats);
+            break;
     }
 }
 
@@ -88,16 +147,132 @@ void ScopeDisplay::setCurrentFreq(uint32_t freq) {
     currentFreq = freq;
 }
 
-void ScopeDisplay::setCurrentFreqIndex(uint8_t index, uint8_t total) {
+void ScopeDisplay::setCurrentFreqIndex(uint16_t index, uint16_t total) {
     currentFreqIndex = index;
     totalFreqCount = total;
 }
 
-void ScopeDisplay::setFrequencies(const std::vector<uint32_t>& freqs) {
-    freqList = freqs;
+void ScopeDisplay::setChannelPlan(ChannelPlanRef plan) {
+    channelPlan = plan ? plan : ChannelPlan::none();
+    channelSeen.assign(channelPlan->size(), 0);
+    // 余辉层在绘制时清空，这里可能在监听任务中调用
+    radarPhosphorStale = true;
+    size_t infoCount = std::min((size_t)channelPlan->size(), DISPLAY_CHANNEL_INFO_MAX);
+    channelSources.assign(infoCount, 0);
+    channelProtocols.assign(infoCount, 0);
+}
+
+void ScopeDisplay::setPayloadPool(const PayloadPool* pool) {
+    payloadPool = pool;
+}
+
+void ScopeDisplay::setRssiHistogram(const RssiHistogramSnapshot* histogram) {
+    rssiHistogram = histogram;
+}
+
+void ScopeDisplay::setOccupancy(const OccupancyHeatmap* heatmap) {
+    occupancy = heatmap;
+}
+
+void ScopeDisplay::setRssiPyramid(const RssiPyramid* pyramid) {
+    rssiPyramid = pyramid;
+}
+
+void ScopeDisplay::zoomTimeline(int8_t step) {
+    int16_t zoom = (int16_t)timelineZoom - step;
+    timelineZoom = constrain(zoom, 0, TIMELINE_ZOOM_COUNT - 1);
+    // 放大后平移量仍须落在金字塔保留的 24 小时内
+    panTimeline(0);
+}
+
+void ScopeDisplay::panTimeline(int8_t step) {
+    uint64_t window = (uint64_t)TIMELINE_ZOOM_SEC[timelineZoom] * US_PER_SEC;
+    uint64_t maxPan = PYRAMID_MAX_SPAN_US - window;
+    int64_t pan = (int64_t)timelinePanUs - (int64_t)step * (int64_t)(window / 2);
+    timelinePanUs = pan < 0 ? 0 : ((uint64_t)pan > maxPan ? maxPan : pan);
+}
+
+void ScopeDisplay::toggleFollowChannel() {
+    followChannel = !followChannel;
+}
+
+void ScopeDisplay::setEventIndex(const EventIndex* index) {
+    eventIndex = index;
+}
+
+void ScopeDisplay::stepEventRssiFilter(int8_t step) {
+    int16_t filter = (int16_t)eventRssiFilter + step;
+    eventRssiFilter = constrain(filter, 0, EVENT_RSSI_FILTER_COUNT - 1);
+}
+
+void ScopeDisplay::setChannelSources(uint16_t index, uint32_t estimate) {
+    if (index < channelSources.size()) {
+        channelSources[index] = estimate > 0xFFFF ? 0xFFFF : estimate;
+    }
+}
+
+void ScopeDisplay::clearChannelSources() {
+    std::fill(channelSources.begin(), channelSources.end(), 0);
+    std::fill(channelProtocols.begin(), channelProtocols.end(), 0);
+}
+
+void ScopeDisplay::setChannelProtocols(uint16_t index, uint8_t mask) {
+    if (index < channelProtocols.size()) {
+        channelProtocols[index] = mask;
+    }
+}
+
+void ScopeDisplay::setClockOverride(uint64_t us) {
+    clockOverrideUs = us;
+}
+
+uint32_t ScopeDisplay::frameChecksum() const {
+    uint32_t hash = fingerprintPayload((const uint8_t*)canvasSystemBar->getBuffer(), canvasSystemBar->bufferLength());
+    // 两块精灵的指纹错位合并，区分内容在两者之间移动的情况
+    hash = (hash << 7) | (hash >> 25);
+    return hash ^ fingerprintPayload((const uint8_t*)canvas->getBuffer(), canvas->bufferLength());
+}
+
+void ScopeDisplay::dumpFrame(Print& out) const {
+    // 先状态栏后主视图，两者等宽，拼接即为 240x135 的完整画面
+    out.write((const uint8_t*)canvasSystemBar->getBuffer(), canvasSystemBar->bufferLength());
+    out.write((const uint8_t*)canvas->getBuffer(), canvas->bufferLength());
+}
+
+uint64_t ScopeDisplay::renderNow() const {
+    return clockOverrideUs ? clockOverrideUs : nowMicros();
+}
+
+void ScopeDisplay::presentCanvas() {
+    if (!headless) canvas->pushSprite(wx, wy);
+}
+
+void ScopeDisplay::presentSystemBar() {
+    if (!headless) canvasSystemBar->pushSprite(sx, sy);
+}
+
+uint8_t ScopeDisplay::rssiBars(int rssi) {
+    if (rssi > -70) return 4;
+    if (rssi > -80) return 3;
+    if (rssi > -90) return 2;
+    if (rssi > -100) return 1;
+    return 0;
 }
 
 void ScopeDisplay::drawSystemBar() {
+    // 状态栏只由这几项决定，未变化时保留上一帧的精灵和屏幕内容
+    SystemBarState state;
+    state.moduleName = moduleName;
+    state.frequency = currentFreq;
+    state.scanning = isScanning;
+    state.rssiBars = rssiBars(currentRssi);
+    state.batteryPct = batteryPct;
+    if (systemBarValid && state == shownSystemBar) {
+        return;
+    }
+    shownSystemBar = state;
+    systemBarValid = true;
+    
     canvasSystemBar->fillSprite(BG_COLOR);
     canvasSystemBar->fillRoundRect(sx + m, sy, sw - 2 * m, sh - m, 3, UX_COLOR_DARK);
     canvasSystemBar->fillRect(sx + m, sy, sw - 2 * m, 3, UX_COLOR_DARK);
@@ -121,94 +296,248 @@ void ScopeDisplay::drawSystemBar() {
     draw_rssi_indicator(canvasSystemBar, sw - 60, sy + sh / 2 - 5, currentRssi, true);
     draw_battery_indicator(canvasSystemBar, sw - 25, sy + sh / 2 - 5, batteryPct);
     
-    canvasSystemBar->pushSprite(sx, sy);
+    presentSystemBar();
 }
 
-void ScopeDisplay::drawTimeline(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
+void ScopeDisplay::beginFrame(uint8_t variant) {
+    uint16_t key = ((uint16_t)currentMode << 2) | variant;
+    
+    if (canvasChrome) {
+        if (key != chromeKey) {
+            canvasChrome->fillSprite(BG_COLOR);
+            drawChrome(canvasChrome, currentMode, variant);
+            chromeKey = key;
+        }
+        memcpy(canvas->getBuffer(), canvasChrome->getBuffer(), canvas->bufferLength());
+    } else {
+        canvas->fillSprite(BG_COLOR);
+        drawChrome(canvas, currentMode, variant);
+    }
     
+    // 数据层从统一的文字状态开始
     canvas->setTextColor(COLOR_SILVER);
+    canvas->setTextSize(1);
     canvas->setTextDatum(top_center);
-    canvas->drawString("Timeline", ww / 2, 2 * m);
+}
+
+void ScopeDisplay::drawTitle(M5Canvas* c, const char* title) {
+    c->setTextColor(COLOR_SILVER);
+    c->setTextSize(1);
+    c->setTextDatum(top_center);
+    c->drawString(title, ww / 2, 2 * m);
     
     for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
+        c->drawLine(10, 3 * m + c->fontHeight() + i, ww - 10, 3 * m + c->fontHeight() + i, UX_COLOR_LIGHT);
     }
+}
+
+void ScopeDisplay::drawChrome(M5Canvas* c, DisplayMode mode, uint8_t variant) {
+    // 各视图中与数据无关的部分，几何参数与对应的 draw* 函数一致
+    int top = 4 * m + c->fontHeight();
     
-    if (points.empty()) {
-        canvas->setTextDatum(middle_center);
-        canvas->drawString("No events", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
-        return;
+    switch (mode) {
+        case MODE_TIMELINE:
+        case MODE_REALTIME: {
+            drawTitle(c, mode == MODE_TIMELINE ? "Timeline" : "Realtime Monitor");
+            // 时间线无数据时只显示提示，实时监测始终显示坐标框
+            if (mode == MODE_TIMELINE && variant != CHROME_POPULATED) break;
+            
+            int graphX = 2 * m;
+            int graphW = ww - 4 * m;
+            int graphH = wh - top - 2 * m;
+            c->drawRect(graphX, top, graphW, graphH, UX_COLOR_LIGHT);
+            c->setTextDatum(top_left);
+            c->drawString("-50", graphX + graphW + 2, top);
+            c->drawString("-120", graphX + graphW + 2, top + graphH - c->fontHeight());
+            break;
+        }
+        case MODE_HISTOGRAM:
+            drawTitle(c, variant == CHROME_ALT ? "RSSI Histogram (all)" : "RSSI Histogram");
+            break;
+        case MODE_EVENTLIST:
+            drawTitle(c, "Event List");
+            break;
+        case MODE_STATISTICS: {
+            drawTitle(c, "Statistics");
+            if (variant != CHROME_POPULATED) break;
+            
+            static const char* const labels[] = {
+                "Total Events:", "RX Done:", "RX Error:", "Avg RSSI:", "Max / Min:",
+                "P10/50/90/99:", "Success Rate:", "Dup / Src:", "Drop U/B/R/E/F:"
+            };
+            int lineHeight = c->fontHeight() + 3;
+            c->setTextDatum(top_left);
+            c->setTextColor(UX_COLOR_ACCENT);
+            for (uint8_t i = 0; i < sizeof(labels) / sizeof(labels[0]); i++) {
+                c->drawString(labels[i], 2 * m, top + i * lineHeight);
+            }
+            break;
+        }
+        case MODE_FREQCOMPARE:
+            drawTitle(c, "Freq Compare");
+            break;
+        case MODE_RADAR: {
+            drawTitle(c, "Radar");
+            
+            int centerX = ww / 2;
+            int centerY = (wy + wh / 2) - 5;
+            int maxRadius = std::min(ww, wh) / 2 - 6 * m;
+            
+            c->drawCircle(centerX, centerY, maxRadius, UX_COLOR_LIGHT);
+            c->drawCircle(centerX, centerY, maxRadius * 0.75, UX_COLOR_LIGHT);
+            c->drawCircle(centerX, centerY, maxRadius * 0.5, UX_COLOR_LIGHT);
+            c->drawCircle(centerX, centerY, maxRadius * 0.25, UX_COLOR_LIGHT);
+            
+            c->drawLine(centerX, centerY - maxRadius, centerX, centerY + maxRadius, UX_COLOR_LIGHT);
+            c->drawLine(centerX - maxRadius, centerY, centerX + maxRadius, centerY, UX_COLOR_LIGHT);
+            break;
+        }
+        case MODE_HEATMAP:
+            drawTitle(c, variant == CHROME_ALT ? "Occupancy / hour" : "Occupancy / no clock");
+            break;
     }
-    
-    uint32_t now = millis();
-    uint32_t timeWindow = 60000;
-    int16_t minRssi = -120;
-    int16_t maxRssi = -50;
-    
+}
+
+static String formatDuration(uint64_t us) {
+    uint32_t sec = us / US_PER_SEC;
+    if (sec < 60) return String(sec) + "s";
+    if (sec < 3600) return String(sec / 60) + "m";
+    return String(sec / 3600) + "h";
+}
+
+void ScopeDisplay::drawTimeline(const PointRing& points, const EventStats& stats) {
     int graphX = 2 * m;
     int graphY = 4 * m + canvas->fontHeight();
     int graphW = ww - 4 * m;
     int graphH = wh - graphY - 2 * m;
     
-    canvas->drawRect(graphX, graphY, graphW, graphH, UX_COLOR_LIGHT);
+    uint64_t now = renderNow();
+    uint64_t timeWindow = (uint64_t)TIMELINE_ZOOM_SEC[timelineZoom] * US_PER_SEC;
+    uint64_t endUs = now > timelinePanUs ? now - timelinePanUs : 0;
+    uint64_t startUs = endUs > timeWindow ? endUs - timeWindow : 0;
+    uint16_t channel = followChannel ? currentFreqIndex : CHANNEL_NONE;
     
-    canvas->setTextDatum(top_left);
-    canvas->setTextSize(1);
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->drawString("-50", graphX + graphW + 2, graphY);
-    canvas->drawString("-120", graphX + graphW + 2, graphY + graphH - canvas->fontHeight());
+    // 坐标框内每列一个聚合桶，绘制开销只与屏幕宽度有关
+    uint16_t columns = graphW - 2;
+    if (timelineColumns.size() != columns) {
+        timelineColumns.resize(columns);
+    }
+    // 按频点的金字塔从 10 s 桶开始且槽位有限：缓冲区中的雷达点覆盖整个窗口、
+    // 或该频点没有槽位时，按点逐事件绘制（没有槽位时只能画出仍在缓冲区中的部分）
+    bool pointsCover = points.size() < points.capacity() ||
+                       (points.size() > 0 && points.front().timestampUs() <= startUs);
+    bool populated;
+    if (channel != CHANNEL_NONE && (pointsCover || !rssiPyramid || !rssiPyramid->hasChannel(channel))) {
+        populated = renderTimelinePoints(points, channel, startUs, endUs);
+    } else {
+        populated = rssiPyramid && rssiPyramid->render(channel, startUs, endUs, timelineColumns.data(), columns);
+    }
+    beginFrame(populated ? CHROME_POPULATED : CHROME_EMPTY);
     
-    for (const auto& point : points) {
-        uint32_t timeDiff = now - point.timestamp;
-        if (timeDiff > timeWindow) continue;
-        
-        float x = graphX + graphW * (1.0 - (float)timeDiff / timeWindow);
-        float y = graphY + graphH * (1.0 - (float)(point.rssi - minRssi) / (maxRssi - minRssi));
-        
-        uint16_t color = (point.eventType == EVENT_RX_DONE) ? TFT_GREEN : TFT_RED;
-        int radius = (point.packetLength > 0) ? 4 : 2;
+    // 时间范围、平移量与所选频点
+    String caption = formatDuration(timeWindow);
+    if (timelinePanUs > 0) {
+        caption += " @-" + formatDuration(timelinePanUs);
+    }
+    if (followChannel) {
+        caption += " " + String(channelPlan->frequencyAt(channel) / 1000000.0, 2);
+    }
+    
+    if (!populated) {
+        canvas->setTextDatum(middle_center);
+        canvas->drawString("No events", ww / 2, wh / 2);
+        canvas->setTextDatum(bottom_center);
+        canvas->drawString(caption, ww / 2, wh - 2 * m);
+        presentCanvas();
+        return;
+    }
+    
+    int16_t minRssi = -120;
+    int16_t maxRssi = -50;
+    int yLow = graphY + 1;
+    int yHigh = graphY + graphH - 2;
+    
+    for (uint16_t c = 0; c < columns; c++) {
+        const PyramidBucket& bucket = timelineColumns[c];
+        int x = graphX + 1 + c;
         
-        canvas->fillCircle(x, y, radius, color);
+        if (bucket.count > 0) {
+            // 列内 RSSI 范围画暗色竖线，均值处画亮点
+            int yTop = constrain(graphY + graphH * (maxRssi - bucket.maxRssi) / (maxRssi - minRssi), yLow, yHigh);
+            int yBottom = constrain(graphY + graphH * (maxRssi - bucket.minRssi) / (maxRssi - minRssi), yLow, yHigh);
+            int yMean = constrain(graphY + graphH * (maxRssi - bucket.mean()) / (maxRssi - minRssi), yLow, yHigh - 1);
+            canvas->drawFastVLine(x, yTop, yBottom - yTop + 1, TFT_DARKGREEN);
+            canvas->drawFastVLine(x, yMean, 2, TFT_GREEN);
+        }
+        if (bucket.errors > 0) {
+            canvas->drawFastVLine(x, yHigh - 3, 4, TFT_RED);
+        }
     }
     
-    canvas->pushSprite(wx, wy);
+    canvas->setTextDatum(bottom_center);
+    canvas->drawString(caption, ww / 2, wh - 2 * m);
+    
+    presentCanvas();
 }
 
-void ScopeDisplay::drawHistogram(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
-    
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->setTextDatum(top_center);
-    canvas->drawString("RSSI Histogram", ww / 2, 2 * m);
+bool ScopeDisplay::renderTimelinePoints(const PointRing& points, uint16_t channel, uint64_t startUs, uint64_t endUs) {
+    uint16_t columns = timelineColumns.size();
+    for (uint16_t c = 0; c < columns; c++) {
+        timelineColumns[c].clear();
+    }
+    if (endUs <= startUs || columns == 0) return false;
     
-    for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
+    uint64_t spanUs = endUs - startUs;
+    bool any = false;
+    auto addPoint = [&](const RadarPoint& point) {
+        PyramidBucket& bucket = timelineColumns[(point.timestampUs() - startUs) * columns / spanUs];
+        if (point.eventType == EVENT_RX_DONE) {
+            bucket.add(point.rssi);
+        } else {
+            bucket.addError();
+        }
+        any = true;
+    };
+    
+    if (eventIndex) {
+        EventQuery query;
+        query.firstChannel = channel;
+        query.lastChannel = channel;
+        query.startUs = startUs;
+        query.endUs = endUs;
+        for (const RadarPoint& point : eventIndex->query(query)) {
+            addPoint(point);
+        }
+    } else {
+        for (size_t i = 0; i < points.size(); i++) {
+            const RadarPoint& point = points[i];
+            if (point.channelIndex == channel && point.timestampUs() >= startUs && point.timestampUs() < endUs) {
+                addPoint(point);
+            }
+        }
     }
+    return any;
+}
+
+void ScopeDisplay::drawHistogram(const PointRing& points, const EventStats& stats) {
+    bool cumulative = rssiHistogram && rssiHistogram->cumulative;
+    beginFrame(cumulative ? CHROME_ALT : CHROME_EMPTY);
     
-    if (points.empty()) {
+    if (!rssiHistogram || rssiHistogram->binCount == 0 ||
+        (cumulative ? stats.totalEvents == 0 : rssiHistogram->windowTotal == 0)) {
         canvas->setTextDatum(middle_center);
         canvas->drawString("No events", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        presentCanvas();
         return;
     }
     
-    const int numBins = 10;
-    int bins[numBins] = {0};
-    int16_t minRssi = -120;
-    int16_t maxRssi = -50;
-    int binSize = (maxRssi - minRssi) / numBins;
+    // 计数由监听器随雷达点进出增量维护，界面任务在顺序锁下复制 O(bins) 的快照后绘制
+    const int numBins = rssiHistogram->binCount;
+    uint32_t bins[RSSI_HISTOGRAM_MAX_BINS];
+    uint32_t maxCount = 0;
     
-    for (const auto& point : points) {
-        int binIndex = (point.rssi - minRssi) / binSize;
-        if (binIndex < 0) binIndex = 0;
-        if (binIndex >= numBins) binIndex = numBins - 1;
-        bins[binIndex]++;
-    }
-    
-    int maxCount = 0;
     for (int i = 0; i < numBins; i++) {
+        bins[i] = rssiHistogram->counts[i];
         if (bins[i] > maxCount) maxCount = bins[i];
     }
     
@@ -221,11 +550,20 @@ void ScopeDisplay::drawHistogram(const std::vector<RadarPoint>& points, const Ev
         int barHeight = (maxCount > 0) ? (maxBarHeight * bins[i] / maxCount) : 0;
         int y = startY + maxBarHeight - barHeight;
         
-        int16_t binRssi = minRssi + i * binSize;
+        int16_t binRssi = rssiHistogram->edges[i];
         uint16_t color = (binRssi > -80) ? TFT_GREEN : (binRssi > -100) ? TFT_YELLOW : TFT_RED;
         
         canvas->fillRect(x + 1, y, barWidth - 2, barHeight, color);
         
+        // 当前频点在窗口中的分布以白框叠加
+        if (!cumulative) {
+            uint16_t channelCount = rssiHistogram->channelCounts[i];
+            if (channelCount > 0) {
+                int channelHeight = maxBarHeight * channelCount / maxCount;
+                canvas->drawRect(x + 1, startY + maxBarHeight - channelHeight, barWidth - 2, channelHeight, TFT_WHITE);
+            }
+        }
+        
         if (i % 2 == 0) {
             canvas->setTextDatum(bottom_center);
             canvas->setTextSize(1);
@@ -234,36 +572,60 @@ void ScopeDisplay::drawHistogram(const std::vector<RadarPoint>& points, const Ev
         }
     }
     
-    canvas->pushSprite(wx, wy);
+    presentCanvas();
 }
 
-void ScopeDisplay::drawEventList(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
+void ScopeDisplay::drawEventList(const PointRing& points, const EventStats& stats) {
+    beginFrame(CHROME_EMPTY);
     
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->setTextDatum(top_center);
-    canvas->drawString("Event List", ww / 2, 2 * m);
+    int startY = 4 * m + canvas->fontHeight();
+    int lineHeight = canvas->fontHeight() + 2;
+    uint8_t maxLines = std::min((wh - startY) / lineHeight, (int)EVENT_LIST_MAX_LINES);
+    bool filtered = followChannel || eventRssiFilter > 0;
+    
+    // 最新的 maxLines 条符合条件的事件：索引按时间倒序给出，只访问命中的记录
+    const RadarPoint* shown[EVENT_LIST_MAX_LINES];
+    uint8_t shownCount = 0;
+    if (eventIndex) {
+        EventQuery query;
+        query.newestFirst = true;
+        query.minRssi = EVENT_RSSI_FILTERS[eventRssiFilter];
+        if (followChannel) {
+            query.firstChannel = currentFreqIndex;
+            query.lastChannel = currentFreqIndex;
+        }
+        for (const RadarPoint& point : eventIndex->query(query)) {
+            if (shownCount == maxLines) break;
+            shown[shownCount++] = &point;
+        }
+    } else {
+        for (size_t i = points.size(); i > 0 && shownCount < maxLines; i--) {
+            shown[shownCount++] = &points[i - 1];
+        }
+    }
     
-    for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
+    if (filtered) {
+        String label = followChannel ? "ch" : "";
+        if (eventRssiFilter > 0) {
+            label += (label.length() > 0 ? " >" : ">") + String(EVENT_RSSI_FILTERS[eventRssiFilter]);
+        }
+        canvas->setTextColor(COLOR_SILVER);
+        canvas->setTextSize(1);
+        canvas->setTextDatum(top_right);
+        canvas->drawString(label, ww - 2 * m, 2 * m);
     }
     
-    if (points.empty()) {
+    if (shownCount == 0) {
         canvas->setTextDatum(middle_center);
-        canvas->drawString("No events", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        canvas->drawString(filtered ? "No matching events" : "No events", ww / 2, wh / 2);
+        presentCanvas();
         return;
     }
     
-    int startY = 4 * m + canvas->fontHeight();
-    int lineHeight = canvas->fontHeight() + 2;
-    int maxLines = (wh - startY) / lineHeight;
-    
-    int startIdx = std::max(0, (int)points.size() - maxLines);
-    
-    for (int i = startIdx; i < (int)points.size(); i++) {
-        int y = startY + (i - startIdx) * lineHeight;
-        const auto& point = points[i];
+    // 最旧的一条在最上面
+    for (uint8_t row = 0; row < shownCount; row++) {
+        int y = startY + row * lineHeight;
+        const auto& point = *shown[shownCount - 1 - row];
         
         uint16_t color = (point.eventType == EVENT_RX_DONE) ? TFT_GREEN : TFT_RED;
         
@@ -275,81 +637,93 @@ void ScopeDisplay::drawEventList(const std::vector<RadarPoint>& points, const Ev
         
         String line = "RSSI:" + String(point.rssi) + " ";
         line += "Len:" + String(point.packetLength) + " ";
-        line += "T:" + String((millis() - point.timestamp) / 1000) + "s";
+        line += "T:" + String((unsigned long)((renderNow() - point.timestampUs()) / US_PER_SEC)) + "s";
+        
+        // 负载前 4 字节（在池的锁内复制，监听任务可能同时覆盖该槽位）
+        if (payloadPool) {
+            uint8_t head[4];
+            uint8_t n = payloadPool->copy(point.payload, head, sizeof(head));
+            if (n > 0) {
+                static const char hexDigits[] = "0123456789ABCDEF";
+                char hex[9];
+                for (uint8_t b = 0; b < n; b++) {
+                    hex[b * 2] = hexDigits[head[b] >> 4];
+                    hex[b * 2 + 1] = hexDigits[head[b] & 0x0F];
+                }
+                hex[n * 2] = '\0';
+                line += " ";
+                line += hex;
+            }
+        }
+        
+        if (point.eventType == EVENT_RX_DONE) {
+            line += " ";
+            line += protocolShortName(point.protocol);
+        }
         
         canvas->drawString(line, 2 * m + 6, y);
     }
     
-    canvas->pushSprite(wx, wy);
+    presentCanvas();
 }
 
-void ScopeDisplay::drawStatistics(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
-    
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->setTextDatum(top_center);
-    canvas->drawString("Statistics", ww / 2, 2 * m);
-    
-    for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
-    }
+void ScopeDisplay::drawStatistics(const PointRing& points, const EventStats& stats) {
+    beginFrame(stats.totalEvents == 0 ? CHROME_EMPTY : CHROME_POPULATED);
     
     if (stats.totalEvents == 0) {
         canvas->setTextDatum(middle_center);
         canvas->drawString("No events", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        presentCanvas();
         return;
     }
     
     int y = 4 * m + canvas->fontHeight();
-    int lineHeight = canvas->fontHeight() + 4;
+    int lineHeight = canvas->fontHeight() + 3;
     
     canvas->setTextDatum(top_left);
     canvas->setTextSize(1);
     
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("Total Events:", 2 * m, y);
     canvas->setTextColor(COLOR_SILVER);
     canvas->drawString(String(stats.totalEvents), 2 * m + 80, y);
     
     y += lineHeight;
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("RX Done:", 2 * m, y);
     canvas->setTextColor(TFT_GREEN);
     canvas->drawString(String(stats.rxDoneCount), 2 * m + 80, y);
     
     y += lineHeight;
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("RX Error:", 2 * m, y);
     canvas->setTextColor(TFT_RED);
     canvas->drawString(String(stats.rxErrorCount), 2 * m + 80, y);
     
     y += lineHeight;
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("Avg RSSI:", 2 * m, y);
     canvas->setTextColor(COLOR_SILVER);
-    canvas->drawString(String(stats.avgRssi) + " dBm", 2 * m + 80, y);
+    canvas->drawString(String(stats.avgRssi, 1) + " dBm", 2 * m + 80, y);
     
     y += lineHeight;
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("Max RSSI:", 2 * m, y);
     canvas->setTextColor(COLOR_SILVER);
-    canvas->drawString(String(stats.maxRssi) + " dBm", 2 * m + 80, y);
+    canvas->drawString(String(stats.maxRssi) + " / " + String(stats.minRssi) + " dBm", 2 * m + 80, y);
     
     y += lineHeight;
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("Min RSSI:", 2 * m, y);
     canvas->setTextColor(COLOR_SILVER);
-    canvas->drawString(String(stats.minRssi) + " dBm", 2 * m + 80, y);
+    canvas->drawString(String(stats.rssiP10) + "/" + String(stats.rssiP50) + "/" +
+        String(stats.rssiP90) + "/" + String(stats.rssiP99), 2 * m + 80, y);
     
     y += lineHeight;
-    canvas->setTextColor(UX_COLOR_ACCENT);
-    canvas->drawString("Success Rate:", 2 * m, y);
     float successRate = (float)stats.rxDoneCount / stats.totalEvents * 100.0;
     canvas->setTextColor(COLOR_SILVER);
     canvas->drawString(String(successRate, 1) + "%", 2 * m + 80, y);
     
-    canvas->pushSprite(wx, wy);
+    y += lineHeight;
+    canvas->setTextColor(COLOR_SILVER);
+    canvas->drawString(String(stats.duplicateCount) + " / ~" + String(stats.distinctSources), 2 * m + 80, y);
+    
+    // 丢失计数：串口溢出 / 帧环形区满 / RSSI 无效 / 缓冲区淘汰 / 频率设置失败（标签在静态部分）
+    y += lineHeight;
+    canvas->setTextColor(COLOR_SILVER);
+    canvas->drawString(String(Metrics::get(METRIC_UART_OVERRUNS)) + "/" + String(Metrics::get(METRIC_FRAME_RING_FULL)) + "/" +
+        String(Metrics::get(METRIC_RSSI_REJECTED)) + "/" +
+        String(Metrics::get(METRIC_POINT_EVICTIONS)) + "/" + String(Metrics::get(METRIC_SET_FREQ_FAILURES)), 2 * m + 80, y);
+    
+    presentCanvas();
 }
 
 void ScopeDisplay::drawActivityIndicator(int x, int y, float score) {
@@ -380,11 +754,7 @@ void ScopeDisplay::draw_rssi_indicator(M5Canvas* c, int x, int y, int rssi, bool
     
     c->fillRect(x, y, 20, 8, UX_COLOR_DARK);
     
-    int bars = 0;
-    if (rssi > -70) bars = 4;
-    else if (rssi > -80) bars = 3;
-    else if (rssi > -90) bars = 2;
-    else if (rssi > -100) bars = 1;
+    int bars = rssiBars(rssi);
     
     uint16_t color = bars >= 3 ? TFT_GREEN : (bars >= 2 ? TFT_YELLOW : TFT_RED);
     
@@ -442,21 +812,13 @@ void ScopeDisplay::draw_statistics_icon(M5Canvas* c, int x, int y, bool active)
     c->drawLine(x + 4, y, x + 8, y + 4, color);
 }
 
-void ScopeDisplay::drawFreqCompare(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
-    
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->setTextDatum(top_center);
-    canvas->drawString("Freq Compare", ww / 2, 2 * m);
-    
-    for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
-    }
+void ScopeDisplay::drawFreqCompare(const PointRing& points, const EventStats& stats) {
+    beginFrame(CHROME_EMPTY);
     
     if (totalFreqCount == 0) {
         canvas->setTextDatum(middle_center);
         canvas->drawString("No frequencies", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        presentCanvas();
         return;
     }
     
@@ -464,45 +826,50 @@ void ScopeDisplay::drawFreqCompare(const std::vector<RadarPoint>& points, const
     int lineHeight = canvas->fontHeight() + 2;
     int maxLines = (wh - startY) / lineHeight;
     
-    int startIdx = std::max(0, currentFreqIndex - maxLines / 2);
+    int startIdx = std::max(0, (int)currentFreqIndex - maxLines / 2);
     int endIdx = std::min((int)totalFreqCount, startIdx + maxLines);
     
     for (int i = startIdx; i < endIdx; i++) {
         int y = startY + (i - startIdx) * lineHeight;
         
-        String freqStr;
-        if (i < freqList.size()) {
-            freqStr = String(freqList[i] / 1000000.0, 2) + " MHz";
-        } else {
-            freqStr = "Freq " + String(i + 1);
-        }
-        
         uint16_t color = (i == currentFreqIndex) ? UX_COLOR_ACCENT : COLOR_SILVER;
         
         canvas->setTextDatum(top_left);
         canvas->setTextSize(1);
         canvas->setTextColor(color);
         
-        canvas->drawString(freqStr, 2 * m, y);
+        if (i < channelPlan->size()) {
+            labelCache.drawFrequency(canvas, channelPlan->frequencyAt(i), LABEL_MHZ_UNIT, 2 * m, y, top_left, color);
+        } else {
+            canvas->drawString("Freq " + String(i + 1), 2 * m, y);
+        }
+        
+        if (i < channelSources.size() && channelSources[i] > 0) {
+            String info = "~" + String(channelSources[i]) + " src";
+            
+            // 该频点出现过的已识别协议
+            uint8_t mask = i < channelProtocols.size() ? channelProtocols[i] : 0;
+            for (uint8_t p = PROTO_LORAWAN; p < PROTO_COUNT; p++) {
+                if (mask & (1 << p)) {
+                    info += " ";
+                    info += protocolShortName(p);
+                }
+            }
+            
+            canvas->setTextDatum(top_right);
+            canvas->drawString(info, ww - 3 * m, y);
+        }
         
         if (i == currentFreqIndex) {
             canvas->drawRect(2 * m, y - 1, ww - 4 * m, lineHeight, UX_COLOR_ACCENT);
         }
     }
     
-    canvas->pushSprite(wx, wy);
+    presentCanvas();
 }
 
-void ScopeDisplay::drawRealtimeMonitor(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
-    
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->setTextDatum(top_center);
-    canvas->drawString("Realtime Monitor", ww / 2, 2 * m);
-    
-    for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
-    }
+void ScopeDisplay::drawRealtimeMonitor(const PointRing& points, const EventStats& stats) {
+    beginFrame(CHROME_EMPTY);
     
     int startY = 4 * m + canvas->fontHeight();
     int graphH = wh - startY - 2 * m;
@@ -510,37 +877,62 @@ void ScopeDisplay::drawRealtimeMonitor(const std::vector<RadarPoint>& points, co
     int graphY = startY;
     int graphW = ww - 4 * m;
     
-    canvas->drawRect(graphX, graphY, graphW, graphH, UX_COLOR_LIGHT);
+    uint64_t now = renderNow();
+    uint64_t timeWindow = 10 * US_PER_SEC;
     
-    canvas->setTextDatum(top_left);
-    canvas->setTextSize(1);
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->drawString("-50", graphX + graphW + 2, graphY);
-    canvas->drawString("-120", graphX + graphW + 2, graphY + graphH - canvas->fontHeight());
+    // 余辉层覆盖坐标框内部，随时间向左滚动
+    bool phosphor = realtimePhosphor.allocate(canvas, graphW - 2, graphH - 2, PHOSPHOR_REALTIME_STEP_US);
+    if (phosphor) {
+        realtimePhosphor.decay(now);
+        if (now < realtimeScrolledUs) {
+            realtimePhosphor.clear();
+            realtimeScrolledUs = now;
+        }
+        uint64_t shift = (now - realtimeScrolledUs) * graphW / timeWindow;
+        if (shift > 0) {
+            realtimePhosphor.scroll(shift < graphW ? shift : graphW);
+            realtimeScrolledUs += shift * timeWindow / graphW;
+        }
+    }
     
-    if (points.empty()) {
+    if (points.empty() && (!phosphor || realtimePhosphor.dark())) {
         canvas->setTextDatum(middle_center);
         canvas->drawString("No data", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        presentCanvas();
         return;
     }
     
-    uint32_t now = millis();
-    uint32_t timeWindow = 10000;
     int16_t minRssi = -120;
     int16_t maxRssi = -50;
     
-    for (const auto& point : points) {
-        uint32_t timeDiff = now - point.timestamp;
+    // 有余辉层时只处理尚未打点的新事件
+    size_t first = 0;
+    if (phosphor) {
+        first = points.size();
+        while (first > 0 && realtimePhosphor.isNew(points[first - 1].sequence)) first--;
+    }
+    
+    for (size_t i = first; i < points.size(); i++) {
+        const RadarPoint& point = points[i];
+        uint64_t timeDiff = now > point.timestampUs() ? now - point.timestampUs() : 0;
         if (timeDiff > timeWindow) continue;
         
         float x = graphX + graphW * (1.0 - (float)timeDiff / timeWindow);
         float y = graphY + graphH * (1.0 - (float)(point.rssi - minRssi) / (maxRssi - minRssi));
         
-        uint16_t color = (point.eventType == EVENT_RX_DONE) ? TFT_GREEN : TFT_RED;
+        PhosphorHue hue = (point.eventType == EVENT_RX_DONE) ? PHOSPHOR_GREEN : PHOSPHOR_RED;
         int radius = (point.packetLength > 0) ? 3 : 2;
         
-        canvas->fillCircle(x, y, radius, color);
+        if (phosphor) {
+            realtimePhosphor.stamp(x - graphX - 1, y - graphY - 1, radius, hue, timeDiff);
+        } else {
+            canvas->fillCircle(x, y, radius, PhosphorLayer::hueColor(hue));
+        }
+    }
+    
+    if (phosphor) {
+        if (!points.empty()) realtimePhosphor.markStamped(points.back().sequence);
+        realtimePhosphor.compose(canvas, graphX + 1, graphY + 1);
     }
     
     canvas->setTextDatum(bottom_center);
@@ -548,62 +940,79 @@ void ScopeDisplay::drawRealtimeMonitor(const std::vector<RadarPoint>& points, co
     canvas->setTextColor(COLOR_SILVER);
     canvas->drawString("Last 10s", ww / 2, wh - 2 * m);
     
-    canvas->pushSprite(wx, wy);
+    presentCanvas();
 }
 
-void ScopeDisplay::drawRadar(const std::vector<RadarPoint>& points, const EventStats& stats) {
-    canvas->fillSprite(BG_COLOR);
-    
-    canvas->setTextColor(COLOR_SILVER);
-    canvas->setTextDatum(top_center);
-    canvas->drawString("Radar", ww / 2, 2 * m);
-    
-    for (int i = 0; i <= 1; i++) {
-        canvas->drawLine(10, 3 * m + canvas->fontHeight() + i, ww - 10, 3 * m + canvas->fontHeight() + i, UX_COLOR_LIGHT);
-    }
+void ScopeDisplay::drawRadar(const PointRing& points, const EventStats& stats) {
+    beginFrame(CHROME_EMPTY);
     
     int centerX = ww / 2;
     int centerY = (wy + wh / 2) - 5;
     int maxRadius = std::min(ww, wh) / 2 - 6 * m;
     
-    canvas->drawCircle(centerX, centerY, maxRadius, UX_COLOR_LIGHT);
-    canvas->drawCircle(centerX, centerY, maxRadius * 0.75, UX_COLOR_LIGHT);
-    canvas->drawCircle(centerX, centerY, maxRadius * 0.5, UX_COLOR_LIGHT);
-    canvas->drawCircle(centerX, centerY, maxRadius * 0.25, UX_COLOR_LIGHT);
-    
-    canvas->drawLine(centerX, centerY - maxRadius, centerX, centerY + maxRadius, UX_COLOR_LIGHT);
-    canvas->drawLine(centerX - maxRadius, centerY, centerX + maxRadius, centerY, UX_COLOR_LIGHT);
-    
-    if (points.empty() || freqList.empty()) {
+    if (channelPlan->empty()) {
         canvas->setTextDatum(middle_center);
         canvas->drawString("No data", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        presentCanvas();
         return;
     }
     
-    uint32_t startFreq = freqList[0];
-    uint32_t endFreq = freqList[freqList.size() - 1];
+    uint32_t startFreq = channelPlan->first();
+    uint32_t endFreq = channelPlan->last();
     uint32_t freqRange = endFreq - startFreq;
     
     if (freqRange == 0) {
         canvas->setTextDatum(middle_center);
         canvas->drawString("Single freq", ww / 2, wh / 2);
-        canvas->pushSprite(wx, wy);
+        presentCanvas();
         return;
     }
     
-    std::map<uint32_t, bool> freqHasData;
-    for (const auto& point : points) {
-        freqHasData[point.frequency] = true;
+    uint64_t now = renderNow();
+    // 余辉层覆盖整个雷达圆（含最大点半径）
+    const uint8_t maxPointSize = 3;
+    int layerX = centerX - maxRadius - maxPointSize;
+    int layerY = centerY - maxRadius - maxPointSize;
+    int layerSize = 2 * (maxRadius + maxPointSize) + 1;
+    bool phosphor = radarPhosphor.allocate(canvas, layerSize, layerSize, PHOSPHOR_RADAR_STEP_US);
+    
+    size_t first = 0;
+    if (phosphor) {
+        if (radarPhosphorStale) {
+            radarPhosphorStale = false;
+            radarPhosphor.clear();
+            std::fill(channelSeen.begin(), channelSeen.end(), 0);
+        }
+        // 频点标签与点一起衰减
+        uint8_t faded = radarPhosphor.decay(now);
+        if (faded) {
+            for (auto& glow : channelSeen) {
+                glow = glow > faded ? glow - faded : 0;
+            }
+        }
+        // 只处理尚未打点的新事件
+        first = points.size();
+        while (first > 0 && radarPhosphor.isNew(points[first - 1].sequence)) first--;
+    } else {
+        // 每个事件自带频点索引，直接按索引标记
+        std::fill(channelSeen.begin(), channelSeen.end(), 0);
+    }
+    
+    if (points.empty() && (!phosphor || radarPhosphor.dark())) {
+        canvas->setTextDatum(middle_center);
+        canvas->drawString("No data", ww / 2, wh / 2);
+        presentCanvas();
+        return;
     }
     
     int16_t minRssi = -120;
     int16_t maxRssi = -50;
     
-    for (const auto& point : points) {
+    for (size_t i = first; i < points.size(); i++) {
+        const RadarPoint& point = points[i];
         float angle = 0;
         
-        if (freqList.size() > 1) {
+        if (channelPlan->size() > 1) {
             angle = ((float)(point.frequency - startFreq) / freqRange) * 2 * PI - PI / 2;
         }
         
@@ -613,46 +1022,139 @@ void ScopeDisplay::drawRadar(const std::vector<RadarPoint>& points, const EventS
         float x = centerX + radius * cos(angle);
         float y = centerY + radius * sin(angle);
         
-        uint16_t color;
+        PhosphorHue hue;
         if (point.eventType == EVENT_RX_DONE) {
             if (rssiNorm > 0.7) {
-                color = TFT_GREEN;
+                hue = PHOSPHOR_GREEN;
             } else if (rssiNorm > 0.4) {
-                color = TFT_YELLOW;
+                hue = PHOSPHOR_YELLOW;
             } else {
-                color = TFT_ORANGE;
+                hue = PHOSPHOR_ORANGE;
             }
         } else {
-            color = TFT_RED;
+            hue = PHOSPHOR_RED;
         }
         
-        int pointSize = (point.packetLength > 0) ? 3 : 2;
-        canvas->fillCircle(x, y, pointSize, color);
+        int pointSize = (point.packetLength > 0) ? maxPointSize : 2;
+        uint8_t level = 1;
+        if (phosphor) {
+            uint64_t age = now > point.timestampUs() ? now - point.timestampUs() : 0;
+            level = radarPhosphor.stamp(x - layerX, y - layerY, pointSize, hue, age);
+        } else {
+            canvas->fillCircle(x, y, pointSize, PhosphorLayer::hueColor(hue));
+        }
+        if (point.channelIndex < channelSeen.size() && level > channelSeen[point.channelIndex]) {
+            channelSeen[point.channelIndex] = level;
+        }
+    }
+    
+    if (phosphor) {
+        if (!points.empty()) radarPhosphor.markStamped(points.back().sequence);
+        radarPhosphor.compose(canvas, layerX, layerY);
     }
     
-    for (const auto& freq : freqList) {
-        if (freqHasData.find(freq) != freqHasData.end()) {
+    for (uint16_t index = 0; index < channelSeen.size(); index++) {
+        if (channelSeen[index]) {
+            uint32_t freq = channelPlan->frequencyAt(index);
             float angle = ((float)(freq - startFreq) / freqRange) * 2 * PI - PI / 2;
             float labelRadius = maxRadius + 10;
             float labelX = centerX + labelRadius * cos(angle);
             float labelY = centerY + labelRadius * sin(angle);
             
-            String freqStr = String(freq / 1000000.0, 2);
-            
-            canvas->setTextSize(1);
-            canvas->setTextColor(COLOR_SILVER);
-            
-            if (angle < -PI / 2 || angle > PI / 2) {
-                canvas->setTextDatum(top_right);
-            } else {
-                canvas->setTextDatum(top_left);
+            uint8_t datum = (angle < -PI / 2 || angle > PI / 2) ? top_right : top_left;
+            labelCache.drawFrequency(canvas, freq, LABEL_MHZ_2, labelX, labelY, datum, COLOR_SILVER);
+        }
+    }
+    
+    presentCanvas();
+}
+
+// 热力图配色：0 为背景，其余按强度由蓝经绿、黄到红
+static uint16_t heatColor(uint8_t level) {
+    if (level == 0) return BG_COLOR;
+    
+    uint8_t r, g, b;
+    if (level < 85) {
+        r = 0; g = level * 3; b = 255 - level * 3;
+    } else if (level < 170) {
+        r = (level - 85) * 3; g = 255; b = 0;
+    } else {
+        r = 255; g = 255 - (level - 170) * 3; b = 0;
+    }
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+void ScopeDisplay::drawHeatmap(const PointRing& points, const EventStats& stats) {
+    bool clockSet = occupancy && occupancy->isClockSet();
+    beginFrame(clockSet ? CHROME_ALT : CHROME_EMPTY);
+    
+    if (!occupancy || occupancy->getChannelCount() == 0 || occupancy->getPeak() == 0) {
+        canvas->setTextDatum(middle_center);
+        // 时钟设定前不计数
+        canvas->drawString(clockSet ? "No data" : "Set clock: time HH:MM", ww / 2, wh / 2);
+        presentCanvas();
+        return;
+    }
+    
+    const int labelW = 36;
+    int gridX = labelW;
+    int gridY = 4 * m + canvas->fontHeight();
+    int colW = (ww - gridX - 2 * m) / OCCUPANCY_HOURS;
+    int gridH = wh - gridY - canvas->fontHeight() - 2 * m;
+    
+    // 频点多于像素行时，每行取一组相邻频点中的最大值
+    uint16_t channels = occupancy->getChannelCount();
+    int rows = std::min((int)channels, gridH);
+    int perRow = (channels + rows - 1) / rows;
+    rows = (channels + perRow - 1) / perRow;
+    int rowH = gridH / rows;
+    uint16_t peak = occupancy->getPeak();
+    
+    for (int row = 0; row < rows; row++) {
+        uint16_t first = row * perRow;
+        uint16_t last = std::min((int)channels, first + perRow);
+        int y = gridY + row * rowH;
+        
+        for (uint8_t hour = 0; hour < OCCUPANCY_HOURS; hour++) {
+            uint16_t value = 0;
+            for (uint16_t ch = first; ch < last; ch++) {
+                value = std::max(value, occupancy->get(ch, hour));
             }
-            
-            canvas->drawString(freqStr, labelX, labelY);
+            if (value == 0) continue;
+            canvas->fillRect(gridX + hour * colW, y, colW - 1, rowH, heatColor((uint32_t)value * 255 / peak));
         }
+        
+        // 当前频点所在行
+        if (currentFreqIndex >= first && currentFreqIndex < last) {
+            canvas->fillRect(gridX - 3, y, 2, std::max(rowH, 1), UX_COLOR_ACCENT);
+        }
+    }
+    
+    int gridBottom = gridY + rows * rowH;
+    canvas->drawRect(gridX - 1, gridY - 1, colW * OCCUPANCY_HOURS + 1, gridBottom - gridY + 2, UX_COLOR_LIGHT);
+    
+    // 当前小时；时钟未设定时显示的是上次保存的数据，没有“现在”
+    if (clockSet) {
+        uint8_t nowHour = occupancy->hourOf(renderNow());
+        canvas->drawRect(gridX + nowHour * colW - 1, gridY - 1, colW + 1, gridBottom - gridY + 2, UX_COLOR_ACCENT);
+    }
+    
+    canvas->setTextSize(1);
+    canvas->setTextColor(COLOR_SILVER);
+    if (!channelPlan->empty()) {
+        labelCache.drawFrequency(canvas, channelPlan->first(), LABEL_MHZ_1, 0, gridY, top_left, COLOR_SILVER);
+        labelCache.drawFrequency(canvas, channelPlan->frequencyAt(std::min(channels, channelPlan->size()) - 1),
+                                 LABEL_MHZ_1, 0, gridBottom, bottom_left, COLOR_SILVER);
+    }
+    
+    canvas->setTextDatum(top_center);
+    for (uint8_t hour = 0; hour < OCCUPANCY_HOURS; hour += 6) {
+        canvas->drawString(String(hour), gridX + hour * colW + colW / 2, gridBottom + m);
     }
+    canvas->setTextDatum(top_right);
+    canvas->drawString(String(peak), ww - 2 * m, 2 * m);
     
-    canvas->pushSprite(wx, wy);
+    presentCanvas();
 }
 
 void ScopeDisplay::draw_freqcompare_icon(M5Canvas* c, int x, int y, bool active) {
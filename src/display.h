@@ -2,12 +2,55 @@
 #define DISPLAY_H
 
 #include "common.h"
+#include "point_ring.h"
+#include "payload_pool.h"
+#include "rssi_histogram.h"
+#include "rssi_pyramid.h"
+#include "event_query.h"
+#include "occupancy.h"
+#include "label_cache.h"
+#include "phosphor.h"
 #include <M5Cardputer.h>
 
+// 按频点显示来源/协议的上限：容量一次预留，替换频点计划时不重新分配
+// （分类任务可能正在写入）
+const size_t DISPLAY_CHANNEL_INFO_MAX = 1024;
+
+// 静态背景缓存的变体：同一视图有数据与无数据时静态部分不同
+const uint8_t CHROME_EMPTY = 0;
+const uint8_t CHROME_POPULATED = 1;
+const uint8_t CHROME_ALT = 2;           // 标题随状态变化（累计直方图、已校时的热力图）
+const uint16_t CHROME_NONE = 0xFFFF;
+
+// 事件列表最多显示的行数（屏幕高度决定实际行数）
+const uint8_t EVENT_LIST_MAX_LINES = 16;
+
+// 状态栏内容，未变化时不重绘也不推送
+struct SystemBarState {
+    String moduleName;
+    uint32_t frequency;
+    bool scanning;
+    uint8_t rssiBars;
+    uint8_t batteryPct;
+    
+    bool operator==(const SystemBarState& other) const {
+        return frequency == other.frequency && scanning == other.scanning &&
+               rssiBars == other.rssiBars && batteryPct == other.batteryPct &&
+               moduleName == other.moduleName;
+    }
+};
+
 class ScopeDisplay {
 private:
     M5Canvas* canvas;
     M5Canvas* canvasSystemBar;
+    // 当前视图静态部分（标题、分隔线、坐标轴、固定标签）的缓存，每帧整块复制到 canvas；
+    // 分配失败时为 nullptr，静态部分每帧直接绘制
+    M5Canvas* canvasChrome;
+    uint16_t chromeKey;            // 缓存内容对应的 (模式, 变体)
+    SystemBarState shownSystemBar;
+    bool systemBarValid;
+    LabelCache labelCache;
     DisplayMode currentMode;
     
     uint8_t batteryPct;
@@ -15,9 +58,30 @@ private:
     bool isScanning;
     String moduleName;
     uint32_t currentFreq;
-    uint8_t currentFreqIndex;
-    uint8_t totalFreqCount;
-    std::vector<uint32_t> freqList;
+    uint16_t currentFreqIndex;
+    uint16_t totalFreqCount;
+    ChannelPlanRef channelPlan;    // 与监听器共享的频点计划
+    std::vector<uint8_t> channelSeen;  // 雷达视图：各频点标签的余辉亮度（0 不显示），按频点索引
+    // 雷达与实时监测的余辉层：新事件只打点一次，之后按时间衰减；分配失败时逐点重绘
+    PhosphorLayer radarPhosphor;
+    PhosphorLayer realtimePhosphor;
+    volatile bool radarPhosphorStale;   // 频点计划已更换，角度映射失效
+    uint64_t realtimeScrolledUs;       // 实时监测余辉层右边缘对应的时刻
+    const PayloadPool* payloadPool;
+    const RssiHistogramSnapshot* rssiHistogram;   // 界面任务每帧从监听器取的快照
+    const OccupancyHeatmap* occupancy;
+    const RssiPyramid* rssiPyramid;
+    const EventIndex* eventIndex;   // 与 update 传入的缓冲区同步的事件索引
+    // 时间线：缩放档位、向过去平移的时长；每列的聚合结果预先分配
+    uint8_t timelineZoom;
+    uint64_t timelinePanUs;
+    std::vector<PyramidBucket> timelineColumns;
+    bool followChannel;            // 时间线与事件列表只看当前频点
+    uint8_t eventRssiFilter;       // 事件列表的最低 RSSI 档位，0 为不过滤
+    std::vector<uint16_t> channelSources;  // 各频点发送方估计值
+    std::vector<uint8_t> channelProtocols; // 各频点出现过的协议位掩码
+    bool headless;                 // 仅在内存中绘制，不推送到屏幕
+    uint64_t clockOverrideUs;      // 非 0 时替代当前时间，用于可复现的渲染
     
     const uint8_t w = 240;
     const uint8_t h = 135;
@@ -38,7 +102,9 @@ public:
     ~ScopeDisplay();
     
     bool init();
-    void update(const std::vector<RadarPoint>& points, const EventStats& stats);
+    // 离屏初始化：在内存 RGB565 缓冲区中绘制，用于渲染基准测试和黄金图像比对
+    bool initHeadless();
+    void update(const PointRing& points, const EventStats& stats);
     void setMode(DisplayMode mode);
     DisplayMode getMode() const;
     
@@ -47,18 +113,56 @@ public:
     void setScanning(bool scanning);
     void setModuleName(const String& name);
     void setCurrentFreq(uint32_t freq);
-    void setCurrentFreqIndex(uint8_t index, uint8_t total);
-    void setFrequencies(const std::vector<uint32_t>& freqs);
+    void setCurrentFreqIndex(uint16_t index, uint16_t total);
+    void setChannelPlan(ChannelPlanRef plan);
+    void setPayloadPool(const PayloadPool* pool);
+    void setRssiHistogram(const RssiHistogramSnapshot* histogram);
+    void setOccupancy(const OccupancyHeatmap* heatmap);
+    void setRssiPyramid(const RssiPyramid* pyramid);
+    
+    // 时间线缩放（10 s ~ 24 h，step > 0 放大）与平移（step > 0 向现在，< 0 向过去，每步半屏）
+    void zoomTimeline(int8_t step);
+    void panTimeline(int8_t step);
+    // 时间线与事件列表在全部频点与当前频点之间切换
+    void toggleFollowChannel();
+    bool isFollowingChannel() const { return followChannel; }
+    void setEventIndex(const EventIndex* index);
+    // 事件列表的最低 RSSI 档位（不过滤、-110 ~ -70 dBm），step > 0 提高
+    void stepEventRssiFilter(int8_t step);
+    void setChannelSources(uint16_t index, uint32_t estimate);
+    void clearChannelSources();
+    void setChannelProtocols(uint16_t index, uint8_t mask);
+    
+    // 丢弃静态部分缓存，下一帧完整重绘（例如屏幕唤醒后）
+    void invalidate();
+    void setClockOverride(uint64_t us);
+    // 当前帧（状态栏 + 主视图）的指纹，用于对照两次运行的渲染结果
+    uint32_t frameChecksum() const;
+    // 输出当前帧的原始 RGB565 数据（大端，240x135）
+    void dumpFrame(Print& out) const;
     
 private:
+    uint64_t renderNow() const;
+    void presentCanvas();
+    void presentSystemBar();
+    
+    void allocateChrome();
+    // 每帧开始：把 (当前模式, variant) 的静态部分放到 canvas 上
+    void beginFrame(uint8_t variant);
+    void drawChrome(M5Canvas* c, DisplayMode mode, uint8_t variant);
+    void drawTitle(M5Canvas* c, const char* title);
+    static uint8_t rssiBars(int rssi);
+    
     void drawSystemBar();
-    void drawTimeline(const std::vector<RadarPoint>& points, const EventStats& stats);
-    void drawHistogram(const std::vector<RadarPoint>& points, const EventStats& stats);
-    void drawEventList(const std::vector<RadarPoint>& points, const EventStats& stats);
-    void drawStatistics(const std::vector<RadarPoint>& points, const EventStats& stats);
-    void drawFreqCompare(const std::vector<RadarPoint>& points, const EventStats& stats);
-    void drawRealtimeMonitor(const std::vector<RadarPoint>& points, const EventStats& stats);
-    void drawRadar(const std::vector<RadarPoint>& points, const EventStats& stats);
+    void drawTimeline(const PointRing& points, const EventStats& stats);
+    bool renderTimelinePoints(const PointRing& points, uint16_t channel, uint64_t startUs, uint64_t endUs);
+    void drawHistogram(const PointRing& points, const EventStats& stats);
+    void drawEventList(const PointRing& points, const EventStats& stats);
+    void drawStatistics(const PointRing& points, const EventStats& stats);
+    void drawFreqCompare(const PointRing& points, const EventStats& stats);
+    void drawRealtimeMonitor(const PointRing& points, const EventStats& stats);
+    void drawRadar(const PointRing& points, const EventStats& stats);
+    void drawHeatmap(const PointRing& points, const EventStats& stats);
     
     void drawActivityIndicator(int x, int y, float score);
     uint16_t getScoreColor(float score);
@@ -0,0 +1,123 @@
+#include "e220_frame.h"
+#include "metrics.h"
+
+bool parseE220Frame(const uint8_t* data, uint16_t length, FrameView* view) {
+    // 至少 1 字节负载 + RSSI 字节；超长说明多帧粘连或噪声
+    if (length < 2 || length > E220_MAX_FRAME_BYTES) return false;
+    
+    view->data = data;
+    view->length = length - 1;
+    // RSSI 字节按模块手册换算: dBm = -(256 - value)
+    view->rssi = (int16_t)data[length - 1] - 256;
+    return true;
+}
+
+static void discardPending(HardwareSerial* serial) {
+    uint8_t discard[32];
+    while (serial->available() > 0) {
+        serial->read(discard, sizeof(discard));
+    }
+}
+
+E220FrameRing::E220FrameRing()
+    : slotHead(0), slotTail(0), byteHead(0), byteTail(0) {
+}
+
+bool E220FrameRing::reserve(uint16_t length, uint16_t* offset) const {
+    uint8_t nextSlot = (slotHead + 1) % E220_RX_RING_FRAMES;
+    if (nextSlot == slotTail) return false;
+    
+    uint16_t head = byteHead;
+    uint16_t tail = byteTail;
+    
+    // head == tail 表示空，因此写入后不能让 head 追上 tail
+    if (head >= tail) {
+        if (E220_RX_RING_BYTES - head >= length) {
+            *offset = head;
+            return true;
+        }
+        if (tail > length) {
+            *offset = 0;
+            return true;
+        }
+        return false;
+    }
+    
+    if (tail - head > length) {
+        *offset = head;
+        return true;
+    }
+    return false;
+}
+
+// 超长的一段仍按一帧存入（截断），由 parseE220Frame() 判为格式错误
+static uint16_t frameLength(int pending) {
+    return pending > E220_MAX_FRAME_BYTES + 1 ? E220_MAX_FRAME_BYTES + 1 : pending;
+}
+
+void E220FrameRing::publish(uint16_t offset, uint16_t length) {
+    slots[slotHead].offset = offset;
+    slots[slotHead].length = length;
+    byteHead = offset + length;
+    // 数据和描述符写完后再发布
+    __sync_synchronize();
+    slotHead = (slotHead + 1) % E220_RX_RING_FRAMES;
+}
+
+bool E220FrameRing::fill(HardwareSerial* serial) {
+    int pending = serial->available();
+    if (pending <= 0) return false;
+    
+    uint16_t length = frameLength(pending);
+    uint16_t offset;
+    
+    if (!reserve(length, &offset)) {
+        // 消费者跟不上：丢弃本帧，与硬件 FIFO/驱动缓冲区溢出分开计数
+        discardPending(serial);
+        Metrics::increment(METRIC_FRAME_RING_FULL);
+        return false;
+    }
+    
+    serial->read(bytes + offset, length);
+    discardPending(serial);
+    publish(offset, length);
+    return true;
+}
+
+bool E220FrameRing::fill(const uint8_t* data, uint16_t pending) {
+    if (pending == 0) return false;
+    
+    uint16_t length = frameLength(pending);
+    uint16_t offset;
+    
+    if (!reserve(length, &offset)) {
+        Metrics::increment(METRIC_FRAME_RING_FULL);
+        return false;
+    }
+    
+    memcpy(bytes + offset, data, length);
+    publish(offset, length);
+    return true;
+}
+
+void E220FrameRing::discard() {
+    byteTail = byteHead;
+    slotTail = slotHead;
+}
+
+int E220FrameRing::peek(FrameView* view) const {
+    if (slotHead == slotTail) return -1;
+    __sync_synchronize();
+    
+    const Slot& slot = slots[slotTail];
+    return parseE220Frame(bytes + slot.offset, slot.length, view) ? 0 : 1;
+}
+
+void E220FrameRing::release() {
+    if (slotHead == slotTail) return;
+    
+    const Slot& slot = slots[slotTail];
+    byteTail = slot.offset + slot.length;
+    __sync_synchronize();
+    slotTail = (slotTail + 1) % E220_RX_RING_FRAMES;
+}
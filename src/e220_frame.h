@@ -0,0 +1,63 @@
+#ifndef E220_FRAME_H
+#define E220_FRAME_H
+
+#include <Arduino.h>
+
+// E220 透传模式下的接收帧：负载后附加 1 字节 RSSI（rssi_byte_flag 启用时）
+const uint8_t E220_MAX_PAYLOAD = 200;
+const uint16_t E220_MAX_FRAME_BYTES = E220_MAX_PAYLOAD + 1;
+
+// 帧环形区容量：字节区与帧描述符各自固定，不动态分配
+const uint16_t E220_RX_RING_BYTES = 1024;
+const uint8_t E220_RX_RING_FRAMES = 16;
+
+// 接收帧视图：data 指向环形区内的负载，在 release() 之前有效
+struct FrameView {
+    const uint8_t* data;
+    uint8_t length;
+    int16_t rssi;
+    
+    FrameView() : data(nullptr), length(0), rssi(-120) {}
+};
+
+// 原地解析一帧（负载 + RSSI 字节），不复制数据；长度不合法时返回 false
+bool parseE220Frame(const uint8_t* data, uint16_t length, FrameView* view);
+
+// 串口接收帧环形区：单生产者（串口空闲回调）/ 单消费者（监听任务），无锁
+// 每帧在字节区内连续存放，尾部空间不足时从头开始，因此视图总是连续的
+class E220FrameRing {
+public:
+    E220FrameRing();
+    
+    // 在串口空闲（帧结束）回调中调用：把驱动缓冲区中的字节作为一帧搬入
+    // 一次只读出已到达的字节，不等待，返回是否存入
+    bool fill(HardwareSerial* serial);
+    // 同样的截断、满时丢弃与计数规则，字节来自内存（压力测试的串口模型）
+    bool fill(const uint8_t* data, uint16_t pending);
+    
+    bool available() const { return slotHead != slotTail; }
+    // 取最旧一帧：0 成功，1 帧格式错误（仍需 release），-1 无数据
+    int peek(FrameView* view) const;
+    // 释放 peek() 取得的帧
+    void release();
+    // 丢弃全部未读帧：只移动消费者一侧的位置，调用时生产者（串口回调）必须已摘除
+    void discard();
+    
+private:
+    struct Slot {
+        uint16_t offset;
+        uint16_t length;
+    };
+    
+    bool reserve(uint16_t length, uint16_t* offset) const;
+    void publish(uint16_t offset, uint16_t length);
+    
+    uint8_t bytes[E220_RX_RING_BYTES];
+    Slot slots[E220_RX_RING_FRAMES];
+    volatile uint8_t slotHead;      // 生产者写入
+    volatile uint8_t slotTail;      // 消费者写入
+    volatile uint16_t byteHead;     // 生产者写入
+    volatile uint16_t byteTail;     // 消费者写入：最旧未释放帧的起点
+};
+
+#endif // E220_FRAME_H
@@ -0,0 +1,69 @@
+#include "event_codec.h"
+
+static uint8_t* putLe(uint8_t* p, uint64_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        *p++ = (uint8_t)(value >> (8 * i));
+    }
+    return p;
+}
+
+static const uint8_t* getLe(const uint8_t* p, uint64_t* value, uint8_t bytes) {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < bytes; i++) {
+        v |= (uint64_t)(*p++) << (8 * i);
+    }
+    *value = v;
+    return p;
+}
+
+// RSSI/SNR 以有符号单字节存储，超出范围时截断
+static uint8_t clampInt8(int16_t value) {
+    if (value < -128) value = -128;
+    if (value > 127) value = 127;
+    return (uint8_t)(int8_t)value;
+}
+
+size_t encodeEvent(const RadarPoint& point, uint8_t* out) {
+    uint8_t* p = out;
+    p = putLe(p, point.timestampUs(), 6);
+    p = putLe(p, point.frequency, 4);
+    p = putLe(p, point.channelIndex, 2);
+    *p++ = clampInt8(point.rssi);
+    *p++ = clampInt8(point.snr);
+    *p++ = point.packetLength;
+    *p++ = (uint8_t)point.eventType;
+    *p++ = point.protocol;
+    *p++ = point.duplicate ? EVENT_FLAG_DUPLICATE : 0;
+    *p++ = point.dataRateIndex;
+    p = putLe(p, point.fingerprint, 4);
+    p = putLe(p, point.sequence, 4);
+    return p - out;
+}
+
+bool decodeEvent(const uint8_t* in, size_t len, RadarPoint* point) {
+    if (len < EVENT_RECORD_SIZE) return false;
+    
+    uint64_t v;
+    const uint8_t* p = in;
+    
+    p = getLe(p, &v, 6);
+    point->setTimestampUs(v);
+    p = getLe(p, &v, 4);
+    point->frequency = (uint32_t)v;
+    p = getLe(p, &v, 2);
+    point->channelIndex = (uint16_t)v;
+    point->rssi = (int8_t)*p++;
+    point->snr = (int8_t)*p++;
+    point->packetLength = *p++;
+    point->eventType = (EventType)*p++;
+    point->protocol = *p++;
+    point->duplicate = (*p++ & EVENT_FLAG_DUPLICATE) != 0;
+    point->dataRateIndex = *p++;
+    p = getLe(p, &v, 4);
+    point->fingerprint = (uint32_t)v;
+    p = getLe(p, &v, 4);
+    point->sequence = (uint32_t)v;
+    point->payload = 0;
+    
+    return true;
+}
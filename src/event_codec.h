@@ -0,0 +1,17 @@
+#ifndef EVENT_CODEC_H
+#define EVENT_CODEC_H
+
+#include "common.h"
+
+// 单条事件的定长二进制记录（小端），用于串口流式输出和离线回放
+// 布局: ts_us(6) freq(4) ch(2) rssi(1) snr(1) len(1) type(1) proto(1) flags(1) rate(1) fp(4) seq(4)
+const size_t EVENT_RECORD_SIZE = 27;
+
+const uint8_t EVENT_FLAG_DUPLICATE = 0x01;
+
+// 编码到 out（至少 EVENT_RECORD_SIZE 字节），返回写入字节数
+size_t encodeEvent(const RadarPoint& point, uint8_t* out);
+// 从 in 解码一条记录，长度不足时返回 false
+bool decodeEvent(const uint8_t* in, size_t len, RadarPoint* point);
+
+#endif // EVENT_CODEC_H
@@ -0,0 +1,231 @@
+#include "event_query.h"
+#include <algorithm>
+
+const RadarPoint& EventCursor::operator*() const {
+    return index->at(current);
+}
+
+EventCursor& EventCursor::operator++() {
+    advance();
+    return *this;
+}
+
+void EventCursor::advance() {
+    while (true) {
+        uint32_t sequence = scan ? nextScan() : nextLane();
+        if (sequence == EVENT_SEQ_NONE) {
+            current = EVENT_SEQ_NONE;
+            return;
+        }
+        if (query.matches(index->at(sequence))) {
+            current = sequence;
+            return;
+        }
+    }
+}
+
+uint32_t EventCursor::nextScan() {
+    // [lo, hi] 为尚未访问的区间，两端按方向收缩
+    if (lo > hi) return EVENT_SEQ_NONE;
+    return query.newestFirst ? hi-- : lo++;
+}
+
+uint32_t EventCursor::nextLane() {
+    uint8_t best = laneCount;
+    for (uint8_t i = 0; i < laneCount; i++) {
+        if (lanes[i] == EVENT_SEQ_NONE) continue;
+        if (best == laneCount ||
+            (query.newestFirst ? lanes[i] > lanes[best] : lanes[i] < lanes[best])) {
+            best = i;
+        }
+    }
+    if (best == laneCount) return EVENT_SEQ_NONE;
+    
+    // 序号与时间同序，各频点链表按序号归并即为时间顺序
+    uint32_t sequence = lanes[best];
+    size_t slot = index->slotOf(sequence);
+    uint32_t next = query.newestFirst ? index->prevOnChannel[slot] : index->nextOnChannel[slot];
+    lanes[best] = (next != EVENT_SEQ_NONE && next >= lo && next <= hi) ? next : EVENT_SEQ_NONE;
+    return sequence;
+}
+
+EventIndex::EventIndex()
+    : ring(nullptr), oldestSeq(1), newestSeq(0), linked(false) {
+}
+
+void EventIndex::sync(const PointRing& points, uint16_t channels) {
+    if (points.empty()) {
+        rebuild(points, channels);
+        return;
+    }
+    
+    uint32_t front = points.front().sequence;
+    uint32_t back = points.back().sequence;
+    bool contiguous = back - front + 1 == points.size();
+    bool indexed = oldestSeq <= newestSeq;
+    
+    // 增量同步的前提：同一缓冲区、尺寸不变、新旧内容首尾衔接
+    if (!contiguous || !linked || !indexed || ring != &points ||
+        slotChannel.size() != points.capacity() || channelFirst.size() != channels ||
+        front < oldestSeq || back < newestSeq || front > newestSeq + 1) {
+        rebuild(points, channels);
+        return;
+    }
+    
+    for (uint32_t sequence = oldestSeq; sequence < front; sequence++) {
+        unlink(sequence);
+    }
+    oldestSeq = front;
+    for (uint32_t sequence = newestSeq + 1; sequence <= back; sequence++) {
+        link(at(sequence));
+    }
+    newestSeq = back;
+}
+
+void EventIndex::rebuild(const PointRing& points, uint16_t channels) {
+    ring = &points;
+    // 容量与频点数不变时 assign 不重新分配
+    slotChannel.assign(points.capacity(), CHANNEL_NONE);
+    prevOnChannel.assign(points.capacity(), EVENT_SEQ_NONE);
+    nextOnChannel.assign(points.capacity(), EVENT_SEQ_NONE);
+    channelFirst.assign(channels, EVENT_SEQ_NONE);
+    channelLast.assign(channels, EVENT_SEQ_NONE);
+    channelEvents.assign(channels, 0);
+    
+    if (points.empty()) {
+        oldestSeq = 1;
+        newestSeq = 0;
+        linked = true;
+        return;
+    }
+    
+    oldestSeq = points.front().sequence;
+    newestSeq = points.back().sequence;
+    linked = newestSeq - oldestSeq + 1 == points.size();
+    if (!linked) {
+        // 序号不连续时无法由序号定位槽位：按位置编号（oldestSeq + 下标），只保留按时间扫描
+        newestSeq = oldestSeq + points.size() - 1;
+        return;
+    }
+    
+    for (size_t i = 0; i < points.size(); i++) {
+        link(points[i]);
+    }
+}
+
+void EventIndex::link(const RadarPoint& point) {
+    uint32_t sequence = point.sequence;
+    size_t slot = slotOf(sequence);
+    uint16_t channel = point.channelIndex;
+    slotChannel[slot] = channel;
+    prevOnChannel[slot] = EVENT_SEQ_NONE;
+    nextOnChannel[slot] = EVENT_SEQ_NONE;
+    if (channel >= channelFirst.size()) return;
+    
+    uint32_t last = channelLast[channel];
+    prevOnChannel[slot] = last;
+    if (last != EVENT_SEQ_NONE) {
+        nextOnChannel[slotOf(last)] = sequence;
+    } else {
+        channelFirst[channel] = sequence;
+    }
+    channelLast[channel] = sequence;
+    channelEvents[channel]++;
+}
+
+void EventIndex::unlink(uint32_t sequence) {
+    // 淘汰按序号先进先出，被淘汰的总是其频点链表的头
+    size_t slot = slotOf(sequence);
+    uint16_t channel = slotChannel[slot];
+    slotChannel[slot] = CHANNEL_NONE;
+    if (channel >= channelFirst.size() || channelFirst[channel] != sequence) return;
+    
+    uint32_t next = nextOnChannel[slot];
+    channelFirst[channel] = next;
+    if (next != EVENT_SEQ_NONE) {
+        prevOnChannel[slotOf(next)] = EVENT_SEQ_NONE;
+    } else {
+        channelLast[channel] = EVENT_SEQ_NONE;
+    }
+    channelEvents[channel]--;
+}
+
+uint32_t EventIndex::lowerBound(uint64_t timeUs) const {
+    uint32_t first = oldestSeq;
+    uint32_t count = newestSeq + 1 - oldestSeq;
+    while (count > 0) {
+        uint32_t step = count / 2;
+        uint32_t middle = first + step;
+        if (at(middle).timestampUs() < timeUs) {
+            first = middle + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+EventRange EventIndex::query(const EventQuery& query) const {
+    EventRange range;
+    EventCursor& cursor = range.first;
+    cursor.index = this;
+    cursor.query = query;
+    
+    if (!ring || oldestSeq > newestSeq || query.firstChannel > query.lastChannel ||
+        query.startUs >= query.endUs) {
+        return range;
+    }
+    
+    // 主索引：时间范围 → 序号区间
+    cursor.lo = query.startUs > 0 ? lowerBound(query.startUs) : oldestSeq;
+    cursor.hi = query.endUs == UINT64_MAX ? newestSeq : lowerBound(query.endUs) - 1;
+    if (cursor.lo > cursor.hi) return range;
+    uint32_t scanCost = cursor.hi - cursor.lo + 1;
+    
+    // 倒排表：频点范围窄，且这些频点的事件总数少于时间区间内的记录数时使用
+    uint16_t lastChannel = std::min<uint32_t>(query.lastChannel, channelFirst.size() - 1);
+    if (linked && !channelFirst.empty() && query.firstChannel <= lastChannel &&
+        lastChannel - query.firstChannel < EVENT_QUERY_MAX_PLAN_CHANNELS) {
+        uint32_t postings = 0;
+        uint8_t lanes = 0;
+        bool fits = true;
+        for (uint16_t channel = query.firstChannel; channel <= lastChannel; channel++) {
+            if (channelEvents[channel] == 0) continue;
+            if (lanes == EVENT_QUERY_MAX_LANES) {
+                fits = false;
+                break;
+            }
+            cursor.lanes[lanes++] = query.newestFirst ? channelLast[channel] : channelFirst[channel];
+            postings += channelEvents[channel];
+        }
+    
+        if (fits && postings < scanCost) {
+            cursor.scan = false;
+            cursor.laneCount = lanes;
+            // 各链表起点移到序号区间内
+            for (uint8_t i = 0; i < lanes; i++) {
+                uint32_t& lane = cursor.lanes[i];
+                while (lane != EVENT_SEQ_NONE && (query.newestFirst ? lane > cursor.hi : lane < cursor.lo)) {
+                    size_t slot = slotOf(lane);
+                    lane = query.newestFirst ? prevOnChannel[slot] : nextOnChannel[slot];
+                }
+                if (lane != EVENT_SEQ_NONE && (lane < cursor.lo || lane > cursor.hi)) {
+                    lane = EVENT_SEQ_NONE;
+                }
+            }
+        }
+    }
+    
+    cursor.advance();
+    return range;
+}
+
+uint16_t EventIndex::getChannelEvents(uint16_t channel) const {
+    return channel < channelEvents.size() ? channelEvents[channel] : 0;
+}
+
+size_t EventIndex::getMemoryBytes() const {
+    return slotChannel.size() * (sizeof(uint16_t) + 2 * sizeof(uint32_t)) +
+           channelFirst.size() * (2 * sizeof(uint32_t) + sizeof(uint16_t));
+}
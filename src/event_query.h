@@ -0,0 +1,120 @@
+#ifndef EVENT_QUERY_H
+#define EVENT_QUERY_H
+
+#include "common.h"
+#include "point_ring.h"
+
+// 倒排表路径最多同时归并的频点数；超过时退回按时间范围扫描
+const uint8_t EVENT_QUERY_MAX_LANES = 8;
+// 查询的频点范围不超过该宽度时才考虑倒排表（逐个频点查看计数的开销）
+const uint16_t EVENT_QUERY_MAX_PLAN_CHANNELS = 64;
+// 序号 0 不会被分配，表示空
+const uint32_t EVENT_SEQ_NONE = 0;
+
+// 查询条件：频点 [firstChannel, lastChannel]、时间 [startUs, endUs)、RSSI 不低于 minRssi
+struct EventQuery {
+    uint16_t firstChannel;
+    uint16_t lastChannel;
+    uint64_t startUs;
+    uint64_t endUs;
+    int16_t minRssi;
+    bool newestFirst;       // 结果按时间倒序（事件列表从最新一条开始）
+    
+    EventQuery()
+        : firstChannel(0), lastChannel(CHANNEL_NONE - 1), startUs(0), endUs(UINT64_MAX),
+          minRssi(INT16_MIN), newestFirst(false) {}
+    
+    bool matches(const RadarPoint& point) const {
+        return point.channelIndex >= firstChannel && point.channelIndex <= lastChannel &&
+               point.timestampUs() >= startUs && point.timestampUs() < endUs && point.rssi >= minRssi;
+    }
+};
+
+class EventIndex;
+
+// 查询结果的迭代器：直接引用环形缓冲区中的点，不复制；索引再次同步后失效
+class EventCursor {
+public:
+    const RadarPoint& operator*() const;
+    const RadarPoint* operator->() const { return &**this; }
+    EventCursor& operator++();
+    bool operator!=(const EventCursor& other) const { return current != other.current; }
+    bool operator==(const EventCursor& other) const { return current == other.current; }
+    
+private:
+    friend class EventIndex;
+    friend class EventRange;
+    
+    EventCursor() : index(nullptr), current(EVENT_SEQ_NONE), laneCount(0), lo(0), hi(0), scan(true) {}
+    
+    // 找到下一条满足条件的点，没有时 current 置空
+    void advance();
+    uint32_t nextScan();
+    uint32_t nextLane();
+    
+    const EventIndex* index;
+    EventQuery query;
+    uint32_t current;
+    uint8_t laneCount;
+    uint32_t lanes[EVENT_QUERY_MAX_LANES];  // 各频点倒排表上的下一个序号
+    uint32_t lo;                            // 时间范围对应的序号区间 [lo, hi]
+    uint32_t hi;
+    bool scan;                              // true：按时间顺序扫描区间；false：归并倒排表
+};
+
+class EventRange {
+public:
+    EventCursor begin() const { return first; }
+    EventCursor end() const { return EventCursor(); }
+    
+private:
+    friend class EventIndex;
+    EventCursor first;
+};
+
+// 环形缓冲区上的事件索引
+// 主索引：点按序号写入，序号与时间同序，按时间二分即得序号区间
+// 倒排表：每个频点一条按序号双向链接的链表，随新点写入和旧点淘汰增量维护
+// 查询在两者中选扫描记录较少的一种，只触及落在时间区间内或属于所选频点的记录
+class EventIndex {
+public:
+    EventIndex();
+    
+    // 与缓冲区同步：只处理上次同步后新写入和被淘汰的点；
+    // 缓冲区被清空、容量或频点数变化、序号不连续时重建
+    void sync(const PointRing& points, uint16_t channels);
+    EventRange query(const EventQuery& query) const;
+    
+    // 当前缓冲区中该频点的事件数
+    uint16_t getChannelEvents(uint16_t channel) const;
+    uint16_t getChannelCount() const { return channelFirst.size(); }
+    size_t getMemoryBytes() const;
+    
+private:
+    friend class EventCursor;
+    
+    const PointRing* ring;
+    uint32_t oldestSeq;             // 已索引的序号区间，空时 oldestSeq > newestSeq；
+                                    // 序号不连续时为 oldestSeq + 下标
+    uint32_t newestSeq;
+    bool linked;                    // 倒排表可用（序号连续）
+    
+    // 按 序号 % 容量 存放，与缓冲区槽位一一对应
+    std::vector<uint16_t> slotChannel;
+    std::vector<uint32_t> prevOnChannel;
+    std::vector<uint32_t> nextOnChannel;
+    // 按频点索引
+    std::vector<uint32_t> channelFirst;
+    std::vector<uint32_t> channelLast;
+    std::vector<uint16_t> channelEvents;
+    
+    void rebuild(const PointRing& points, uint16_t channels);
+    void link(const RadarPoint& point);
+    void unlink(uint32_t sequence);
+    size_t slotOf(uint32_t sequence) const { return sequence % slotChannel.size(); }
+    const RadarPoint& at(uint32_t sequence) const { return (*ring)[sequence - oldestSeq]; }
+    // 时间不早于 timeUs 的第一条记录的序号（可能为 newestSeq + 1）
+    uint32_t lowerBound(uint64_t timeUs) const;
+};
+
+#endif // EVENT_QUERY_H
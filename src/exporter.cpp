@@ -0,0 +1,98 @@
+#include "exporter.h"
+#include "scanner.h"
+#include "event_query.h"
+
+void exportChannelCsv(const FrequencyListener& listener, Print& out) {
+    out.println("index,frequency_hz,rx_done,rssi_p10,rssi_p50,rssi_p90,rssi_p99,sources,protocols");
+    
+    uint16_t exported = 0;
+    for (uint16_t i = 0; i < listener.getFrequencyCount(); i++) {
+        const RssiQuantileSketch* sketch = listener.getChannelQuantiles(i);
+        if (!sketch || sketch->empty()) continue;
+        
+        String protocols;
+        uint8_t mask = listener.getChannelProtocols(i);
+        for (uint8_t p = PROTO_LORAWAN; p < PROTO_COUNT; p++) {
+            if (mask & (1 << p)) {
+                if (protocols.length() > 0) protocols += "|";
+                protocols += protocolShortName(p);
+            }
+        }
+        
+        out.printf("%u,%lu,%lu,%d,%d,%d,%d,%lu,%s\n",
+            i, listener.getFrequencyAt(i), sketch->getCount(),
+            sketch->quantile(0.10f), sketch->quantile(0.50f),
+            sketch->quantile(0.90f), sketch->quantile(0.99f),
+            listener.getDistinctSources(i), protocols.c_str());
+        exported++;
+    }
+    
+    USBSerial.printf("[Export] %u channels\n", exported);
+}
+
+void exportSweepCsv(const FrequencyListener& listener, Print& out) {
+    const std::vector<DataRate>& rates = listener.getDataRates();
+    if (rates.size() < 2) return;
+    
+    out.println("index,frequency_hz,sf,bw_khz,windows,rx_done,rx_error,max_rssi");
+    
+    uint32_t exported = 0;
+    for (uint16_t i = 0; i < listener.getFrequencyCount(); i++) {
+        for (uint8_t r = 0; r < rates.size(); r++) {
+            const SweepCellStats* cell = listener.getSweepCell(i, r);
+            if (!cell || cell->windows == 0) continue;
+            
+            out.printf("%u,%lu,%u,%u,%u,%u,%u,%d\n",
+                i, listener.getFrequencyAt(i), rates[r].spreadingFactor, rates[r].bandwidth,
+                cell->windows, cell->rxDone, cell->rxError, cell->maxRssi);
+            exported++;
+        }
+    }
+    
+    USBSerial.printf("[Export] %lu sweep cells\n", exported);
+}
+
+void exportOccupancyCsv(const FrequencyListener& listener, Print& out) {
+    const OccupancyHeatmap& occupancy = listener.getOccupancy();
+    
+    out.print("index,frequency_hz");
+    for (uint8_t hour = 0; hour < OCCUPANCY_HOURS; hour++) {
+        out.printf(",h%02u", hour);
+    }
+    out.println();
+    
+    uint16_t exported = 0;
+    for (uint16_t i = 0; i < occupancy.getChannelCount(); i++) {
+        bool any = false;
+        for (uint8_t hour = 0; hour < OCCUPANCY_HOURS && !any; hour++) {
+            any = occupancy.get(i, hour) > 0;
+        }
+        if (!any) continue;
+        
+        out.printf("%u,%lu", i, listener.getFrequencyAt(i));
+        for (uint8_t hour = 0; hour < OCCUPANCY_HOURS; hour++) {
+            out.printf(",%u", occupancy.get(i, hour));
+        }
+        out.println();
+        exported++;
+    }
+    
+    USBSerial.printf("[Export] %u occupancy rows (local hours%s)\n", exported,
+        occupancy.isClockSet() ? "" : ", clock not set, counting paused");
+}
+
+void exportEventsCsv(const EventIndex& index, const EventQuery& query, Print& out) {
+    out.println("sequence,time_us,frequency_hz,channel,rssi,snr,length,type,protocol");
+    
+    uint32_t exported = 0;
+    for (const RadarPoint& point : index.query(query)) {
+        out.printf("%lu,%llu,%lu,%u,%d,%d,%u,%s,%s\n",
+            point.sequence, point.timestampUs(), point.frequency, point.channelIndex,
+            point.rssi, point.snr, point.packetLength,
+            point.eventType == EVENT_RX_DONE ? "rx" : "crc",
+            point.eventType == EVENT_RX_DONE ? protocolShortName(point.protocol) : "");
+        exported++;
+    }
+    
+    USBSerial.printf("[Export] %lu events\n", exported);
+}
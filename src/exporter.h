@@ -0,0 +1,19 @@
+#ifndef EXPORTER_H
+#define EXPORTER_H
+
+#include <Arduino.h>
+
+class FrequencyListener;
+class EventIndex;
+struct EventQuery;
+
+// 按频点导出 CSV（仅输出有事件的频点），用于串口抓取后离线分析
+void exportChannelCsv(const FrequencyListener& listener, Print& out);
+// 按 (频点, SF, BW) 单元导出 CSV（仅在启用速率轮换时有数据）
+void exportSweepCsv(const FrequencyListener& listener, Print& out);
+// 按频点导出 24 小时占用计数 CSV（仅输出有计数的频点）
+void exportOccupancyCsv(const FrequencyListener& listener, Print& out);
+// 导出符合查询条件的事件 CSV（当前快照中的雷达点，按时间顺序）
+void exportEventsCsv(const EventIndex& index, const EventQuery& query, Print& out);
+
+#endif // EXPORTER_H
@@ -0,0 +1,128 @@
+#include "fingerprint.h"
+#include <math.h>
+
+uint32_t fingerprintPayload(const uint8_t* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t sourceKeyFromPayload(const uint8_t* data, size_t length, uint8_t protocol) {
+    size_t offset = 0;
+    if (length >= MESHTASTIC_SENDER_OFFSET + SOURCE_KEY_PREFIX_BYTES) {
+        uint32_t dest = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+        bool broadcast = dest == MESHTASTIC_BROADCAST;
+        if (protocol == PROTO_MESHTASTIC || broadcast) {
+            offset = MESHTASTIC_SENDER_OFFSET;
+        }
+    }
+    
+    size_t keyLength = length - offset;
+    return fingerprintPayload(data + offset, keyLength < SOURCE_KEY_PREFIX_BYTES ? keyLength : SOURCE_KEY_PREFIX_BYTES);
+}
+
+// murmur3 末尾混合，使 FNV 结果的各位分布均匀后再送入 HLL
+static uint32_t mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+DuplicateFilter::DuplicateFilter() {
+    clear();
+}
+
+bool DuplicateFilter::check(uint32_t fingerprint, uint32_t nowMs) {
+    for (uint8_t i = 0; i < used; i++) {
+        if (entries[i].fingerprint != fingerprint) continue;
+        
+        // 只比较首次出现的时间，不随命中滑动
+        if (nowMs - entries[i].timeMs <= DUPLICATE_WINDOW_MS) {
+            return true;
+        }
+        // 窗口已过：本次作为新的首次出现
+        entries[i].timeMs = nowMs;
+        return false;
+    }
+    
+    entries[next].fingerprint = fingerprint;
+    entries[next].timeMs = nowMs;
+    next = (next + 1) % TABLE_SIZE;
+    if (used < TABLE_SIZE) used++;
+    
+    return false;
+}
+
+void DuplicateFilter::clear() {
+    memset(entries, 0, sizeof(entries));
+    next = 0;
+    used = 0;
+}
+
+HyperLogLog::HyperLogLog() {
+    clear();
+}
+
+uint8_t HyperLogLog::getRegister(uint8_t index) const {
+    uint8_t byte = registers[index >> 1];
+    return (index & 1) ? (byte >> 4) : (byte & 0x0F);
+}
+
+void HyperLogLog::setRegister(uint8_t index, uint8_t value) {
+    uint8_t& byte = registers[index >> 1];
+    if (index & 1) {
+        byte = (byte & 0x0F) | (value << 4);
+    } else {
+        byte = (byte & 0xF0) | value;
+    }
+}
+
+void HyperLogLog::add(uint32_t key) {
+    uint32_t hash = mix32(key);
+    uint8_t index = hash >> (32 - PRECISION);
+    uint32_t rest = hash << PRECISION;
+    
+    // 剩余位中第一个 1 的位置 (从 1 开始)
+    uint8_t rank = 1;
+    while (rank <= 32 - PRECISION && !(rest & 0x80000000u)) {
+        rest <<= 1;
+        rank++;
+    }
+    if (rank > 15) rank = 15;
+    
+    if (rank > getRegister(index)) {
+        setRegister(index, rank);
+    }
+}
+
+uint32_t HyperLogLog::estimate() const {
+    float sum = 0;
+    uint8_t zeros = 0;
+    
+    for (uint8_t i = 0; i < NUM_REGISTERS; i++) {
+        uint8_t value = getRegister(i);
+        sum += 1.0f / (float)(1UL << value);
+        if (value == 0) zeros++;
+    }
+    
+    const float m = NUM_REGISTERS;
+    const float alpha = 0.709f;  // m = 64
+    float estimate = alpha * m * m / sum;
+    
+    // 小基数时改用线性计数
+    if (estimate <= 2.5f * m && zeros > 0) {
+        estimate = m * logf(m / zeros);
+    }
+    
+    return (uint32_t)(estimate + 0.5f);
+}
+
+void HyperLogLog::clear() {
+    memset(registers, 0, sizeof(registers));
+}
@@ -0,0 +1,64 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <Arduino.h>
+#include "common.h"
+
+// 重复包判定窗口 (ms)：窗口内相同指纹的包视为重传/转发
+const uint32_t DUPLICATE_WINDOW_MS = 5000;
+// 用作发送方键的负载前缀长度（协议未识别时的近似）
+const uint8_t SOURCE_KEY_PREFIX_BYTES = 4;
+// Meshtastic 包头 dest(4) sender(4)：前 4 字节是目的地址（广播为 0xFFFFFFFF），发送方在其后
+const uint8_t MESHTASTIC_SENDER_OFFSET = 4;
+const uint32_t MESHTASTIC_BROADCAST = 0xFFFFFFFF;
+
+// 负载指纹 (FNV-1a 32 位)，在接收路径上每包计算一次
+uint32_t fingerprintPayload(const uint8_t* data, size_t length);
+// 发送方键：帧头中发送方地址的指纹，多数协议在帧头开头携带地址；
+// Meshtastic（或以广播地址开头的帧）取目的地址之后的发送方字段
+uint32_t sourceKeyFromPayload(const uint8_t* data, size_t length, uint8_t protocol);
+
+// 短窗口重复包过滤：固定大小的最近指纹表
+class DuplicateFilter {
+public:
+    static const uint8_t TABLE_SIZE = 32;
+    
+    DuplicateFilter();
+    
+    // 返回 true 表示距该指纹首次出现不超过窗口；窗口从首次出现起算，
+    // 重复命中不延长窗口，持续重复的帧每个窗口放行一次
+    bool check(uint32_t fingerprint, uint32_t nowMs);
+    void clear();
+    
+private:
+    struct Entry {
+        uint32_t fingerprint;
+        uint32_t timeMs;
+    };
+    
+    Entry entries[TABLE_SIZE];
+    uint8_t next;
+    uint8_t used;
+};
+
+// HyperLogLog 基数估计：64 个 4 位寄存器共 32 字节，标准误差约 13%
+// 寄存器上限 15，对 LoRa 信道上的发送方数量级足够
+class HyperLogLog {
+public:
+    static const uint8_t PRECISION = 6;
+    static const uint8_t NUM_REGISTERS = 1 << PRECISION;
+    
+    HyperLogLog();
+    
+    void add(uint32_t key);
+    uint32_t estimate() const;
+    void clear();
+    
+private:
+    uint8_t registers[NUM_REGISTERS / 2];
+    
+    uint8_t getRegister(uint8_t index) const;
+    void setRegister(uint8_t index, uint8_t value);
+};
+
+#endif // FINGERPRINT_H
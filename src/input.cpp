@@ -0,0 +1,133 @@
+#include "input.h"
+#include <M5Cardputer.h>
+
+InputService::InputService()
+    : taskHandle(nullptr), eventQueue(nullptr), heldCount(0),
+      batteryPct(100), lastBatterySampleMs(0), droppedEvents(0) {
+}
+
+InputService::~InputService() {
+    if (taskHandle) {
+        vTaskDelete(taskHandle);
+    }
+    if (eventQueue) {
+        vQueueDelete(eventQueue);
+    }
+}
+
+bool InputService::begin() {
+    if (taskHandle) return true;
+    
+    eventQueue = xQueueCreate(INPUT_QUEUE_LENGTH, sizeof(InputEvent));
+    if (!eventQueue) {
+        USBSerial.println("[Input] Failed to create event queue");
+        return false;
+    }
+    
+    sampleBattery(millis());
+    
+    if (xTaskCreate(taskEntry, "InputTask", 3072, this, 1, &taskHandle) != pdPASS) {
+        USBSerial.println("[Input] Failed to create input task");
+        taskHandle = nullptr;
+        return false;
+    }
+    
+    return true;
+}
+
+void InputService::taskEntry(void* pvParameters) {
+    static_cast<InputService*>(pvParameters)->scanTask();
+}
+
+void InputService::scanTask() {
+    TickType_t lastWake = xTaskGetTickCount();
+    
+    while (true) {
+        uint32_t now = millis();
+        scanKeyboard(now);
+        
+        if (now - lastBatterySampleMs >= BATTERY_SAMPLE_MS) {
+            sampleBattery(now);
+        }
+        
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(INPUT_SCAN_MS));
+    }
+}
+
+void InputService::scanKeyboard(uint32_t nowMs) {
+    // 只扫描键盘矩阵，不调用 M5Cardputer.update()，避免与主任务争用其他外设
+    M5Cardputer.Keyboard.updateKeyList();
+    M5Cardputer.Keyboard.updateKeysState();
+    auto keys = M5Cardputer.Keyboard.keysState();
+    
+    // 松开：之前按住、本次不在列表中的键
+    for (uint8_t i = 0; i < heldCount; ) {
+        bool stillDown = false;
+        for (auto key : keys.word) {
+            if (key == held[i].key) {
+                stillDown = true;
+                break;
+            }
+        }
+        
+        if (stillDown) {
+            i++;
+            continue;
+        }
+        
+        post(held[i].key, INPUT_RELEASE, nowMs);
+        held[i] = held[--heldCount];
+    }
+    
+    // 按下与长按重复
+    for (auto key : keys.word) {
+        HeldKey* entry = nullptr;
+        for (uint8_t i = 0; i < heldCount; i++) {
+            if (held[i].key == key) {
+                entry = &held[i];
+                break;
+            }
+        }
+        
+        if (!entry) {
+            if (heldCount == INPUT_MAX_HELD_KEYS) continue;
+            
+            entry = &held[heldCount++];
+            entry->key = key;
+            entry->pressedMs = nowMs;
+            entry->lastRepeatMs = nowMs;
+            post(key, INPUT_PRESS, nowMs);
+        } else if (nowMs - entry->pressedMs >= KEY_REPEAT_DELAY_MS &&
+                   nowMs - entry->lastRepeatMs >= KEY_REPEAT_INTERVAL_MS) {
+            entry->lastRepeatMs = nowMs;
+            post(key, INPUT_REPEAT, nowMs);
+        }
+    }
+}
+
+void InputService::sampleBattery(uint32_t nowMs) {
+    int32_t level = M5Cardputer.Power.getBatteryLevel();
+    if (level >= 0 && level <= 100) {
+        batteryPct = level;
+    }
+    lastBatterySampleMs = nowMs;
+}
+
+void InputService::post(char key, InputEventType type, uint32_t nowMs) {
+    InputEvent event;
+    event.key = key;
+    event.type = type;
+    event.timeMs = nowMs;
+    
+    if (xQueueSend(eventQueue, &event, 0) != pdTRUE) {
+        droppedEvents++;
+    }
+}
+
+bool InputService::waitEvent(InputEvent* event, uint32_t timeoutMs) {
+    if (!eventQueue) {
+        delay(timeoutMs);
+        return false;
+    }
+    return xQueueReceive(eventQueue, event, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
@@ -0,0 +1,69 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "common.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+
+// 键盘扫描间隔与长按参数 (ms)
+const uint32_t INPUT_SCAN_MS = 10;
+const uint32_t KEY_REPEAT_DELAY_MS = 500;
+const uint32_t KEY_REPEAT_INTERVAL_MS = 100;
+// 电量变化缓慢，低频采样后缓存
+const uint32_t BATTERY_SAMPLE_MS = 30000;
+
+const uint8_t INPUT_QUEUE_LENGTH = 16;
+const uint8_t INPUT_MAX_HELD_KEYS = 6;
+
+enum InputEventType : uint8_t {
+    INPUT_PRESS,
+    INPUT_REPEAT,    // 按住超过 KEY_REPEAT_DELAY_MS 后每 KEY_REPEAT_INTERVAL_MS 一次
+    INPUT_RELEASE
+};
+
+struct InputEvent {
+    char key;
+    InputEventType type;
+    uint32_t timeMs;
+};
+
+// 输入与传感器服务：独立任务扫描键盘，把按下/重复/松开事件放入队列，
+// 主循环阻塞在 waitEvent() 上，只在有输入或到达下一个定时点时醒来
+class InputService {
+private:
+    TaskHandle_t taskHandle;
+    QueueHandle_t eventQueue;
+    
+    struct HeldKey {
+        char key;
+        uint32_t pressedMs;
+        uint32_t lastRepeatMs;
+    };
+    HeldKey held[INPUT_MAX_HELD_KEYS];
+    uint8_t heldCount;
+    
+    volatile uint8_t batteryPct;
+    uint32_t lastBatterySampleMs;
+    volatile uint32_t droppedEvents;
+    
+    static void taskEntry(void* pvParameters);
+    void scanTask();
+    void scanKeyboard(uint32_t nowMs);
+    void sampleBattery(uint32_t nowMs);
+    void post(char key, InputEventType type, uint32_t nowMs);
+    
+public:
+    InputService();
+    ~InputService();
+    
+    bool begin();
+    
+    // 等待下一个输入事件，超时返回 false
+    bool waitEvent(InputEvent* event, uint32_t timeoutMs);
+    
+    uint8_t getBatteryPct() const { return batteryPct; }
+    uint32_t getDroppedEvents() const { return droppedEvents; }
+};
+
+#endif // INPUT_H
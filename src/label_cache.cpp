@@ -0,0 +1,130 @@
+#include "label_cache.h"
+
+// 空槽位的键（频率为 0 的标签不会出现）
+static const uint32_t LABEL_KEY_NONE = 0;
+
+static String formatFrequency(uint32_t freqHz, LabelFormat format) {
+    switch (format) {
+        case LABEL_MHZ_UNIT:
+            return String(freqHz / 1000000.0, 2) + " MHz";
+        case LABEL_MHZ_2:
+            return String(freqHz / 1000000.0, 2);
+        default:
+            return String(freqHz / 1000000.0, 1);
+    }
+}
+
+LabelCache::LabelCache() : useClock(0), hits(0), misses(0) {
+    for (uint8_t i = 0; i < LABEL_CACHE_SLOTS; i++) {
+        slots[i].key = LABEL_KEY_NONE;
+        slots[i].sprite = nullptr;
+        slots[i].width = 0;
+        slots[i].height = 0;
+        slots[i].lastUse = 0;
+    }
+}
+
+LabelCache::~LabelCache() {
+    for (uint8_t i = 0; i < LABEL_CACHE_SLOTS; i++) {
+        delete slots[i].sprite;
+    }
+}
+
+void LabelCache::clear() {
+    // 位图保留，只作废内容
+    for (uint8_t i = 0; i < LABEL_CACHE_SLOTS; i++) {
+        slots[i].key = LABEL_KEY_NONE;
+        slots[i].lastUse = 0;
+    }
+}
+
+void LabelCache::drawFrequency(M5Canvas* dst, uint32_t freqHz, LabelFormat format,
+                               int x, int y, uint8_t datum, uint16_t color) {
+    uint32_t key = (freqHz / 1000) * LABEL_FORMAT_COUNT + format + 1;
+    Slot* slot = lookup(dst, key, formatFrequency(freqHz, format));
+    if (slot) {
+        blit(dst, *slot, x, y, datum, color);
+    } else {
+        // 精灵分配失败时退回直接绘制
+        dst->setTextColor(color);
+        dst->setTextDatum(datum);
+        dst->drawString(formatFrequency(freqHz, format), x, y);
+    }
+}
+
+LabelCache::Slot* LabelCache::lookup(M5Canvas* dst, uint32_t key, const String& text) {
+    useClock++;
+    
+    Slot* victim = &slots[0];
+    for (uint8_t i = 0; i < LABEL_CACHE_SLOTS; i++) {
+        if (slots[i].key == key) {
+            slots[i].lastUse = useClock;
+            hits++;
+            return &slots[i];
+        }
+        if (slots[i].lastUse < victim->lastUse) {
+            victim = &slots[i];
+        }
+    }
+    
+    misses++;
+    // 与目标画布相同字体下的尺寸
+    uint16_t width = dst->textWidth(text);
+    uint16_t height = dst->fontHeight();
+    if (width == 0 || width > LABEL_MAX_WIDTH) {
+        return nullptr;
+    }
+    
+    if (!victim->sprite || victim->height != height) {
+        // 1 位精灵：调色板 0 为透明底色，1 为文字
+        if (!victim->sprite) {
+            victim->sprite = new M5Canvas(dst);
+        }
+        victim->sprite->deleteSprite();
+        victim->sprite->setColorDepth(1);
+        if (!victim->sprite->createSprite(LABEL_MAX_WIDTH, height)) {
+            victim->key = LABEL_KEY_NONE;
+            victim->height = 0;
+            return nullptr;
+        }
+        victim->sprite->createPalette();
+    }
+    
+    victim->sprite->fillSprite(0);
+    victim->sprite->setTextColor(1);
+    victim->sprite->setTextDatum(top_left);
+    victim->sprite->drawString(text, 0, 0);
+    
+    victim->key = key;
+    victim->width = width;
+    victim->height = height;
+    victim->lastUse = useClock;
+    return victim;
+}
+
+void LabelCache::blit(M5Canvas* dst, const Slot& slot, int x, int y, uint8_t datum, uint16_t color) {
+    // 与 drawString 的对齐方式一致（按文字宽度，位图右侧多余部分透明）
+    switch (datum) {
+        case top_center: case middle_center: case bottom_center:
+            x -= slot.width / 2;
+            break;
+        case top_right: case middle_right: case bottom_right:
+            x -= slot.width;
+            break;
+        default:
+            break;
+    }
+    switch (datum) {
+        case middle_left: case middle_center: case middle_right:
+            y -= slot.height / 2;
+            break;
+        case bottom_left: case bottom_center: case bottom_right:
+            y -= slot.height;
+            break;
+        default:
+            break;
+    }
+    
+    slot.sprite->setPaletteColor(1, color);
+    slot.sprite->pushSprite(dst, x, y, 0);
+}
@@ -0,0 +1,53 @@
+#ifndef LABEL_CACHE_H
+#define LABEL_CACHE_H
+
+#include <Arduino.h>
+#include <M5Cardputer.h>
+
+// 缓存的文字标签数，按最近使用淘汰（雷达视图每帧最多显示一屏的频点标签）
+const uint8_t LABEL_CACHE_SLOTS = 64;
+// 每个槽位的 1 位位图固定为 64x8 像素（64 字节），分配一次后重复使用；更宽的文字直接绘制
+const uint16_t LABEL_MAX_WIDTH = 64;
+
+// 频率标签的格式，与频率一起组成缓存键
+enum LabelFormat {
+    LABEL_MHZ_UNIT,     // "433.12 MHz"
+    LABEL_MHZ_2,        // "433.12"
+    LABEL_MHZ_1,        // "433.1"
+    LABEL_FORMAT_COUNT
+};
+
+// 预渲染文字缓存：首次绘制时把文字渲染成 1 位位图精灵，
+// 之后按调色板着色直接贴到目标画布，不再逐字形光栅化
+class LabelCache {
+public:
+    LabelCache();
+    ~LabelCache();
+    
+    // 频率标签：键为 (kHz, 格式)，频点计划按 kHz 对齐
+    void drawFrequency(M5Canvas* dst, uint32_t freqHz, LabelFormat format,
+                       int x, int y, uint8_t datum, uint16_t color);
+    void clear();
+    
+    uint32_t getHits() const { return hits; }
+    uint32_t getMisses() const { return misses; }
+    
+private:
+    struct Slot {
+        uint32_t key;
+        M5Canvas* sprite;
+        uint16_t width;
+        uint16_t height;
+        uint32_t lastUse;
+    };
+    
+    Slot slots[LABEL_CACHE_SLOTS];
+    uint32_t useClock;
+    uint32_t hits;
+    uint32_t misses;
+    
+    Slot* lookup(M5Canvas* dst, uint32_t key, const String& text);
+    void blit(M5Canvas* dst, const Slot& slot, int x, int y, uint8_t datum, uint16_t color);
+};
+
+#endif // LABEL_CACHE_H
@@ -1,12 +1,156 @@
 #include "lora_adapter.h"
 #include <M5_LoRa_E220.h>
 #include <M5Cardputer.h>
+#include <Preferences.h>
+#include "config.h"
+#include "metrics.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+// NVS 中保存的 E220 配置（上次成功写入模块的值）
+static const char* E220_NVS_NAMESPACE = "lorascope";
+static const char* E220_NVS_KEY = "e220_cfg";
+static const uint8_t E220_NVS_VERSION = 2;
+// 切换工作模式后等待模块就绪的时间（AUX 变高之后，或未连接 AUX 时的固定等待）
+static const uint32_t E220_SETTLE_MS = 20;
+// 等待 AUX 变高的上限
+static const uint32_t E220_AUX_TIMEOUT_MS = 1000;
+
+struct PersistedE220Config {
+    uint8_t version;
+    uint8_t channelCurrent;     // 0：之后只换过频道，item.own_channel 已过期
+    LoRaConfigItem_t item;
+};
+
+static bool e220ConfigEquals(const LoRaConfigItem_t& a, const LoRaConfigItem_t& b) {
+    return a.own_address == b.own_address &&
+           a.baud_rate == b.baud_rate &&
+           a.air_data_rate == b.air_data_rate &&
+           a.subpacket_size == b.subpacket_size &&
+           a.rssi_ambient_noise_flag == b.rssi_ambient_noise_flag &&
+           a.transmitting_power == b.transmitting_power &&
+           a.own_channel == b.own_channel &&
+           a.rssi_byte_flag == b.rssi_byte_flag &&
+           a.transmission_method_type == b.transmission_method_type &&
+           a.lbt_flag == b.lbt_flag &&
+           a.wor_cycle == b.wor_cycle &&
+           a.encryption_key == b.encryption_key &&
+           a.target_address == b.target_address &&
+           a.target_channel == b.target_channel;
+}
+
+// 除频道外其余配置相同
+static bool e220ConfigEqualsExceptChannel(const LoRaConfigItem_t& a, const LoRaConfigItem_t& b) {
+    LoRaConfigItem_t other = b;
+    other.own_channel = a.own_channel;
+    return e220ConfigEquals(a, other);
+}
+
+static uint8_t e220DataRateForBandwidth(uint16_t bandwidth) {
+    switch (bandwidth) {
+        case 125:
+            return DATA_RATE_2_4Kbps;
+        case 250:
+            return DATA_RATE_9_6Kbps;
+        case 500:
+            return DATA_RATE_19_2Kbps;
+        default:
+            return DATA_RATE_2_4Kbps;
+    }
+}
+
+// E220 只有 air_data_rate（REG0 位 [2:0]）一个参数，对应固定的 (SF, BW) 组合，见模块手册
+struct E220DataRate {
+    uint8_t spreadingFactor;
+    uint16_t bandwidth;
+    uint8_t airDataRate;
+};
+
+static const E220DataRate E220_DATA_RATES[] = {
+    {9, 125, 0b010},    // 2.4 kbps
+    {8, 125, 0b011},    // 4.8 kbps
+    {7, 125, 0b100},    // 9.6 kbps
+    {8, 500, 0b101},    // 19.2 kbps
+    {7, 500, 0b110},    // 38.4 kbps
+    {5, 500, 0b111},    // 62.5 kbps
+};
+
+static bool e220LookupDataRate(uint8_t sf, uint16_t bandwidth, uint8_t* airDataRate) {
+    for (const auto& rate : E220_DATA_RATES) {
+        if (rate.spreadingFactor == sf && rate.bandwidth == bandwidth) {
+            *airDataRate = rate.airDataRate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 表中没有的组合沿用原有映射：按扩频因子，其次按带宽
+static uint8_t e220DataRateFor(uint8_t sf, uint16_t bandwidth) {
+    uint8_t airDataRate;
+    if (e220LookupDataRate(sf, bandwidth, &airDataRate)) {
+        return airDataRate;
+    }
+    if (sf >= 7 && sf <= 12) {
+        return sf - 7;
+    }
+    return e220DataRateForBandwidth(bandwidth);
+}
+
+// E220 工作模式串口波特率对应的寄存器值，配置模式固定为 9600
+static const uint32_t E220_CONFIG_BAUD = 9600;
+
+static uint8_t e220BaudCode(uint32_t baud) {
+    switch (baud) {
+        case 1200: return BAUD_1200;
+        case 2400: return BAUD_2400;
+        case 4800: return BAUD_4800;
+        case 19200: return BAUD_19200;
+        case 38400: return BAUD_38400;
+        case 57600: return BAUD_57600;
+        case 115200: return BAUD_115200;
+        default: return BAUD_9600;
+    }
+}
+
+// 通用实现：只下发与上次不同的项，各模块可覆盖为一次性写入
+bool LoRaAdapter::applySettings(const FrequencyConfig& cfg) {
+    bool ok = true;
+    if (!appliedValid || cfg.frequency != applied.frequency) {
+        ok = setFrequency(cfg.frequency) && ok;
+    }
+    if (!appliedValid || cfg.bandwidth != applied.bandwidth) {
+        ok = setBandwidth(cfg.bandwidth) && ok;
+    }
+    if (!appliedValid || cfg.spreadingFactor != applied.spreadingFactor) {
+        ok = setSpreadingFactor(cfg.spreadingFactor) && ok;
+    }
+    if (!appliedValid || cfg.codingRate != applied.codingRate) {
+        ok = setCodingRate(cfg.codingRate) && ok;
+    }
+    
+    applied = cfg;
+    appliedValid = ok;
+    return ok;
+}
+
+int LoRaAdapter::readFrame(FrameView* view) {
+    int result = receiveFrame(&scratchFrame);
+    if (result == 0) {
+        view->data = scratchFrame.recv_data;
+        view->length = scratchFrame.recv_data_len;
+        view->rssi = scratchFrame.rssi;
+    }
+    return result;
+}
+
 // E220 适配器实现
 E220Adapter::E220Adapter(LoRa_E220* loraModule, LoRaModuleType type)
-    : lora(loraModule), moduleType(type), initialized(false) {
+    : lora(loraModule), _serial(nullptr), moduleType(type), initialized(false),
+      currentSf(9), currentBandwidth(125), uartBaud(E220_CONFIG_BAUD),
+      activeConfigValid(false), storedValid(false), storedChannelCurrent(false) {
+    memset(&activeConfig, 0, sizeof(activeConfig));
+    memset(&storedConfig, 0, sizeof(storedConfig));
 }
 
 bool E220Adapter::init() {
@@ -15,170 +159,326 @@ bool E220Adapter::init() {
     USBSerial.println("[E220] Initializing LoRa_E220...");
     
     USBSerial.println("[E220] Calling Init()...");
-    lora->Init(&Serial2, 9600, SERIAL_8N1, 1, 2);
+    lora->Init(&Serial2, E220_CONFIG_BAUD, SERIAL_8N1, LORA_E220_RX_PIN, LORA_E220_TX_PIN);
     _serial = &Serial2;
+    attachReceiveCallback();
+    // 接收 FIFO 或环形缓冲区溢出时已有字节丢失，计入指标
+    _serial->onReceiveError([](hardwareSerial_error_t error) {
+        if (error == UART_FIFO_OVF_ERROR || error == UART_BUFFER_FULL_ERROR) {
+            Metrics::increment(METRIC_UART_OVERRUNS);
+        }
+    });
     USBSerial.println("[E220] Init() completed");
     
-    USBSerial.println("[E220] Setting default config...");
-    LoRaConfigItem_t config;
-    lora->SetDefaultConfigValue(config);
-    USBSerial.println("[E220] Default config set");
+#if LORA_E220_M0_PIN >= 0 && LORA_E220_M1_PIN >= 0
+    // M0/M1 由主机控制时，上电置为正常工作模式 (M0=0, M1=0)
+    pinMode(LORA_E220_M0_PIN, OUTPUT);
+    pinMode(LORA_E220_M1_PIN, OUTPUT);
+    digitalWrite(LORA_E220_M0_PIN, LOW);
+    digitalWrite(LORA_E220_M1_PIN, LOW);
+#endif
+#if LORA_E220_AUX_PIN >= 0
+    pinMode(LORA_E220_AUX_PIN, INPUT_PULLUP);
+#endif
     
-    USBSerial.println("[E220] Calling InitLoRaSetting()...");
-    int result = lora->InitLoRaSetting(config);
-    USBSerial.println("[E220] InitLoRaSetting() returned: " + String(result));
+    // 模块自身会掉电保存配置，这里只加载上次写入的值作为影子配置，
+    // 真正的写入推迟到 applySettings()，且只在与目标配置不同时才发生
+    if (loadPersistedConfig()) {
+        if (activeConfigValid) {
+            USBSerial.printf("[E220] Restored applied config from NVS (channel %d)\n", activeConfig.own_channel);
+        } else {
+            USBSerial.println("[E220] Stored config has a stale channel, module will be written on first apply");
+        }
+        // 模块掉电保存了波特率，上电后即以该速率工作
+        if (activeConfig.baud_rate == e220BaudCode(LORA_E220_UART_BAUD)) {
+            setHostBaud(LORA_E220_UART_BAUD);
+        }
+    } else {
+        USBSerial.println("[E220] No stored config, module will be written on first apply");
+    }
     
     initialized = true;
     USBSerial.println("[E220] Initialization complete");
     return true;
 }
 
-bool E220Adapter::setFrequency(uint32_t freqHz) {
-    if (!initialized) return false;
+bool E220Adapter::loadPersistedConfig() {
+    Preferences prefs;
+    if (!prefs.begin(E220_NVS_NAMESPACE, true)) {
+        return false;
+    }
     
-    USBSerial.println("[E220] Setting frequency: " + String(freqHz) + " Hz");
+    PersistedE220Config stored;
+    memset(&stored, 0, sizeof(stored));
+    bool ok = prefs.getBytesLength(E220_NVS_KEY) == sizeof(stored) &&
+              prefs.getBytes(E220_NVS_KEY, &stored, sizeof(stored)) == sizeof(stored) &&
+              stored.version == E220_NVS_VERSION;
+    prefs.end();
+    
+    if (ok) {
+        storedConfig = stored.item;
+        storedValid = true;
+        storedChannelCurrent = stored.channelCurrent != 0;
+        // 频道已过期时模块实际所在频道未知，首次应用必须写入
+        activeConfig = stored.item;
+        activeConfigValid = storedChannelCurrent;
+    }
+    return ok;
+}
+
+void E220Adapter::persistConfig(bool channelCurrent) {
+    Preferences prefs;
+    if (!prefs.begin(E220_NVS_NAMESPACE, false)) {
+        USBSerial.println("[E220] Failed to open NVS, config not persisted");
+        return;
+    }
     
-    // 使用默认配置
-    LoRaConfigItem_t config;
-    lora->SetDefaultConfigValue(config);
+    PersistedE220Config stored;
+    memset(&stored, 0, sizeof(stored));
+    stored.version = E220_NVS_VERSION;
+    stored.channelCurrent = channelCurrent ? 1 : 0;
+    stored.item = activeConfig;
+    prefs.putBytes(E220_NVS_KEY, &stored, sizeof(stored));
+    prefs.end();
     
-    uint16_t channel = 0;
-    if (moduleType == LORA_E220_433) {
-        channel = (freqHz - 410125000) / 100000;
-        // 确保通道值在有效范围内（0-255）
-        if (channel > 255) {
-            channel = 255;
+    storedConfig = activeConfig;
+    storedValid = true;
+    storedChannelCurrent = channelCurrent;
+}
+
+void E220Adapter::flushSettings() {
+    if (!activeConfigValid) return;
+    if (storedValid && storedChannelCurrent && e220ConfigEquals(activeConfig, storedConfig)) return;
+    
+    persistConfig(true);
+    USBSerial.printf("[E220] Persisted config (channel %d)\n", activeConfig.own_channel);
+}
+
+bool E220Adapter::applyConfig(LoRaConfigItem_t& config) {
+    // 接收解析依赖帧尾的 RSSI 字节；波特率由构建配置决定
+    config.rssi_byte_flag = RSSI_BYTE_ENABLE;
+    config.baud_rate = e220BaudCode(LORA_E220_UART_BAUD);
+    
+    if (activeConfigValid && e220ConfigEquals(config, activeConfig)) {
+        return true;
+    }
+    
+    // 配置应答由库在 InitLoRaSetting() 中同步读取：先摘掉接收回调，否则串口事件任务
+    // 会把应答搬进帧环形区，库读不到应答而失败，应答字节之后还会被当成接收帧
+    _serial->onReceive(nullptr);
+    uint32_t previousBaud = uartBaud;
+    enterConfigMode();
+    
+    USBSerial.println("[E220] Calling InitLoRaSetting()...");
+    int result = lora->InitLoRaSetting(config);
+    USBSerial.println("[E220] InitLoRaSetting returned: " + String(result));
+    
+    // 写入成功后模块按新配置的波特率工作，失败时沿用原波特率
+    leaveConfigMode(result == 0 ? LORA_E220_UART_BAUD : previousBaud);
+    
+    // 丢弃配置期间残留的字节；环形区中旧频道上未读的帧已无法正确归属，一并丢弃。
+    // 模块回到正常模式后才重新挂回回调
+    while (_serial->available() > 0) {
+        _serial->read();
+    }
+    rxRing.discard();
+    attachReceiveCallback();
+    
+    if (result != 0) {
+        // 写入失败时模块状态未知，下次必须重新写入
+        activeConfigValid = false;
+        return false;
+    }
+    
+    activeConfig = config;
+    activeConfigValid = true;
+    // 只换频道（跳频）时不写闪存：保存的频道第一次变化时标记为过期，之后由 flushSettings() 补写
+    if (!storedValid || !e220ConfigEqualsExceptChannel(config, storedConfig)) {
+        persistConfig(true);
+    } else if (storedChannelCurrent && config.own_channel != storedConfig.own_channel) {
+        persistConfig(false);
+    }
+    
+    return true;
+}
+
+void E220Adapter::attachReceiveCallback() {
+    // 只在接收超时（线路空闲，即一帧结束）时回调，把整帧搬入环形区后再唤醒监听任务
+    _serial->onReceive([this]() {
+        rxRing.fill(_serial);
+        if (frameCallback) {
+            frameCallback();
         }
-        USBSerial.println("[E220] 433MHz mode, calculated channel: " + String(channel));
-        
-        uint32_t actualFreq = 410125000 + channel * 100000;
-        USBSerial.println("[E220] Calculated actual frequency: " + String(actualFreq) + " Hz");
+    }, true);
+}
+
+// 模式切换后等待 AUX 变高（模块空闲），再按手册留出切换生效的时间
+static void e220WaitReady() {
+#if LORA_E220_AUX_PIN >= 0
+    uint32_t start = millis();
+    while (digitalRead(LORA_E220_AUX_PIN) == LOW && millis() - start < E220_AUX_TIMEOUT_MS) {
+        delay(1);
+    }
+#endif
+    delay(E220_SETTLE_MS);
+}
+
+void E220Adapter::enterConfigMode() {
+#if LORA_E220_M0_PIN >= 0 && LORA_E220_M1_PIN >= 0
+    digitalWrite(LORA_E220_M0_PIN, HIGH);
+    digitalWrite(LORA_E220_M1_PIN, HIGH);
+    e220WaitReady();
+#endif
+    // 未接 M0/M1 时模式由模块上的拨码开关决定，此时构建只允许 9600（见 config.h）
+    setHostBaud(E220_CONFIG_BAUD);
+}
+
+void E220Adapter::leaveConfigMode(uint32_t baud) {
+#if LORA_E220_M0_PIN >= 0 && LORA_E220_M1_PIN >= 0
+    digitalWrite(LORA_E220_M0_PIN, LOW);
+    digitalWrite(LORA_E220_M1_PIN, LOW);
+#endif
+    e220WaitReady();
+    setHostBaud(baud);
+}
+
+void E220Adapter::setHostBaud(uint32_t baud) {
+    if (baud == uartBaud) return;
+    
+    _serial->updateBaudRate(baud);
+    uartBaud = baud;
+    USBSerial.printf("[E220] Host UART baud: %lu\n", baud);
+}
+
+uint8_t E220Adapter::channelForFrequency(uint32_t freqHz) {
+    uint32_t baseFreq = 0;
+    if (moduleType == LORA_E220_433) {
+        baseFreq = 410125000;
     } else if (moduleType == LORA_E220_868) {
-        channel = (freqHz - 850000000) / 100000;
-        // 确保通道值在有效范围内（0-255）
-        if (channel > 255) {
-            channel = 255;
-        }
-        USBSerial.println("[E220] 868MHz mode, calculated channel: " + String(channel));
-        
-        uint32_t actualFreq = 850000000 + channel * 100000;
-        USBSerial.println("[E220] Calculated actual frequency: " + String(actualFreq) + " Hz");
+        baseFreq = 850000000;
     } else if (moduleType == LORA_E220_915) {
-        channel = (freqHz - 902000000) / 100000;
-        // 确保通道值在有效范围内（0-255）
-        if (channel > 255) {
-            channel = 255;
-        }
-        USBSerial.println("[E220] 915MHz mode, calculated channel: " + String(channel));
-        
-        uint32_t actualFreq = 902000000 + channel * 100000;
-        USBSerial.println("[E220] Calculated actual frequency: " + String(actualFreq) + " Hz");
+        baseFreq = 902000000;
     }
     
+    uint32_t channel = freqHz > baseFreq ? (freqHz - baseFreq) / 100000 : 0;
     // 确保通道值在有效范围内（0-255）
     if (channel > 255) {
         channel = 255;
-    } else if (channel < 0) {
-        channel = 0;
     }
     
-    config.own_channel = channel;
-    USBSerial.println("[E220] Setting own_channel to: " + String(config.own_channel));
+    USBSerial.printf("[E220] Frequency %lu Hz -> channel %lu (actual %lu Hz)\n",
+        freqHz, channel, baseFreq + channel * 100000);
+    return channel;
+}
+
+bool E220Adapter::setFrequency(uint32_t freqHz) {
+    if (!initialized) return false;
     
-    USBSerial.println("[E220] Calling InitLoRaSetting()...");
-    int result = lora->InitLoRaSetting(config);
-    USBSerial.println("[E220] InitLoRaSetting returned: " + String(result));
+    USBSerial.println("[E220] Setting frequency: " + String(freqHz) + " Hz");
     
-    delay(50);
+    LoRaConfigItem_t config;
+    if (activeConfigValid) {
+        config = activeConfig;
+    } else {
+        lora->SetDefaultConfigValue(config);
+    }
+    config.own_channel = channelForFrequency(freqHz);
     
-    return result == 0;
+    return applyConfig(config);
 }
 
 bool E220Adapter::setBandwidth(uint16_t bandwidth) {
     if (!initialized) return false;
     
     LoRaConfigItem_t config;
-    lora->SetDefaultConfigValue(config);
-    
-    switch (bandwidth) {
-        case 125:
-            config.air_data_rate = DATA_RATE_2_4Kbps;
-            break;
-        case 250:
-            config.air_data_rate = DATA_RATE_9_6Kbps;
-            break;
-        case 500:
-            config.air_data_rate = DATA_RATE_19_2Kbps;
-            break;
-        default:
-            config.air_data_rate = DATA_RATE_2_4Kbps;
+    if (activeConfigValid) {
+        config = activeConfig;
+    } else {
+        lora->SetDefaultConfigValue(config);
     }
+    config.air_data_rate = e220DataRateFor(currentSf, bandwidth);
+    currentBandwidth = bandwidth;
     
-    return lora->InitLoRaSetting(config) == 0;
+    return applyConfig(config);
 }
 
 bool E220Adapter::setSpreadingFactor(uint8_t sf) {
     if (!initialized) return false;
     
     LoRaConfigItem_t config;
-    lora->SetDefaultConfigValue(config);
-    
-    if (sf >= 7 && sf <= 12) {
-        uint8_t sfIndex = sf - 7;
-        if (sfIndex <= 7) {
-            config.air_data_rate = sfIndex;
-        }
+    if (activeConfigValid) {
+        config = activeConfig;
+    } else {
+        lora->SetDefaultConfigValue(config);
     }
     
-    return lora->InitLoRaSetting(config) == 0;
+    config.air_data_rate = e220DataRateFor(sf, currentBandwidth);
+    currentSf = sf;
+    
+    return applyConfig(config);
 }
 
 bool E220Adapter::setCodingRate(uint8_t cr) {
     if (!initialized) return false;
     
     LoRaConfigItem_t config;
-    lora->SetDefaultConfigValue(config);
+    if (activeConfigValid) {
+        config = activeConfig;
+    } else {
+        lora->SetDefaultConfigValue(config);
+    }
     
     config.rssi_ambient_noise_flag = (cr == 5) ? RSSI_AMBIENT_NOISE_ENABLE : RSSI_AMBIENT_NOISE_DISABLE;
     
-    return lora->InitLoRaSetting(config) == 0;
+    return applyConfig(config);
+}
+
+bool E220Adapter::applySettings(const FrequencyConfig& cfg) {
+    if (!initialized) return false;
+    
+    // 在当前生效的配置上合成完整的目标配置（保留其余字段），与影子配置相同则不写模块，
+    // 否则只发起一次 InitLoRaSetting()
+    LoRaConfigItem_t config;
+    if (activeConfigValid) {
+        config = activeConfig;
+    } else {
+        lora->SetDefaultConfigValue(config);
+    }
+    config.own_channel = channelForFrequency(cfg.frequency);
+    config.air_data_rate = e220DataRateFor(cfg.spreadingFactor, cfg.bandwidth);
+    currentSf = cfg.spreadingFactor;
+    currentBandwidth = cfg.bandwidth;
+    config.rssi_ambient_noise_flag = (cfg.codingRate == 5) ? RSSI_AMBIENT_NOISE_ENABLE : RSSI_AMBIENT_NOISE_DISABLE;
+    
+    bool unchanged = activeConfigValid && e220ConfigEquals(config, activeConfig);
+    bool ok = applyConfig(config);
+    USBSerial.printf("[E220] applySettings: %s\n", unchanged ? "unchanged, write skipped" : (ok ? "written" : "failed"));
+    return ok;
+}
+
+bool E220Adapter::supportsDataRate(uint8_t sf, uint16_t bandwidth) {
+    uint8_t airDataRate;
+    return e220LookupDataRate(sf, bandwidth, &airDataRate);
 }
 
 int16_t E220Adapter::getRSSI() {
     if (!initialized) return -120;
     
-    USBSerial.println("[E220] Checking for available data...");
-    
-    if (_serial->available() > 0) {
-        USBSerial.printf("[E220] Data available: %d bytes\n", _serial->available());
-        
-        RecvFrame_t frame;
-        USBSerial.println("[E220] Calling RecieveFrame()...");
-        int result = lora->RecieveFrame(&frame);
-        USBSerial.printf("[E220] RecieveFrame() returned: %d\n", result);
-        
-        if (result == 0) {
-            USBSerial.printf("[E220] RSSI: %d dBm\n", frame.rssi);
-            return frame.rssi;
-        }
-    } else {
-        USBSerial.println("[E220] No data available");
+    // 只查看最旧一帧，不消费，帧仍由监听任务处理
+    FrameView view;
+    if (rxRing.peek(&view) == 0) {
+        return view.rssi;
     }
     
-    USBSerial.println("[E220] Returning -120 dBm");
     return -120;
 }
 
 int16_t E220Adapter::getSNR() {
     if (!initialized) return -20;
     
-    if (_serial->available() > 0) {
-        RecvFrame_t frame;
-        int result = lora->RecieveFrame(&frame);
-        
-        if (result == 0 && frame.recv_data_len > 0) {
-            return 10;
-        }
+    FrameView view;
+    if (rxRing.peek(&view) == 0 && view.length > 0) {
+        return 10;
     }
     
     return -20;
@@ -187,35 +487,81 @@ int16_t E220Adapter::getSNR() {
 bool E220Adapter::receivePacket(uint8_t* buffer, size_t* length) {
     if (!initialized || !buffer || !length) return false;
     
-    if (_serial->available() > 0) {
-        RecvFrame_t frame;
-        int result = lora->RecieveFrame(&frame);
-        
-        if (result == 0 && frame.recv_data_len > 0) {
-            *length = frame.recv_data_len;
-            memcpy(buffer, frame.recv_data, *length);
-            return true;
-        }
+    FrameView view;
+    int result = rxRing.peek(&view);
+    if (result < 0) return false;
+    
+    bool ok = result == 0 && view.length > 0;
+    if (ok) {
+        *length = view.length;
+        memcpy(buffer, view.data, view.length);
     }
+    rxRing.release();
+    return ok;
+}
+
+int E220Adapter::receiveFrame(void* frame) {
+    if (!initialized) return -1;
     
-    return false;
+    FrameView view;
+    int result = rxRing.peek(&view);
+    if (result == 0) {
+        RecvFrame_t* out = (RecvFrame_t*)frame;
+        memcpy(out->recv_data, view.data, view.length);
+        out->recv_data_len = view.length;
+        out->rssi = view.rssi;
+    }
+    if (result >= 0) {
+        rxRing.release();
+    }
+    return result;
+}
+
+int E220Adapter::readFrame(FrameView* view) {
+    if (!initialized) return -1;
+    return rxRing.peek(view);
+}
+
+void E220Adapter::releaseFrame() {
+    rxRing.release();
+}
+
+bool E220Adapter::frameAvailable() {
+    return rxRing.available();
+}
+
+void E220Adapter::setFrameCallback(std::function<void()> callback) {
+    frameCallback = callback;
 }
 
 void E220Adapter::standby() {
     if (initialized) {
         LoRaConfigItem_t config;
         lora->SetDefaultConfigValue(config);
-        lora->InitLoRaSetting(config);
+        applyConfig(config);
     }
 }
 
 bool E220Adapter::sleep() {
-    if (initialized) {
-        LoRaConfigItem_t config;
-        lora->SetDefaultConfigValue(config);
-        config.transmission_method_type = UART_TT_MODE;
-        lora->InitLoRaSetting(config);
-        return true;
+    if (!initialized) return false;
+    
+#if LORA_E220_M0_PIN >= 0 && LORA_E220_M1_PIN >= 0
+    // 深度睡眠模式 (M0=1, M1=1)，配置保持不变
+    digitalWrite(LORA_E220_M0_PIN, HIGH);
+    digitalWrite(LORA_E220_M1_PIN, HIGH);
+    return true;
+#else
+    // M0/M1 未接到主机，无法切换工作模式
+    USBSerial.println("[E220] Sleep not supported: M0/M1 not connected");
+    return false;
+#endif
+}
+
+bool E220Adapter::setLowPowerMode(bool enable) {
+    // WOR 接收模式 (M0=0, M1=1) 只能收到带 WOR 前导的发送方，被动扫描会听不到普通流量，
+    // 因此模块始终保持正常接收模式，省电只靠主机侧浅睡眠
+    if (enable) {
+        USBSerial.println("[E220] Radio stays in normal receive mode (WOR only hears WOR senders)");
     }
     return false;
 }
@@ -325,6 +671,14 @@ bool SX1262Adapter::sleep() {
     return false;
 }
 
+bool SX1262Adapter::setLowPowerMode(bool enable) {
+    if (!initialized) return false;
+    
+    // 占空比接收：芯片在前导码侦测之间自动睡眠
+    int state = enable ? lora->startReceiveDutyCycleAuto() : lora->startReceive();
+    return state == RADIOLIB_ERR_NONE;
+}
+
 LoRaModuleType SX1262Adapter::getModuleType() {
     return LORA_SX1262;
 }
@@ -2,7 +2,9 @@
 #define LORA_ADAPTER_H
 
 #include "common.h"
+#include "e220_frame.h"
 #include <M5_LoRa_E220.h>
+#include <functional>
 
 #ifdef LORA_MODULE
 #include <RadioLib.h>
@@ -11,6 +13,7 @@
 // LoRa 模块抽象接口
 class LoRaAdapter {
 public:
+    LoRaAdapter() : appliedValid(false) {}
     virtual ~LoRaAdapter() {}
     
     virtual bool init() = 0;
@@ -18,15 +21,38 @@ public:
     virtual bool setBandwidth(uint16_t bandwidth) = 0;
     virtual bool setSpreadingFactor(uint8_t sf) = 0;
     virtual bool setCodingRate(uint8_t cr) = 0;
+    // 一次性应用频率/带宽/扩频因子/编码率，默认只对与上次不同的项调用上面的接口；
+    // 上次下发失败时全量重发
+    virtual bool applySettings(const FrequencyConfig& cfg);
+    // 模块能否以该 (SF, BW) 组合接收
+    virtual bool supportsDataRate(uint8_t sf, uint16_t bandwidth) { return true; }
     virtual int16_t getRSSI() = 0;
     virtual int16_t getSNR() = 0;
     virtual bool receivePacket(uint8_t* buffer, size_t* length) = 0;
     virtual void standby() = 0;
     virtual bool sleep() = 0;
+    // 空闲时（监听停止）调用：把推迟的配置持久化写入落盘
+    virtual void flushSettings() {}
+    // 不丢普通流量的低功耗接收（如 SX1262 占空比接收），模块不支持时返回 false
+    virtual bool setLowPowerMode(bool enable) { return false; }
     virtual LoRaModuleType getModuleType() = 0;
     virtual String getModuleName() = 0;
     
     virtual int receiveFrame(void* frame) = 0;
+    // 取下一帧的视图，返回值同 receiveFrame()（0 成功，1 错误）；
+    // 返回 0 或 1 后必须调用 releaseFrame()，视图在此之前有效
+    // 默认经 receiveFrame() 复制到内部缓冲区
+    virtual int readFrame(FrameView* view);
+    virtual void releaseFrame() {}
+    // 是否有待读取的接收帧；默认模块经 Serial2 上报
+    virtual bool frameAvailable() { return Serial2.available() > 0; }
+    // 收到数据时的回调（在串口事件任务中调用），传入 nullptr 取消
+    virtual void setFrameCallback(std::function<void()> callback) { Serial2.onReceive(callback); }
+    
+protected:
+    FrequencyConfig applied;
+    bool appliedValid;
+    RecvFrame_t scratchFrame;
 };
 
 // E220 模块适配器
@@ -36,6 +62,32 @@ private:
     HardwareSerial* _serial;
     LoRaModuleType moduleType;
     bool initialized;
+    uint8_t currentSf;
+    uint16_t currentBandwidth;
+    uint32_t uartBaud;               // 主机侧 Serial2 当前波特率
+    
+    // 串口空闲（帧结束）时由回调填充，监听任务原地解析
+    E220FrameRing rxRing;
+    std::function<void()> frameCallback;
+    
+    // 模块当前生效的配置（影子寄存器）
+    LoRaConfigItem_t activeConfig;
+    bool activeConfigValid;
+    // NVS 中保存的配置：跳频只改频道，不逐次写闪存，
+    // 只在第一次换频道时把保存的频道标记为过期，空闲时再补写
+    LoRaConfigItem_t storedConfig;
+    bool storedValid;
+    bool storedChannelCurrent;
+    
+    uint8_t channelForFrequency(uint32_t freqHz);
+    bool applyConfig(LoRaConfigItem_t& config);
+    bool loadPersistedConfig();
+    void persistConfig(bool channelCurrent);
+    void setHostBaud(uint32_t baud);
+    void attachReceiveCallback();
+    // 配置模式 (M0=1, M1=1)，模块串口固定 9600；离开时回到正常模式并切换到 baud
+    void enterConfigMode();
+    void leaveConfigMode(uint32_t baud);
     
 public:
     E220Adapter(LoRa_E220* loraModule, LoRaModuleType type = LORA_E220_433);
@@ -45,17 +97,23 @@ public:
     bool setBandwidth(uint16_t bandwidth) override;
     bool setSpreadingFactor(uint8_t sf) override;
     bool setCodingRate(uint8_t cr) override;
+    bool applySettings(const FrequencyConfig& cfg) override;
+    bool supportsDataRate(uint8_t sf, uint16_t bandwidth) override;
     int16_t getRSSI() override;
     int16_t getSNR() override;
     bool receivePacket(uint8_t* buffer, size_t* length) override;
     void standby() override;
     bool sleep() override;
+    bool setLowPowerMode(bool enable) override;
+    void flushSettings() override;
     LoRaModuleType getModuleType() override;
     String getModuleName() override;
     
-    int receiveFrame(void* frame) override {
-        return lora->RecieveFrame((RecvFrame_t*)frame);
-    }
+    int receiveFrame(void* frame) override;
+    int readFrame(FrameView* view) override;
+    void releaseFrame() override;
+    bool frameAvailable() override;
+    void setFrameCallback(std::function<void()> callback) override;
     
     LoRa_E220* getLoRaModule() { return lora; }
 };
@@ -86,6 +144,7 @@ public:
     bool receivePacket(uint8_t* buffer, size_t* length) override;
     void standby() override;
     bool sleep() override;
+    bool setLowPowerMode(bool enable) override;
     LoRaModuleType getModuleType() override;
     String getModuleName() override;
     
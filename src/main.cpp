@@ -7,10 +7,38 @@
 #include "display.h"
 #include "config.h"
 #include "config_user.h"
+#include "boot_timing.h"
+#include "power.h"
+#include "exporter.h"
+#include "input.h"
+#include "metrics.h"
+#include "stream.h"
+#ifdef LORASCOPE_BENCH
+#include "bench.h"
+#endif
+#ifdef LORASCOPE_STRESS
+#include "stress.h"
+#endif
+#include <freertos/semphr.h>
 
 LoRaAdapter* loraAdapter = nullptr;
 FrequencyListener* listener = nullptr;
 ScopeDisplay* display = nullptr;
+PowerManager* powerManager = nullptr;
+InputService* inputService = nullptr;
+BinaryStream* binaryStream = nullptr;
+#ifdef LORASCOPE_STRESS
+InjectedAdapter* injectedAdapter = nullptr;
+StressHarness* stressHarness = nullptr;
+#endif
+
+// 界面任务持有的雷达点快照，按纪元增量更新
+PointRing displayPoints;
+uint32_t displayPointsEpoch = 0;
+// 快照上的事件索引，每次取快照后增量同步
+EventIndex displayIndex;
+// RSSI 直方图快照（当前频点叠加），每帧重取
+RssiHistogramSnapshot displayHistogram;
 
 volatile bool receivedSample = false;
 volatile ScanSample lastSample;
@@ -18,40 +46,63 @@ volatile ScanSample lastSample;
 unsigned long lastActivityTime = 0;
 bool screenOff = false;
 const unsigned long SCREEN_TIMEOUT = 60000; // 1分钟自动息屏
+const uint32_t FRAME_INTERVAL_MS = 33;       // 画面刷新间隔（约 30 fps）
+const uint32_t IDLE_WAIT_MS = 1000;          // 息屏时等待输入的最长时间
+const size_t SERIAL_COMMAND_MAX_LEN = 32;    // 串口命令最大长度
 
 void IRAM_ATTR onReceive() {
     receivedSample = true;
 }
 
+// 无线电初始化任务参数：与显示初始化并行执行
+struct RadioInitJob {
+    FrequencyListener* listener;
+    ListenerConfig config;
+    bool success;
+    SemaphoreHandle_t done;
+};
+
+static void radioInitTask(void* pvParameters) {
+    RadioInitJob* job = static_cast<RadioInitJob*>(pvParameters);
+    
+    job->success = job->listener->init(job->config);
+    BootTiming::mark("radio ready");
+    
+    xSemaphoreGive(job->done);
+    vTaskDelete(nullptr);
+}
+
 void setup() {
+    BootTiming::mark("setup entry");
     USBSerial.begin(115200);
-    delay(500);
     USBSerial.println("\n\n=== LoRaScope Starting ===");
     
+#ifdef LORASCOPE_BENCH
+    // 基准测试在任何后台任务启动前运行，避免干扰计时
+    runBenchmarks(USBSerial);
+#endif
+    
     USBSerial.println("Step 1: Initializing M5Cardputer...");
     auto cfg = M5.config();
     M5Cardputer.begin(cfg, true);
-    M5Cardputer.Display.init();
-    M5Cardputer.Display.setRotation(1);
     USBSerial.println("M5Cardputer initialized");
+    BootTiming::mark("M5Cardputer ready");
     
     USBSerial.println("Step 2: Creating LoRa adapter...");
+#ifdef LORASCOPE_STRESS
+    // 压力测试以注入帧代替真实模块
+    injectedAdapter = new InjectedAdapter();
+    loraAdapter = injectedAdapter;
+#else
     loraAdapter = LoRaAdapterFactory::createDefaultAdapter();
+#endif
     USBSerial.println("LoRa adapter created");
     
-    USBSerial.println("Step 3: Initializing LoRa module...");
-    delay(100);
-    
-    bool loraInitSuccess = false;
-    if (!loraAdapter || !loraAdapter->init()) {
-        USBSerial.println("ERROR: Failed to initialize LoRa module!");
-        loraInitSuccess = false;
-    } else {
-        USBSerial.println("LoRa module initialized: " + loraAdapter->getModuleName());
-        loraInitSuccess = true;
-    }
+    powerManager = new PowerManager(loraAdapter);
+    inputService = new InputService();
+    binaryStream = new BinaryStream(USBSerial);
     
-    USBSerial.println("Step 4: Creating listener...");
+    USBSerial.println("Step 3: Creating listener...");
     listener = new FrequencyListener(loraAdapter);
     USBSerial.println("Listener created");
     
@@ -59,38 +110,40 @@ void setup() {
     USBSerial.printf("Config: %lu - %lu Hz\n", scopeConfig.startFreqHz, scopeConfig.endFreqHz);
     
     ListenerConfig config;
-    config.frequencies = scopeConfig.getFrequencies();
+    config.plan = scopeConfig.getChannelPlan();
     config.currentFreqIndex = 0;
     config.rxWindowMs = scopeConfig.rxWindowMs;
     config.bandwidth = scopeConfig.bandwidth;
     config.spreadingFactor = scopeConfig.spreadingFactor;
     config.codingRate = scopeConfig.codingRate;
     config.maxPoints = scopeConfig.maxPoints;
-    
-    USBSerial.printf("Generated %d frequency points\n", config.frequencies.size());
-    
-    USBSerial.println("Step 5: Initializing listener...");
-    delay(100);
-    
-    bool listenerInitSuccess = false;
-    if (!loraInitSuccess) {
-        USBSerial.println("WARNING: Skipping listener initialization due to LoRa failure");
-        listenerInitSuccess = false;
-    } else if (!listener->init(config)) {
-        USBSerial.println("ERROR: Failed to initialize listener!");
-        listenerInitSuccess = false;
-    } else {
-        USBSerial.printf("Listener initialized with %d frequencies\n", config.frequencies.size());
-        listenerInitSuccess = true;
+    config.hopMode = scopeConfig.hopMode;
+    config.rssiBinEdges = scopeConfig.rssiBinEdges;
+    config.cumulativeHistogram = scopeConfig.cumulativeHistogram;
+    config.dataRates = scopeConfig.dataRates;
+    
+    USBSerial.printf("Generated %d frequency points\n", config.plan->size());
+    
+    // 无线电（LoRa 模块 + 监听器）在独立任务中初始化，同时主任务初始化显示
+    USBSerial.println("Step 4: Initializing radio in background...");
+    RadioInitJob radioJob;
+    radioJob.listener = listener;
+    radioJob.config = config;
+    radioJob.success = false;
+    radioJob.done = xSemaphoreCreateBinary();
+    
+    bool radioTaskStarted = radioJob.done &&
+        xTaskCreate(radioInitTask, "RadioInit", 4096, &radioJob, 2, nullptr) == pdPASS;
+    if (!radioTaskStarted) {
+        USBSerial.println("WARNING: Radio init task not started, initializing inline");
+        radioJob.success = listener->init(config);
     }
     
-    USBSerial.println("Step 6: Creating display...");
+    USBSerial.println("Step 5: Creating display...");
     display = new ScopeDisplay();
     USBSerial.println("Display created");
     
-    USBSerial.println("Step 7: Initializing display...");
-    delay(100);
-    
+    USBSerial.println("Step 6: Initializing display...");
     if (!display->init()) {
         USBSerial.println("ERROR: Failed to initialize display!");
         while (1) {
@@ -99,242 +152,369 @@ void setup() {
     }
     
     USBSerial.println("Display initialized");
+    BootTiming::mark("display ready");
     
-    USBSerial.println("Step 8: Configuring display...");
-    display->setModuleName(loraInitSuccess ? loraAdapter->getModuleName() : "No LoRa");
+    USBSerial.println("Step 7: Configuring display...");
     display->setScanning(false);
     
-    std::vector<uint32_t> freqList;
-    for (const auto& freqConfig : config.frequencies) {
-        freqList.push_back(freqConfig.frequency);
-    }
-    display->setFrequencies(freqList);
+    display->setChannelPlan(config.plan);
+    USBSerial.println("Display configured");
     
-    if (listenerInitSuccess && listener) {
-        display->setCurrentFreq(listener->getCurrentFrequency());
-        display->setCurrentFreqIndex(listener->getCurrentFreqIndex(), config.frequencies.size());
+    USBSerial.println("Step 8: Waiting for radio...");
+    if (radioTaskStarted) {
+        xSemaphoreTake(radioJob.done, portMAX_DELAY);
+    }
+    if (radioJob.done) {
+        vSemaphoreDelete(radioJob.done);
     }
-    USBSerial.println("Display configured");
     
-    USBSerial.println("Step 9: Starting listener...");
-    delay(100);
+    bool listenerInitSuccess = radioJob.success;
+    if (listenerInitSuccess) {
+        USBSerial.printf("Listener initialized with %d frequencies\n", config.plan->size());
+    } else {
+        USBSerial.println("ERROR: Failed to initialize LoRa module / listener!");
+    }
     
-    if (listenerInitSuccess && listener) {
+    display->setModuleName(listenerInitSuccess ? loraAdapter->getModuleName() : "No LoRa");
+    if (listenerInitSuccess) {
+        display->setCurrentFreq(listener->getCurrentFrequency());
+        display->setCurrentFreqIndex(listener->getCurrentFreqIndex(), config.plan->size());
         listener->setScopeDisplay(display);
+        display->setPayloadPool(&listener->getPayloadPool());
+        display->setRssiHistogram(&displayHistogram);
+        display->setOccupancy(&listener->getOccupancy());
+        display->setRssiPyramid(&listener->getRssiPyramid());
+        display->setEventIndex(&displayIndex);
     }
     
-    USBSerial.println("Listener ready (press 's' to start)");
-    
-    if (!config.frequencies.empty()) {
-        uint32_t startFreq = config.frequencies[0].frequency;
-        USBSerial.printf("Step 10: Auto-starting listener at %lu Hz...\n", startFreq);
+    if (!config.plan->empty()) {
+        uint32_t startFreq = config.plan->first();
+        USBSerial.printf("Step 9: Auto-starting listener at %lu Hz...\n", startFreq);
     } else {
-        USBSerial.println("Step 10: No frequencies configured, skipping auto-start");
+        USBSerial.println("Step 9: No frequencies configured, skipping auto-start");
     }
-    delay(100);
     
     if (listenerInitSuccess) {
         listener->start();
         display->setScanning(true);
         USBSerial.println("Listener auto-started");
+#ifdef LORASCOPE_STRESS
+        stressHarness = new StressHarness(injectedAdapter);
+        stressHarness->begin(millis());
+        USBSerial.println("Stress harness started");
+#endif
     } else {
         display->setScanning(false);
         USBSerial.println("Listener not started due to initialization failure");
+        BootTiming::report();
     }
     
-    USBSerial.println("=== Setup Complete, Entering Loop ===");
+    if (!inputService->begin()) {
+        USBSerial.println("WARNING: Input service not started, keyboard disabled");
+    }
     
-    delay(500);  // 给主循环一些时间启动
+    BootTiming::mark("setup complete");
+    USBSerial.println("=== Setup Complete, Entering Loop ===");
 }
 
-void loop() {
-    static unsigned long loopCount = 0;
-    loopCount++;
-    
-    M5Cardputer.update();
+// 处理一个键盘事件：普通键只响应按下，'-'/'=' 长按时以 10 倍步进重复
+static void handleKeyEvent(const InputEvent& event) {
+    if (event.type == INPUT_RELEASE) return;
     
-    static unsigned long lastLoopDebugTime = 0;
-    if (millis() - lastLoopDebugTime > 10000) {
-        lastLoopDebugTime = millis();
-        USBSerial.println("Loop running, count: " + String(loopCount));
-    }
-    
-    static unsigned long lastKeyPressMillis = 0;
-    const unsigned long debounceDelay = 200;
-    const unsigned long longPressDelay = 500;
-    const unsigned long repeatDelay = 100;
-    static unsigned long minusKeyPressTime = 0;
-    static unsigned long equalKeyPressTime = 0;
-    static unsigned long lastMinusRepeatTime = 0;
-    static unsigned long lastEqualRepeatTime = 0;
-    static bool minusKeyPressed = false;
-    static bool equalKeyPressed = false;
-    static int minusKeyStep = 0;
-    static int equalKeyStep = 0;
-    
-    if (M5Cardputer.Keyboard.isChange() && millis() - lastKeyPressMillis >= debounceDelay) {
-        auto keys = M5Cardputer.Keyboard.keysState();
-        
-        // 检测到按键操作，更新活动时间并唤醒屏幕
-        lastActivityTime = millis();
-        if (screenOff) {
-            M5Cardputer.Display.wakeup();
-            screenOff = false;
-            USBSerial.println("Screen wakeup");
-        }
+    if (event.type == INPUT_REPEAT) {
+        if (!listener) return;
         
-        for (auto key : keys.word) {
-            switch (key) {
-                case '1':
-                    display->setMode(MODE_TIMELINE);
-                    USBSerial.println("Mode: Timeline");
-                    break;
-                case '2':
-                    display->setMode(MODE_HISTOGRAM);
-                    USBSerial.println("Mode: Histogram");
-                    break;
-                case '3':
-                    display->setMode(MODE_EVENTLIST);
-                    USBSerial.println("Mode: Event List");
-                    break;
-                case '4':
-                    display->setMode(MODE_STATISTICS);
-                    USBSerial.println("Mode: Statistics");
-                    break;
-                case '5':
-                    display->setMode(MODE_FREQCOMPARE);
-                    USBSerial.println("Mode: Frequency Comparison");
-                    break;
-                case '6':
-                    display->setMode(MODE_REALTIME);
-                    USBSerial.println("Mode: Realtime Monitor");
-                    break;
-                case '0':
-                    display->setMode(MODE_RADAR);
-                    USBSerial.println("Mode: Radar");
-                    break;
-                case 's':
-                    if (listener && listener->isRunning()) {
-                        listener->stop();
-                        display->setScanning(false);
-                        USBSerial.println("Listener stopped");
-                    } else if (listener) {
-                        listener->start();
-                        display->setScanning(true);
-                        USBSerial.println("Listener started");
-                    }
-                    break;
-                case 'c':
-                    if (listener) {
-                        listener->clearRadarPoints();
-                        listener->clearEventStats();
-                        USBSerial.println("Data cleared");
-                    }
-                    break;
-                case '-':
-                    if (listener) {
-                        listener->prevFrequency();
-                        uint16_t idx = listener->getCurrentFreqIndex();
-                        USBSerial.printf("Previous frequency: index %d\n", idx);
-                    }
-                    minusKeyPressed = true;
-                    break;
-                case '=':
-                    if (listener) {
-                        listener->nextFrequency();
-                        uint16_t idx = listener->getCurrentFreqIndex();
-                        USBSerial.printf("Next frequency: index %d\n", idx);
-                    }
-                    equalKeyPressed = true;
-                    break;
-            }
+        if (event.key == '-') {
+            listener->prevFrequency(10);
+            USBSerial.println("[Long Press] Previous frequency (10x step)");
+        } else if (event.key == '=') {
+            listener->nextFrequency(10);
+            USBSerial.println("[Long Press] Next frequency (10x step)");
         }
-        
-        lastKeyPressMillis = millis();
+        return;
     }
     
-    auto currentKeys = M5Cardputer.Keyboard.keysState();
-    bool minusKeyCurrentlyPressed = false;
-    bool equalKeyCurrentlyPressed = false;
-    
-    for (auto key : currentKeys.word) {
-        if (key == '-') {
-            minusKeyCurrentlyPressed = true;
-            if (minusKeyPressTime == 0) {
-                minusKeyPressTime = millis();
+    switch (event.key) {
+        case '1':
+            display->setMode(MODE_TIMELINE);
+            USBSerial.println("Mode: Timeline");
+            break;
+        case '2':
+            display->setMode(MODE_HISTOGRAM);
+            USBSerial.println("Mode: Histogram");
+            break;
+        case '3':
+            display->setMode(MODE_EVENTLIST);
+            USBSerial.println("Mode: Event List");
+            break;
+        case '4':
+            display->setMode(MODE_STATISTICS);
+            USBSerial.println("Mode: Statistics");
+            break;
+        case '5':
+            display->setMode(MODE_FREQCOMPARE);
+            USBSerial.println("Mode: Frequency Comparison");
+            break;
+        case '6':
+            display->setMode(MODE_REALTIME);
+            USBSerial.println("Mode: Realtime Monitor");
+            break;
+        case '0':
+            display->setMode(MODE_RADAR);
+            USBSerial.println("Mode: Radar");
+            break;
+        case '7':
+            display->setMode(MODE_HEATMAP);
+            USBSerial.println("Mode: Occupancy Heatmap");
+            break;
+        case ';':
+        case '.':
+            // 方向键上/下：时间线放大/缩小，事件列表提高/降低 RSSI 下限
+            if (display->getMode() == MODE_TIMELINE) {
+                display->zoomTimeline(event.key == ';' ? 1 : -1);
+            } else if (display->getMode() == MODE_EVENTLIST) {
+                display->stepEventRssiFilter(event.key == ';' ? 1 : -1);
             }
-        } else if (key == '=') {
-            equalKeyCurrentlyPressed = true;
-            if (equalKeyPressTime == 0) {
-                equalKeyPressTime = millis();
+            break;
+        case ',':
+        case '/':
+            // 方向键左/右：时间线向过去/现在平移半屏
+            if (display->getMode() == MODE_TIMELINE) {
+                display->panTimeline(event.key == '/' ? 1 : -1);
             }
-        }
+            break;
+        case 'f':
+            if (display->getMode() == MODE_TIMELINE || display->getMode() == MODE_EVENTLIST) {
+                display->toggleFollowChannel();
+                USBSerial.println("Toggled current channel filter");
+            }
+            break;
+        case 's':
+            if (listener && listener->isRunning()) {
+                listener->stop();
+                display->setScanning(false);
+                USBSerial.println("Listener stopped");
+            } else if (listener) {
+                listener->start();
+                display->setScanning(true);
+                USBSerial.println("Listener started");
+            }
+            break;
+        case 'p':
+            if (listener) {
+                powerManager->setLowPower(!powerManager->isLowPower(),
+                    listener->getEventStats().totalEvents,
+                    inputService->getBatteryPct());
+            }
+            break;
+        case 'h':
+            if (listener) {
+                listener->printHopReport();
+                listener->setHopMode((listener->getHopMode() + 1) % HOP_MODE_COUNT);
+            }
+            break;
+        case 'e':
+            if (listener) {
+                exportChannelCsv(*listener, USBSerial);
+                exportSweepCsv(*listener, USBSerial);
+                exportOccupancyCsv(*listener, USBSerial);
+            }
+            break;
+        case 'c':
+            if (listener) {
+                listener->clearRadarPoints();
+                listener->clearEventStats();
+                USBSerial.println("Data cleared");
+            }
+            break;
+        case '-':
+            if (listener) {
+                listener->prevFrequency();
+                uint16_t idx = listener->getCurrentFreqIndex();
+                USBSerial.printf("Previous frequency: index %d\n", idx);
+            }
+            break;
+        case '=':
+            if (listener) {
+                listener->nextFrequency();
+                uint16_t idx = listener->getCurrentFreqIndex();
+                USBSerial.printf("Next frequency: index %d\n", idx);
+            }
+            break;
     }
-    
-    if (minusKeyPressed && minusKeyCurrentlyPressed && listener) {
-        unsigned long currentTime = millis();
-        if (currentTime - minusKeyPressTime >= longPressDelay && currentTime - lastMinusRepeatTime >= repeatDelay) {
-            // 长按期间每次执行10倍步进，而不是1倍步进
-            listener->prevFrequency(10);
-            USBSerial.println("[Long Press] Previous frequency (10x step)");
-            lastMinusRepeatTime = currentTime;
+}
+
+// 串口查询命令：metrics / metrics bin / stream on / stream off / time HH:MM / heatmap save|clear / window <ms> /
+// events [ch0 ch1 [min_rssi [seconds]]]
+static void handleSerialCommand(const String& command) {
+    Metrics::set(METRIC_FREE_HEAP, ESP.getFreeHeap());
+    
+    if (command == "metrics") {
+        Metrics::print(USBSerial);
+    } else if (command == "metrics bin") {
+        binaryStream->writeMetrics();
+    } else if (command == "stream on") {
+        USBSerial.println("[Stream] Binary stream enabled");
+        binaryStream->setEnabled(true);
+    } else if (command == "stream off") {
+        binaryStream->setEnabled(false);
+        USBSerial.println("[Stream] Binary stream disabled");
+    } else if (command.startsWith("time ")) {
+        // 本地时间，用于占用热力图的小时划分
+        unsigned hours = 0, minutes = 0;
+        if (listener && sscanf(command.c_str() + 5, "%u:%u", &hours, &minutes) == 2 && hours < 24 && minutes < 60) {
+            listener->setTimeOfDay(hours * 3600 + minutes * 60);
+        } else {
+            USBSerial.println("Usage: time HH:MM");
+        }
+    } else if (command == "heatmap save") {
+        if (listener) listener->checkpointOccupancy(millis(), true);
+    } else if (command == "heatmap clear") {
+        if (listener) listener->clearOccupancy();
+    } else if (command.startsWith("window ")) {
+        // 运行中修改接收窗口，监听任务从下一个窗口起使用新配置
+        unsigned windowMs = 0;
+        if (listener && sscanf(command.c_str() + 7, "%u", &windowMs) == 1 && windowMs >= HOP_MIN_WINDOW_MS) {
+            ListenerConfig cfg = listener->getConfig();
+            cfg.rxWindowMs = windowMs;
+            listener->setConfig(cfg);
+        } else {
+            USBSerial.printf("Usage: window <ms>  (>= %u)\n", HOP_MIN_WINDOW_MS);
         }
+    } else if (command == "events" || command.startsWith("events ")) {
+        // 按频点范围、RSSI 下限和最近若干秒导出快照中的事件
+        unsigned ch0 = 0, ch1 = CHANNEL_NONE - 1, seconds = 0;
+        int minRssi = INT16_MIN;
+        int fields = sscanf(command.c_str() + 6, "%u %u %d %u", &ch0, &ch1, &minRssi, &seconds);
+        if (listener && (fields <= 0 || fields >= 2)) {
+            PointSnapshotInfo snapshot;
+            listener->snapshotPoints(displayPoints, displayPointsEpoch, &snapshot);
+            displayPointsEpoch = snapshot.epoch;
+            displayIndex.sync(displayPoints, listener->getFrequencyCount());
+            
+            EventQuery query;
+            query.firstChannel = ch0;
+            query.lastChannel = ch1;
+            query.minRssi = minRssi;
+            uint64_t nowUs = nowMicros();
+            if (seconds > 0 && nowUs > seconds * US_PER_SEC) {
+                query.startUs = nowUs - seconds * US_PER_SEC;
+            }
+            exportEventsCsv(displayIndex, query, USBSerial);
+        } else {
+            USBSerial.println("Usage: events [ch0 ch1 [min_rssi [seconds]]]");
+        }
+    } else {
+        USBSerial.printf("Unknown command: %s\n", command.c_str());
     }
-    
-    if (equalKeyPressed && equalKeyCurrentlyPressed && listener) {
-        unsigned long currentTime = millis();
-        if (currentTime - equalKeyPressTime >= longPressDelay && currentTime - lastEqualRepeatTime >= repeatDelay) {
-            // 长按期间每次执行10倍步进，而不是1倍步进
-            listener->nextFrequency(10);
-            USBSerial.println("[Long Press] Next frequency (10x step)");
-            lastEqualRepeatTime = currentTime;
+}
+
+static void pollSerialCommands() {
+    static String line;
+    
+    while (USBSerial.available() > 0) {
+        char c = USBSerial.read();
+        if (c == '\n' || c == '\r') {
+            line.trim();
+            if (line.length() > 0) {
+                handleSerialCommand(line);
+            }
+            line = "";
+        } else if (line.length() < SERIAL_COMMAND_MAX_LEN) {
+            line += c;
         }
     }
+}
+
+void loop() {
+    static unsigned long loopCount = 0;
+    static unsigned long lastLoopDebugTime = 0;
+    static unsigned long lastFrameTime = 0;
+    loopCount++;
     
-    if (!minusKeyCurrentlyPressed && minusKeyPressed) {
-        // 长按松开时重置状态
-        minusKeyPressTime = 0;
-        minusKeyPressed = false;
-        lastMinusRepeatTime = 0;
-        minusKeyStep = 0;
+    // 阻塞等待键盘事件，最长等到下一帧（息屏时等到下一个定时检查）
+    unsigned long now = millis();
+    uint32_t waitMs = IDLE_WAIT_MS;
+    if (!screenOff) {
+        unsigned long sinceFrame = now - lastFrameTime;
+        waitMs = sinceFrame >= FRAME_INTERVAL_MS ? 0 : FRAME_INTERVAL_MS - sinceFrame;
     }
     
-    if (!equalKeyCurrentlyPressed && equalKeyPressed) {
-        // 长按松开时重置状态
-        equalKeyPressTime = 0;
-        equalKeyPressed = false;
-        lastEqualRepeatTime = 0;
-        equalKeyStep = 0;
+    // 低功耗模式且息屏时浅睡眠到下一个定时器/无线电唤醒，代替阻塞等待
+    bool slept = screenOff && powerManager->idle(LOW_POWER_SLEEP_MS);
+    
+    InputEvent event;
+    // 浅睡眠醒来后留出两个扫描周期让输入任务读键盘
+    bool gotEvent = inputService->waitEvent(&event, slept ? 2 * INPUT_SCAN_MS : waitMs);
+    while (gotEvent) {
+        if (event.type == INPUT_PRESS) {
+            // 检测到按键操作，更新活动时间并唤醒屏幕
+            lastActivityTime = millis();
+            if (screenOff) {
+                M5Cardputer.Display.wakeup();
+                // 状态栏只在变化时推送，唤醒后整屏重绘一次
+                display->invalidate();
+                screenOff = false;
+                powerManager->setScreenOff(false);
+                USBSerial.println("Screen wakeup");
+            }
+        }
+        
+        handleKeyEvent(event);
+        gotEvent = inputService->waitEvent(&event, 0);
     }
     
-    if (minusKeyCurrentlyPressed && !minusKeyPressed) {
-        minusKeyPressed = true;
-        minusKeyPressTime = millis();
-        lastMinusRepeatTime = millis();
-    }
+    pollSerialCommands();
     
-    if (equalKeyCurrentlyPressed && !equalKeyPressed) {
-        equalKeyPressed = true;
-        equalKeyPressTime = millis();
-        lastEqualRepeatTime = millis();
+    now = millis();
+    if (now - lastLoopDebugTime > 10000) {
+        lastLoopDebugTime = now;
+        Metrics::set(METRIC_FREE_HEAP, ESP.getFreeHeap());
+        USBSerial.println("Loop running, count: " + String(loopCount));
     }
     
-    uint8_t batteryPct = M5Cardputer.Power.getBatteryLevel();
-    display->setBatteryPct(batteryPct);
+    // 息屏时不再刷新画面，但二进制流启用时仍需取快照
+    bool frameDue = now - lastFrameTime >= FRAME_INTERVAL_MS;
+    if (listener && frameDue && (!screenOff || binaryStream->isEnabled())) {
+        lastFrameTime = now;
+        
+        PointSnapshotInfo snapshot;
+        listener->snapshotPoints(displayPoints, displayPointsEpoch, &snapshot);
+        displayPointsEpoch = snapshot.epoch;
+        displayIndex.sync(displayPoints, listener->getFrequencyCount());
+        binaryStream->writePoints(displayPoints);
+        
+        if (!screenOff) {
+            display->setBatteryPct(inputService->getBatteryPct());
+            if (display->getMode() == MODE_HISTOGRAM) {
+                listener->snapshotHistogram(listener->getCurrentFreqIndex(), &displayHistogram);
+            }
+            listener->followTimelineChannel(display->isFollowingChannel() ? listener->getCurrentFreqIndex() : CHANNEL_NONE);
+            EventStats stats = listener->getEventStats();
+            display->update(displayPoints, stats);
+            
+#ifdef LORASCOPE_STRESS
+            if (stressHarness && stressHarness->isRunning()) {
+                stressHarness->observeSnapshot(displayPoints);
+                stressHarness->poll(now, USBSerial);
+                // 测试期间保持亮屏，显示阶段同样计入
+                lastActivityTime = now;
+            }
+#endif
+        }
+    }
+    binaryStream->poll(now);
     
     if (listener) {
-        const std::vector<RadarPoint>& points = listener->getRadarPoints();
-        const EventStats& stats = listener->getEventStats();
-        display->update(points, stats);
+        listener->checkpointOccupancy(now, false);
+        listener->reclaimConfigs();
     }
     
     // 检查是否需要自动息屏
-    unsigned long currentTime = millis();
-    if (!screenOff && currentTime - lastActivityTime >= SCREEN_TIMEOUT) {
+    if (!screenOff && now - lastActivityTime >= SCREEN_TIMEOUT) {
         M5Cardputer.Display.sleep();
         screenOff = true;
+        powerManager->setScreenOff(true);
         USBSerial.println("Screen sleep");
     }
-    
-    delay(10);
 }
@@ -0,0 +1,59 @@
+#include "metrics.h"
+
+volatile uint32_t Metrics::values[METRIC_COUNT];
+
+static const char* const METRIC_NAMES[METRIC_COUNT] = {
+    "uart_overruns",
+    "frames_received",
+    "parse_errors",
+    "rssi_rejected",
+    "deferred_frames",
+    "point_evictions",
+    "set_freq_failures",
+    "ring_points",
+    "free_heap",
+    "frame_ring_full",
+};
+
+void Metrics::increment(MetricId id, uint32_t n) {
+    if (id >= METRIC_COUNT) return;
+    __atomic_fetch_add(&values[id], n, __ATOMIC_RELAXED);
+}
+
+void Metrics::set(MetricId id, uint32_t value) {
+    if (id >= METRIC_COUNT) return;
+    __atomic_store_n(&values[id], value, __ATOMIC_RELAXED);
+}
+
+uint32_t Metrics::get(MetricId id) {
+    if (id >= METRIC_COUNT) return 0;
+    return __atomic_load_n(&values[id], __ATOMIC_RELAXED);
+}
+
+const char* Metrics::name(MetricId id) {
+    return id < METRIC_COUNT ? METRIC_NAMES[id] : "unknown";
+}
+
+bool Metrics::isGauge(MetricId id) {
+    return id == METRIC_RING_POINTS || id == METRIC_FREE_HEAP;
+}
+
+void Metrics::print(Print& out) {
+    out.println("=== Metrics ===");
+    for (uint8_t i = 0; i < METRIC_COUNT; i++) {
+        MetricId id = (MetricId)i;
+        out.printf("%s %lu%s\n", name(id), get(id), isGauge(id) ? " (gauge)" : "");
+    }
+}
+
+size_t Metrics::encode(uint8_t* out) {
+    uint8_t* p = out;
+    *p++ = METRIC_COUNT;
+    for (uint8_t i = 0; i < METRIC_COUNT; i++) {
+        uint32_t value = get((MetricId)i);
+        for (uint8_t b = 0; b < 4; b++) {
+            *p++ = (uint8_t)(value >> (8 * b));
+        }
+    }
+    return p - out;
+}
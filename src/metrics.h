@@ -0,0 +1,41 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// 运行时指标：计数器只增不减，仪表为最近一次写入的值
+enum MetricId {
+    METRIC_UART_OVERRUNS,       // Serial2 接收 FIFO/缓冲区溢出
+    METRIC_FRAMES_RECEIVED,     // receiveFrame 成功解析的帧
+    METRIC_PARSE_ERRORS,        // receiveFrame 返回错误
+    METRIC_RSSI_REJECTED,       // RSSI 超出有效范围被丢弃的帧
+    METRIC_DEFERRED_FRAMES,     // 窗口收到事件后提前结束时仍在等待的帧
+    METRIC_POINT_EVICTIONS,     // 雷达点环形缓冲区淘汰数
+    METRIC_SET_FREQ_FAILURES,   // 频率/参数下发失败
+    METRIC_RING_POINTS,         // 仪表：雷达点缓冲区当前点数
+    METRIC_FREE_HEAP,           // 仪表：空闲堆内存 (字节)
+    // 追加在末尾，保持已有指标在二进制流中的序号不变
+    METRIC_FRAME_RING_FULL,     // 帧环形区已满（监听任务跟不上）被丢弃的帧
+    METRIC_COUNT
+};
+
+// 指标注册表：各处直接原子递增，不加锁，任意任务可读
+class Metrics {
+public:
+    static void increment(MetricId id, uint32_t n = 1);
+    static void set(MetricId id, uint32_t value);
+    static uint32_t get(MetricId id);
+    static const char* name(MetricId id);
+    static bool isGauge(MetricId id);
+    
+    // 文本输出，每行 "name value"
+    static void print(Print& out);
+    // 二进制编码：数量 (1) + 各指标值 (4, 小端)，返回写入字节数
+    static size_t encode(uint8_t* out);
+    static const size_t ENCODED_SIZE = 1 + METRIC_COUNT * 4;
+    
+private:
+    static volatile uint32_t values[METRIC_COUNT];
+};
+
+#endif // METRICS_H
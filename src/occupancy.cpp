@@ -0,0 +1,181 @@
+#include "occupancy.h"
+#include <LittleFS.h>
+
+static const uint32_t OCCUPANCY_MAGIC = 0x4F434331;  // "OCC1"
+// 2：16 位计数格，且只含时钟设定后的计数
+static const uint16_t OCCUPANCY_VERSION = 2;
+static const uint64_t US_PER_HOUR = 3600ULL * US_PER_SEC;
+static const uint64_t US_PER_DAY = 24ULL * US_PER_HOUR;
+
+// LittleFS 挂载状态：挂载失败时不自动格式化（会抹掉分区上的其他文件），
+// 记录一次后本次开机不再尝试读写检查点
+enum FilesystemState {
+    FS_UNKNOWN,
+    FS_MOUNTED,
+    FS_UNAVAILABLE
+};
+static volatile FilesystemState filesystemState = FS_UNKNOWN;
+
+static bool mountFilesystem() {
+    if (filesystemState == FS_UNKNOWN) {
+        if (LittleFS.begin(false)) {
+            filesystemState = FS_MOUNTED;
+        } else {
+            filesystemState = FS_UNAVAILABLE;
+            USBSerial.println("[Occupancy] LittleFS mount failed, heatmap persistence disabled");
+        }
+    }
+    return filesystemState == FS_MOUNTED;
+}
+
+OccupancyHeatmap::OccupancyHeatmap()
+    : channelCount(0), planId(0), clockOffsetUs(0), clockSet(false),
+      peak(0), dirty(false), lastCheckpointMs(0) {
+}
+
+void OccupancyHeatmap::setChannelCount(uint16_t count, uint32_t id) {
+    if (count > OCCUPANCY_MAX_CHANNELS) {
+        USBSerial.printf("[Occupancy] %u channels, only first %u tracked\n", count, OCCUPANCY_MAX_CHANNELS);
+        count = OCCUPANCY_MAX_CHANNELS;
+    }
+    
+    channelCount = count;
+    planId = id;
+    cells.assign((size_t)count * OCCUPANCY_HOURS, 0);
+    peak = 0;
+    dirty = false;
+}
+
+void OccupancyHeatmap::add(uint16_t channelIndex, uint64_t timestampUs) {
+    if (channelIndex >= channelCount || !clockSet) return;
+    
+    uint16_t& cell = cells[(size_t)channelIndex * OCCUPANCY_HOURS + hourOf(timestampUs)];
+    if (cell == OCCUPANCY_CELL_MAX) {
+        halve();
+    }
+    cell++;
+    if (cell > peak) peak = cell;
+    dirty = true;
+}
+
+void OccupancyHeatmap::halve() {
+    peak = 0;
+    for (uint16_t& value : cells) {
+        value >>= 1;
+        if (value > peak) peak = value;
+    }
+}
+
+void OccupancyHeatmap::clear() {
+    std::fill(cells.begin(), cells.end(), 0);
+    peak = 0;
+    dirty = true;
+}
+
+void OccupancyHeatmap::setTimeOfDay(uint32_t secondsOfDay, uint64_t nowUs) {
+    uint64_t targetUs = (uint64_t)(secondsOfDay % 86400UL) * US_PER_SEC;
+    clockOffsetUs = (targetUs + US_PER_DAY - nowUs % US_PER_DAY) % US_PER_DAY;
+    clockSet = true;
+}
+
+void OccupancyHeatmap::copyClock(const OccupancyHeatmap& other) {
+    clockOffsetUs = other.clockOffsetUs;
+    clockSet = other.clockSet;
+}
+
+uint8_t OccupancyHeatmap::hourOf(uint64_t timestampUs) const {
+    return (uint8_t)(((timestampUs + clockOffsetUs) % US_PER_DAY) / US_PER_HOUR);
+}
+
+uint16_t OccupancyHeatmap::get(uint16_t channelIndex, uint8_t hour) const {
+    if (channelIndex >= channelCount || hour >= OCCUPANCY_HOURS) return 0;
+    return cells[(size_t)channelIndex * OCCUPANCY_HOURS + hour];
+}
+
+bool OccupancyHeatmap::load() {
+    if (channelCount == 0 || !mountFilesystem()) {
+        return false;
+    }
+    
+    File file = LittleFS.open(OCCUPANCY_FILE, "r");
+    if (!file) {
+        return false;
+    }
+    
+    FileHeader header;
+    bool ok = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              header.magic == OCCUPANCY_MAGIC &&
+              header.version == OCCUPANCY_VERSION &&
+              header.hours == OCCUPANCY_HOURS &&
+              header.channelCount == channelCount &&
+              header.planId == planId;
+    if (ok) {
+        size_t bytes = cells.size() * sizeof(uint16_t);
+        ok = file.read((uint8_t*)cells.data(), bytes) == bytes;
+    }
+    file.close();
+    
+    if (!ok) {
+        // 计划变化或文件损坏：从空表开始，下次检查点覆盖
+        std::fill(cells.begin(), cells.end(), 0);
+        USBSerial.println("[Occupancy] Checkpoint does not match channel plan, starting empty");
+        return false;
+    }
+    
+    peak = 0;
+    for (uint16_t value : cells) {
+        if (value > peak) peak = value;
+    }
+    USBSerial.printf("[Occupancy] Restored %u channels x %u hours\n", channelCount, OCCUPANCY_HOURS);
+    return true;
+}
+
+bool OccupancyHeatmap::save() {
+    if (channelCount == 0 || !mountFilesystem()) {
+        return false;
+    }
+    
+    // 先清标记：写入期间的新计数留给下一次检查点
+    dirty = false;
+    
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = OCCUPANCY_MAGIC;
+    header.version = OCCUPANCY_VERSION;
+    header.hours = OCCUPANCY_HOURS;
+    header.channelCount = channelCount;
+    header.planId = planId;
+    
+    File file = LittleFS.open(OCCUPANCY_TEMP_FILE, "w");
+    if (!file) {
+        dirty = true;
+        return false;
+    }
+    size_t bytes = cells.size() * sizeof(uint16_t);
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+              file.write((const uint8_t*)cells.data(), bytes) == bytes;
+    file.close();
+    
+    // LittleFS 的改名原子地替换目标文件
+    if (ok) {
+        ok = LittleFS.rename(OCCUPANCY_TEMP_FILE, OCCUPANCY_FILE);
+    }
+    
+    if (!ok) {
+        dirty = true;
+        USBSerial.println("[Occupancy] Checkpoint write failed");
+        return false;
+    }
+    
+    USBSerial.printf("[Occupancy] Checkpoint saved (%u bytes)\n", (unsigned)(sizeof(header) + bytes));
+    return true;
+}
+
+bool OccupancyHeatmap::checkpointIfDue(uint32_t nowMs) {
+    if (!dirty || nowMs - lastCheckpointMs < OCCUPANCY_CHECKPOINT_MS) {
+        return false;
+    }
+    
+    lastCheckpointMs = nowMs;
+    return save();
+}
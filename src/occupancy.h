@@ -0,0 +1,73 @@
+#ifndef OCCUPANCY_H
+#define OCCUPANCY_H
+
+#include "common.h"
+#include <vector>
+
+// 占用热力图：频点 × 一天中的小时，每格一个 16 位计数
+const uint8_t OCCUPANCY_HOURS = 24;
+// 统计的频点上限，完整 831 频点计划约占 40 KB；超出的频点不计数
+const uint16_t OCCUPANCY_MAX_CHANNELS = 1024;
+// 任一格到达上限时全表减半：保持各格的相对比例，旧的活动随之逐步淡出
+const uint16_t OCCUPANCY_CELL_MAX = 0xFFFF;
+// 检查点间隔：只在有新计数时写入闪存
+const uint32_t OCCUPANCY_CHECKPOINT_MS = 30UL * 60UL * 1000UL;
+// 检查点文件（LittleFS），先写临时文件再改名，断电时保留上一份
+const char* const OCCUPANCY_FILE = "/occupancy.bin";
+const char* const OCCUPANCY_TEMP_FILE = "/occupancy.tmp";
+
+class OccupancyHeatmap {
+public:
+    OccupancyHeatmap();
+    
+    // planId 标识频点计划，计划变化时不加载旧检查点
+    void setChannelCount(uint16_t count, uint32_t planId);
+    // 对应格计数加一，格满时全表减半（O(格数)，极少发生）。
+    // 检查点里的小时都是本地时间，时钟未设定前的事件不计入，以免与其混在一起
+    void add(uint16_t channelIndex, uint64_t timestampUs);
+    void clear();
+    
+    // 设定 nowUs 时刻是当天的第几秒（本地时间）。设备没有掉电保持的时钟，
+    // 偏移只对本次开机有效，每次开机后需重新设定
+    void setTimeOfDay(uint32_t secondsOfDay, uint64_t nowUs);
+    // 沿用另一张热力图的时钟设定（配置切换换新表时）
+    void copyClock(const OccupancyHeatmap& other);
+    bool isClockSet() const { return clockSet; }
+    uint8_t hourOf(uint64_t timestampUs) const;
+    
+    uint16_t getChannelCount() const { return channelCount; }
+    uint16_t get(uint16_t channelIndex, uint8_t hour) const;
+    // 任一格当前的最大计数，用于显示归一化
+    uint16_t getPeak() const { return peak; }
+    size_t getMemoryBytes() const { return cells.size() * sizeof(uint16_t); }
+    
+    bool isDirty() const { return dirty; }
+    bool load();
+    bool save();
+    // 有新计数且距上次检查点超过间隔时保存
+    bool checkpointIfDue(uint32_t nowMs);
+    
+private:
+    struct FileHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint8_t hours;
+        uint8_t reserved;
+        uint16_t channelCount;
+        uint16_t reserved2;
+        uint32_t planId;
+    };
+    
+    void halve();
+    
+    std::vector<uint16_t> cells;    // 按频点优先排列：index * 24 + hour
+    uint16_t channelCount;
+    uint32_t planId;
+    uint64_t clockOffsetUs;         // 加到单调时基上得到当天的微秒数
+    bool clockSet;
+    uint16_t peak;
+    volatile bool dirty;
+    uint32_t lastCheckpointMs;
+};
+
+#endif // OCCUPANCY_H
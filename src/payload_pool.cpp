@@ -0,0 +1,185 @@
+#include "payload_pool.h"
+#include <algorithm>
+
+// 尺寸类与槽位数，需与 ARENA_SIZE / TOTAL_SLOTS 保持一致
+static const uint16_t CLASS_SLOT_SIZE[PayloadPool::NUM_CLASSES]  = { 16, 32, 64, 128, 256 };
+static const uint16_t CLASS_SLOT_COUNT[PayloadPool::NUM_CLASSES] = { 64, 64, 48, 24, 12 };
+
+PayloadPool::PayloadPool() : overwriteCount(0) {
+    mux = portMUX_INITIALIZER_UNLOCKED;
+    
+    size_t arenaOffset = 0;
+    uint16_t slotOffset = 0;
+    for (uint8_t i = 0; i < NUM_CLASSES; i++) {
+        SizeClass& sc = classes[i];
+        sc.slotSize = CLASS_SLOT_SIZE[i];
+        sc.slotCount = CLASS_SLOT_COUNT[i];
+        sc.storage = arena + arenaOffset;
+        sc.slots = slotInfo + slotOffset;
+        arenaOffset += (size_t)sc.slotSize * sc.slotCount;
+        slotOffset += sc.slotCount;
+        for (uint16_t s = 0; s < sc.slotCount; s++) {
+            sc.slots[s].generation = 1;
+            sc.slots[s].length = 0;
+            sc.slots[s].used = false;
+        }
+        sc.head = 0;
+        sc.tail = 0;
+        sc.usedCount = 0;
+    }
+}
+
+PayloadHandle PayloadPool::makeHandle(uint8_t cls, uint16_t slot, uint16_t generation) {
+    return ((uint32_t)cls << 28) | ((uint32_t)(slot & 0x0FFF) << 16) | generation;
+}
+
+void PayloadPool::advanceTail(SizeClass& sc) {
+    // 跳过已释放的槽位，使 tail 始终指向最旧的在用槽位
+    while (sc.usedCount > 0 && !sc.slots[sc.tail].used) {
+        sc.tail = (sc.tail + 1) % sc.slotCount;
+    }
+    if (sc.usedCount == 0) {
+        sc.tail = sc.head;
+    }
+}
+
+void PayloadPool::evictOldest(SizeClass& sc) {
+    SlotInfo& slot = sc.slots[sc.tail];
+    slot.used = false;
+    slot.generation = slot.generation == 0xFFFF ? 1 : slot.generation + 1;
+    sc.usedCount--;
+    overwriteCount++;
+    sc.tail = (sc.tail + 1) % sc.slotCount;
+    advanceTail(sc);
+}
+
+PayloadHandle PayloadPool::store(const uint8_t* data, uint8_t length) {
+    if (!data || length == 0) return PAYLOAD_NONE;
+    
+    uint8_t cls = 0;
+    while (cls < NUM_CLASSES - 1 && classes[cls].slotSize < length) {
+        cls++;
+    }
+    
+    portENTER_CRITICAL(&mux);
+    
+    // 本尺寸类已满时优先借用更大尺寸类的空闲槽位，都满了才覆盖最旧的
+    uint8_t target = cls;
+    while (target < NUM_CLASSES && classes[target].usedCount >= classes[target].slotCount) {
+        target++;
+    }
+    if (target >= NUM_CLASSES) {
+        target = cls;
+        evictOldest(classes[target]);
+    }
+    
+    SizeClass& sc = classes[target];
+    // 正常情况下 head 处总是空闲的；乱序释放留下空洞时向后找一个空槽
+    while (sc.slots[sc.head].used) {
+        sc.head = (sc.head + 1) % sc.slotCount;
+    }
+    uint16_t slotIndex = sc.head;
+    SlotInfo& slot = sc.slots[slotIndex];
+    
+    slot.used = true;
+    slot.length = length;
+    memcpy(sc.storage + (size_t)slotIndex * sc.slotSize, data, length);
+    
+    sc.head = (sc.head + 1) % sc.slotCount;
+    sc.usedCount++;
+    
+    PayloadHandle handle = makeHandle(target, slotIndex, slot.generation);
+    portEXIT_CRITICAL(&mux);
+    
+    return handle;
+}
+
+void PayloadPool::release(PayloadHandle handle) {
+    if (handle == PAYLOAD_NONE) return;
+    
+    uint8_t cls = handle >> 28;
+    uint16_t slotIndex = (handle >> 16) & 0x0FFF;
+    uint16_t generation = handle & 0xFFFF;
+    if (cls >= NUM_CLASSES || slotIndex >= classes[cls].slotCount) return;
+    
+    portENTER_CRITICAL(&mux);
+    SizeClass& sc = classes[cls];
+    SlotInfo& slot = sc.slots[slotIndex];
+    
+    // 代数不符说明负载已被覆盖，句柄早已失效
+    if (slot.used && slot.generation == generation) {
+        slot.used = false;
+        slot.generation = slot.generation == 0xFFFF ? 1 : slot.generation + 1;
+        sc.usedCount--;
+        advanceTail(sc);
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+PayloadView PayloadPool::get(PayloadHandle handle) const {
+    if (!isValid(handle)) return PayloadView();
+    
+    uint8_t cls = handle >> 28;
+    uint16_t slotIndex = (handle >> 16) & 0x0FFF;
+    const SizeClass& sc = classes[cls];
+    
+    return PayloadView(sc.storage + (size_t)slotIndex * sc.slotSize, sc.slots[slotIndex].length);
+}
+
+uint8_t PayloadPool::copy(PayloadHandle handle, uint8_t* buffer, uint8_t cap) const {
+    if (handle == PAYLOAD_NONE) return 0;
+    
+    uint8_t cls = handle >> 28;
+    uint16_t slotIndex = (handle >> 16) & 0x0FFF;
+    if (cls >= NUM_CLASSES || slotIndex >= classes[cls].slotCount) return 0;
+    
+    // 与 store() 的覆盖互斥，复制到的一定是句柄对应的那一份负载
+    portENTER_CRITICAL(&mux);
+    const SizeClass& sc = classes[cls];
+    const SlotInfo& slot = sc.slots[slotIndex];
+    uint8_t length = 0;
+    if (slot.used && slot.generation == (handle & 0xFFFF)) {
+        length = std::min(slot.length, cap);
+        memcpy(buffer, sc.storage + (size_t)slotIndex * sc.slotSize, length);
+    }
+    portEXIT_CRITICAL(&mux);
+    
+    return length;
+}
+
+bool PayloadPool::isValid(PayloadHandle handle) const {
+    if (handle == PAYLOAD_NONE) return false;
+    
+    uint8_t cls = handle >> 28;
+    uint16_t slotIndex = (handle >> 16) & 0x0FFF;
+    if (cls >= NUM_CLASSES || slotIndex >= classes[cls].slotCount) return false;
+    
+    const SlotInfo& slot = classes[cls].slots[slotIndex];
+    return slot.used && slot.generation == (handle & 0xFFFF);
+}
+
+void PayloadPool::clear() {
+    portENTER_CRITICAL(&mux);
+    for (uint8_t i = 0; i < NUM_CLASSES; i++) {
+        SizeClass& sc = classes[i];
+        for (uint16_t s = 0; s < sc.slotCount; s++) {
+            if (sc.slots[s].used) {
+                sc.slots[s].used = false;
+                sc.slots[s].generation = sc.slots[s].generation == 0xFFFF ? 1 : sc.slots[s].generation + 1;
+            }
+        }
+        sc.head = 0;
+        sc.tail = 0;
+        sc.usedCount = 0;
+    }
+    portEXIT_CRITICAL(&mux);
+}
+
+size_t PayloadPool::getMemoryUsage() const {
+    size_t total = 0;
+    for (uint8_t i = 0; i < NUM_CLASSES; i++) {
+        total += (size_t)classes[i].slotSize * classes[i].slotCount;
+        total += sizeof(SlotInfo) * classes[i].slotCount;
+    }
+    return total;
+}
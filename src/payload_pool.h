@@ -0,0 +1,76 @@
+#ifndef PAYLOAD_POOL_H
+#define PAYLOAD_POOL_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// 负载句柄：[31:28] 尺寸类 | [27:16] 槽位 | [15:0] 代数，0 表示无负载
+typedef uint32_t PayloadHandle;
+const PayloadHandle PAYLOAD_NONE = 0;
+
+// 负载视图：直接指向池内存，不做拷贝
+struct PayloadView {
+    const uint8_t* data;
+    uint8_t length;
+    
+    PayloadView() : data(nullptr), length(0) {}
+    PayloadView(const uint8_t* d, uint8_t len) : data(d), length(len) {}
+    
+    bool empty() const { return data == nullptr || length == 0; }
+};
+
+// 固定容量的负载 slab 池
+// 尺寸类按常见 LoRa 帧长划分（传感器短帧 / LoRaWAN / Meshtastic / 最大帧），
+// 每个尺寸类是一个按分配顺序循环使用的 slab，分配和释放均为 O(1)，
+// 不做任何堆分配。雷达点按先进先出淘汰，因此每个尺寸类内的释放顺序
+// 与分配顺序一致；尺寸类用满时覆盖该类中最旧的负载，旧句柄随即失效。
+class PayloadPool {
+public:
+    static const uint8_t NUM_CLASSES = 5;
+    // 尺寸类总容量：16x64 + 32x64 + 64x48 + 128x24 + 256x12 字节
+    static const size_t ARENA_SIZE = 16 * 64 + 32 * 64 + 64 * 48 + 128 * 24 + 256 * 12;
+    static const uint16_t TOTAL_SLOTS = 64 + 64 + 48 + 24 + 12;
+    
+    PayloadPool();
+    
+    PayloadHandle store(const uint8_t* data, uint8_t length);
+    void release(PayloadHandle handle);
+    // 视图不受锁保护：其他任务可能随时覆盖该槽位，读完后须用 isValid() 复核
+    PayloadView get(PayloadHandle handle) const;
+    // 在锁内复制前 cap 字节，返回复制的字节数；句柄已失效时返回 0
+    uint8_t copy(PayloadHandle handle, uint8_t* buffer, uint8_t cap) const;
+    bool isValid(PayloadHandle handle) const;
+    void clear();
+    
+    uint32_t getOverwriteCount() const { return overwriteCount; }
+    size_t getMemoryUsage() const;
+    
+private:
+    struct SlotInfo {
+        uint16_t generation;
+        uint8_t length;
+        bool used;
+    };
+    
+    struct SizeClass {
+        uint16_t slotSize;
+        uint16_t slotCount;
+        uint8_t* storage;
+        SlotInfo* slots;
+        uint16_t head;      // 下一个分配的槽位
+        uint16_t tail;      // 最旧的已分配槽位
+        uint16_t usedCount;
+    };
+    
+    SizeClass classes[NUM_CLASSES];
+    uint8_t arena[ARENA_SIZE];
+    SlotInfo slotInfo[TOTAL_SLOTS];
+    uint32_t overwriteCount;
+    mutable portMUX_TYPE mux;
+    
+    void evictOldest(SizeClass& sc);
+    void advanceTail(SizeClass& sc);
+    static PayloadHandle makeHandle(uint8_t cls, uint16_t slot, uint16_t generation);
+};
+
+#endif // PAYLOAD_POOL_H
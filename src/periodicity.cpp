@@ -0,0 +1,184 @@
+#include "periodicity.h"
+
+PeriodicityDetector::PeriodicityDetector() {
+    clear();
+}
+
+void PeriodicityDetector::clear() {
+    memset(arrivals, 0, sizeof(arrivals));
+    count = 0;
+    head = 0;
+    periodMs = 0;
+    confidence = 0;
+}
+
+uint32_t PeriodicityDetector::getLastArrivalMs() const {
+    if (count == 0) return 0;
+    return arrivals[(head + HISTORY - 1) % HISTORY];
+}
+
+uint32_t PeriodicityDetector::getToleranceMs() const {
+    // 发送端晶振漂移和 LoRa 随机退避：至少 250 ms 或周期的 2%
+    uint32_t tol = periodMs / 50;
+    return tol < 250 ? 250 : tol;
+}
+
+void PeriodicityDetector::addArrival(uint32_t timeMs) {
+    arrivals[head] = timeMs;
+    head = (head + 1) % HISTORY;
+    if (count < HISTORY) count++;
+    
+    estimate();
+}
+
+void PeriodicityDetector::estimate() {
+    periodMs = 0;
+    confidence = 0;
+    if (count < PERIOD_MIN_MATCHES + 1) return;
+    
+    uint32_t intervals[HISTORY - 1];
+    uint8_t numIntervals = 0;
+    uint8_t oldest = (head + HISTORY - count) % HISTORY;
+    for (uint8_t i = 1; i < count; i++) {
+        uint32_t prev = arrivals[(oldest + i - 1) % HISTORY];
+        uint32_t cur = arrivals[(oldest + i) % HISTORY];
+        intervals[numIntervals++] = cur - prev;
+    }
+    
+    uint32_t bestPeriod = 0;
+    uint8_t bestMatches = 0;
+    
+    for (uint8_t i = 0; i < numIntervals; i++) {
+        for (uint8_t k = 1; k <= MAX_HARMONIC; k++) {
+            uint32_t candidate = intervals[i] / k;
+            if (candidate < PERIOD_MIN_MS || candidate > PERIOD_MAX_MS) continue;
+            
+            uint32_t tol = candidate / 50 < 250 ? 250 : candidate / 50;
+            uint8_t matches = 0;
+            uint64_t sumIntervals = 0;
+            uint32_t sumMultiples = 0;
+            
+            for (uint8_t j = 0; j < numIntervals; j++) {
+                uint32_t multiple = (intervals[j] + candidate / 2) / candidate;
+                if (multiple == 0) continue;
+                
+                int32_t error = (int32_t)(intervals[j] - multiple * candidate);
+                if (error < 0) error = -error;
+                if ((uint32_t)error <= tol * multiple) {
+                    matches++;
+                    sumIntervals += intervals[j];
+                    sumMultiples += multiple;
+                }
+            }
+            
+            // 吻合数相同时取较长的候选，避免把真实周期误判为其约数
+            if (matches > bestMatches || (matches == bestMatches && matches > 0 && candidate > bestPeriod)) {
+                bestMatches = matches;
+                // 用所有吻合间隔做最小二乘修正
+                bestPeriod = (uint32_t)(sumIntervals / sumMultiples);
+            }
+        }
+    }
+    
+    if (bestMatches >= PERIOD_MIN_MATCHES) {
+        periodMs = bestPeriod;
+        confidence = (uint8_t)(bestMatches * 100 / numIntervals);
+    }
+}
+
+uint32_t PeriodicityDetector::predictNext(uint32_t nowMs) const {
+    if (!hasPeriod()) return 0;
+    
+    uint32_t last = getLastArrivalMs();
+    uint32_t tol = getToleranceMs();
+    uint32_t elapsed = nowMs - last;
+    
+    // 跳过已经过去（超出容差）的周期
+    uint32_t periods = (elapsed + periodMs - tol) / periodMs;
+    if (periods == 0) periods = 1;
+    return last + periods * periodMs;
+}
+
+PeriodicityTracker::PeriodicityTracker() {
+    clear();
+}
+
+void PeriodicityTracker::clear() {
+    for (uint8_t i = 0; i < MAX_TRACKED; i++) {
+        slots[i].used = false;
+        slots[i].channelIndex = 0;
+        slots[i].lastSeenMs = 0;
+        slots[i].detector.clear();
+    }
+}
+
+void PeriodicityTracker::addArrival(uint16_t channelIndex, uint32_t timeMs) {
+    Slot* target = nullptr;
+    Slot* oldest = nullptr;
+    
+    for (uint8_t i = 0; i < MAX_TRACKED; i++) {
+        Slot& slot = slots[i];
+        if (slot.used && slot.channelIndex == channelIndex) {
+            target = &slot;
+            break;
+        }
+        if (!slot.used) {
+            if (!oldest || oldest->used) oldest = &slot;
+        } else if (!oldest || (oldest->used && timeMs - slot.lastSeenMs > timeMs - oldest->lastSeenMs)) {
+            oldest = &slot;
+        }
+    }
+    
+    if (!target) {
+        target = oldest;
+        target->used = true;
+        target->channelIndex = channelIndex;
+        target->detector.clear();
+    }
+    
+    target->lastSeenMs = timeMs;
+    target->detector.addArrival(timeMs);
+}
+
+bool PeriodicityTracker::nextPrediction(uint32_t nowMs, uint16_t* channelIndex,
+                                        uint32_t* predictedMs, uint32_t* toleranceMs) const {
+    bool found = false;
+    uint32_t bestDelay = 0;
+    
+    for (uint8_t i = 0; i < MAX_TRACKED; i++) {
+        const Slot& slot = slots[i];
+        if (!slot.used || !slot.detector.hasPeriod()) continue;
+        
+        uint32_t tol = slot.detector.getToleranceMs();
+        uint32_t predicted = slot.detector.predictNext(nowMs);
+        // 以“窗口开启时刻”比较先后，允许预测点落在容差内的过去
+        uint32_t delay = (int32_t)(predicted - tol - nowMs) < 0 ? 0 : predicted - tol - nowMs;
+        
+        if (!found || delay < bestDelay) {
+            found = true;
+            bestDelay = delay;
+            *channelIndex = slot.channelIndex;
+            *predictedMs = predicted;
+            *toleranceMs = tol;
+        }
+    }
+    
+    return found;
+}
+
+const PeriodicityDetector* PeriodicityTracker::find(uint16_t channelIndex) const {
+    for (uint8_t i = 0; i < MAX_TRACKED; i++) {
+        if (slots[i].used && slots[i].channelIndex == channelIndex) {
+            return &slots[i].detector;
+        }
+    }
+    return nullptr;
+}
+
+uint8_t PeriodicityTracker::getTrackedCount() const {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MAX_TRACKED; i++) {
+        if (slots[i].used) n++;
+    }
+    return n;
+}
@@ -0,0 +1,71 @@
+#ifndef PERIODICITY_H
+#define PERIODICITY_H
+
+#include "common.h"
+
+// 可识别的周期范围 (ms)
+const uint32_t PERIOD_MIN_MS = 2000;
+const uint32_t PERIOD_MAX_MS = 3600000;
+// 周期确认所需的最少吻合间隔数
+const uint8_t PERIOD_MIN_MATCHES = 3;
+
+// 单频点周期检测器
+// 跳频时大部分发送都会错过，观测到的到达间隔是真实周期的整数倍，
+// 因此对每个间隔取 1..MAX_HARMONIC 分之一作为候选周期，
+// 统计能被候选周期整除（在容差内）的间隔数，取吻合最多且最长的候选
+class PeriodicityDetector {
+public:
+    static const uint8_t HISTORY = 8;
+    static const uint8_t MAX_HARMONIC = 4;
+    
+    PeriodicityDetector();
+    
+    void addArrival(uint32_t timeMs);
+    void clear();
+    
+    bool hasPeriod() const { return periodMs != 0; }
+    uint32_t getPeriodMs() const { return periodMs; }
+    uint8_t getConfidence() const { return confidence; }   // 0-100
+    uint32_t getLastArrivalMs() const;
+    // 下一次预测到达时间（不早于 nowMs - 容差）
+    uint32_t predictNext(uint32_t nowMs) const;
+    uint32_t getToleranceMs() const;
+    
+private:
+    uint32_t arrivals[HISTORY];
+    uint8_t count;
+    uint8_t head;
+    uint32_t periodMs;
+    uint8_t confidence;
+    
+    void estimate();
+};
+
+// 周期跟踪器：只为有流量的频点分配检测器，数量固定，
+// 满时替换最久未见的频点，内存与信道计划大小无关
+class PeriodicityTracker {
+public:
+    static const uint8_t MAX_TRACKED = 32;
+    
+    PeriodicityTracker();
+    
+    void addArrival(uint16_t channelIndex, uint32_t timeMs);
+    void clear();
+    
+    // 在所有已确认周期的频点中找最早的预测到达，没有时返回 false
+    bool nextPrediction(uint32_t nowMs, uint16_t* channelIndex, uint32_t* predictedMs, uint32_t* toleranceMs) const;
+    const PeriodicityDetector* find(uint16_t channelIndex) const;
+    uint8_t getTrackedCount() const;
+    
+private:
+    struct Slot {
+        bool used;
+        uint16_t channelIndex;
+        uint32_t lastSeenMs;
+        PeriodicityDetector detector;
+    };
+    
+    Slot slots[MAX_TRACKED];
+};
+
+#endif // PERIODICITY_H
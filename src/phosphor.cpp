@@ -0,0 +1,144 @@
+#include "phosphor.h"
+
+// 各颜色最高亮度的 RGB，与逐点绘制时使用的 TFT_* 颜色一致
+static const uint8_t HUE_RGB[PHOSPHOR_HUE_COUNT][3] = {
+    {0, 255, 0},        // TFT_GREEN
+    {255, 255, 0},      // TFT_YELLOW
+    {255, 165, 0},      // TFT_ORANGE
+    {255, 0, 0}         // TFT_RED
+};
+
+PhosphorLayer::PhosphorLayer()
+    : sprite(nullptr), width(0), height(0), stepUs(1), lastDecayUs(0),
+      lit(false), stampedAny(false), lastSequence(0) {
+}
+
+PhosphorLayer::~PhosphorLayer() {
+    delete sprite;
+}
+
+bool PhosphorLayer::allocate(M5Canvas* parent, uint16_t w, uint16_t h, uint32_t step) {
+    if (sprite) return true;
+    
+    sprite = new M5Canvas(parent);
+    sprite->setColorDepth(8);
+    if (!sprite->createSprite(w, h) || !sprite->createPalette()) {
+        USBSerial.println("[Phosphor] Layer unavailable, drawing points per frame");
+        delete sprite;
+        sprite = nullptr;
+        return false;
+    }
+    
+    // 亮度最低一级仍保留约 1/4，避免余辉尾部与背景难以区分
+    sprite->setPaletteColor(0, 0, 0, 0);
+    for (uint8_t hue = 0; hue < PHOSPHOR_HUE_COUNT; hue++) {
+        for (uint8_t level = 1; level <= PHOSPHOR_LEVELS; level++) {
+            uint16_t scale = 64 + (uint16_t)191 * level / PHOSPHOR_LEVELS;
+            sprite->setPaletteColor(1 + hue * PHOSPHOR_LEVELS + level - 1,
+                                    HUE_RGB[hue][0] * scale / 255,
+                                    HUE_RGB[hue][1] * scale / 255,
+                                    HUE_RGB[hue][2] * scale / 255);
+        }
+    }
+    
+    width = w;
+    height = h;
+    stepUs = step > 0 ? step : 1;
+    clear();
+    return true;
+}
+
+void PhosphorLayer::clear() {
+    if (sprite) sprite->fillSprite(0);
+    lit = false;
+    stampedAny = false;
+    lastDecayUs = 0;
+}
+
+uint8_t PhosphorLayer::decay(uint64_t nowUs) {
+    // 首次调用或时钟回退（基准测试固定时钟）时只记下起点
+    if (lastDecayUs == 0 || nowUs < lastDecayUs) {
+        lastDecayUs = nowUs;
+        return 0;
+    }
+    
+    uint64_t steps = (nowUs - lastDecayUs) / stepUs;
+    if (steps == 0) return 0;
+    lastDecayUs += steps * stepUs;
+    uint8_t levels = steps < PHOSPHOR_LEVELS ? steps : PHOSPHOR_LEVELS;
+    if (!lit || !sprite) return levels;
+    
+    if (levels >= PHOSPHOR_LEVELS) {
+        sprite->fillSprite(0);
+        lit = false;
+        return levels;
+    }
+    
+    fade[0] = 0;
+    for (uint16_t value = 1; value < 256; value++) {
+        uint8_t hue = (value - 1) / PHOSPHOR_LEVELS;
+        uint8_t level = (value - 1) % PHOSPHOR_LEVELS + 1;
+        fade[value] = (hue >= PHOSPHOR_HUE_COUNT || level <= levels) ? 0 :
+                      1 + hue * PHOSPHOR_LEVELS + level - levels - 1;
+    }
+    
+    uint8_t* pixel = (uint8_t*)sprite->getBuffer();
+    uint32_t length = sprite->bufferLength();
+    uint8_t any = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        if (pixel[i]) {
+            pixel[i] = fade[pixel[i]];
+            any |= pixel[i];
+        }
+    }
+    lit = any != 0;
+    return levels;
+}
+
+void PhosphorLayer::scroll(uint16_t dx) {
+    if (dx == 0 || !sprite || !lit) return;
+    if (dx >= width) {
+        sprite->fillSprite(0);
+        lit = false;
+        return;
+    }
+    
+    uint8_t* row = (uint8_t*)sprite->getBuffer();
+    if (!row) return;
+    uint32_t stride = sprite->bufferLength() / height;
+    for (uint16_t y = 0; y < height; y++, row += stride) {
+        memmove(row, row + dx, width - dx);
+        memset(row + width - dx, 0, dx);
+    }
+}
+
+uint8_t PhosphorLayer::stamp(int x, int y, uint8_t radius, PhosphorHue hue, uint64_t ageUs) {
+    uint64_t faded = ageUs / stepUs;
+    if (!sprite || faded >= PHOSPHOR_LEVELS) return 0;
+    
+    uint8_t level = PHOSPHOR_LEVELS - faded;
+    // 调色板精灵的绘制函数以调色板序号作为颜色
+    sprite->fillCircle(x, y, radius, 1 + hue * PHOSPHOR_LEVELS + level - 1);
+    lit = true;
+    return level;
+}
+
+void PhosphorLayer::compose(M5Canvas* dst, int x, int y) {
+    if (sprite && lit) {
+        sprite->pushSprite(dst, x, y, 0);
+    }
+}
+
+void PhosphorLayer::markStamped(uint32_t sequence) {
+    lastSequence = sequence;
+    stampedAny = true;
+}
+
+uint16_t PhosphorLayer::hueColor(PhosphorHue hue) {
+    switch (hue) {
+        case PHOSPHOR_GREEN: return TFT_GREEN;
+        case PHOSPHOR_YELLOW: return TFT_YELLOW;
+        case PHOSPHOR_ORANGE: return TFT_ORANGE;
+        default: return TFT_RED;
+    }
+}
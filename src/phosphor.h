@@ -0,0 +1,66 @@
+#ifndef PHOSPHOR_H
+#define PHOSPHOR_H
+
+#include <Arduino.h>
+#include <M5Cardputer.h>
+
+// 每种颜色的亮度级数：新点为最高级，每个衰减步长降一级，降到 0 熄灭
+const uint8_t PHOSPHOR_LEVELS = 16;
+// 雷达视图：32 秒完全熄灭，点离开环形缓冲区后仍能看到长期活动
+const uint32_t PHOSPHOR_RADAR_STEP_US = 2000000;
+// 实时监测：与 10 秒时间窗口一致
+const uint32_t PHOSPHOR_REALTIME_STEP_US = 625000;
+
+enum PhosphorHue {
+    PHOSPHOR_GREEN,
+    PHOSPHOR_YELLOW,
+    PHOSPHOR_ORANGE,
+    PHOSPHOR_RED,
+    PHOSPHOR_HUE_COUNT
+};
+
+// 余辉累积层：8 位调色板精灵，像素值 = 1 + 颜色 * 级数 + (亮度 - 1)，0 为透明
+// 新事件只打点一次，之后整层按时间查表衰减，每帧开销与历史点数无关
+class PhosphorLayer {
+public:
+    PhosphorLayer();
+    ~PhosphorLayer();
+    
+    // 首次使用时分配；失败返回 false，调用方退回逐点绘制
+    bool allocate(M5Canvas* parent, uint16_t width, uint16_t height, uint32_t stepUs);
+    bool ready() const { return sprite != nullptr; }
+    void clear();
+    
+    // 按距上次衰减经过的时间整体降级，返回本次降了几级
+    uint8_t decay(uint64_t nowUs);
+    // 整层左移 dx 像素，右侧补透明（时间轴滚动）
+    void scroll(uint16_t dx);
+    // 在层内坐标 (x, y) 打点，ageUs 为事件距今时间，按衰减速度折算亮度；已熄灭时返回 0
+    uint8_t stamp(int x, int y, uint8_t radius, PhosphorHue hue, uint64_t ageUs);
+    // 以透明色叠加到目标画布
+    void compose(M5Canvas* dst, int x, int y);
+    
+    // 全部熄灭（无需叠加）
+    bool dark() const { return !lit; }
+    
+    // 已打点的最新事件序号：事件序号单调递增，更大的序号即未打点的新事件
+    bool isNew(uint32_t sequence) const { return !stampedAny || (int32_t)(sequence - lastSequence) > 0; }
+    void markStamped(uint32_t sequence);
+    
+    uint16_t getWidth() const { return width; }
+    uint16_t getHeight() const { return height; }
+    static uint16_t hueColor(PhosphorHue hue);
+    
+private:
+    M5Canvas* sprite;
+    uint16_t width;
+    uint16_t height;
+    uint32_t stepUs;
+    uint64_t lastDecayUs;
+    bool lit;
+    bool stampedAny;
+    uint32_t lastSequence;
+    uint8_t fade[256];          // 像素值 → 衰减后的像素值，按本次级数生成
+};
+
+#endif // PHOSPHOR_H
@@ -0,0 +1,63 @@
+#include "point_ring.h"
+#include <algorithm>
+
+PointRing::PointRing() : start(0), count(0) {
+}
+
+void PointRing::setCapacity(size_t cap) {
+    if (cap == 0) cap = 1;
+    
+    buffer.assign(cap, RadarPoint());
+    start = 0;
+    count = 0;
+}
+
+bool PointRing::push(const RadarPoint& point, RadarPoint* evicted) {
+    if (buffer.empty()) {
+        setCapacity(1);
+    }
+    
+    if (count < buffer.size()) {
+        buffer[(start + count) % buffer.size()] = point;
+        count++;
+        return false;
+    }
+    
+    if (evicted) {
+        *evicted = buffer[start];
+    }
+    buffer[start] = point;
+    start = (start + 1) % buffer.size();
+    return true;
+}
+
+void PointRing::clear() {
+    start = 0;
+    count = 0;
+}
+
+bool PointRing::assignFrom(const PointRing& other) {
+    if (other.buffer.size() != buffer.size()) return false;
+    
+    std::copy(other.buffer.begin(), other.buffer.end(), buffer.begin());
+    start = other.start;
+    count = other.count;
+    return true;
+}
+
+void PointRing::swap(PointRing& other) {
+    buffer.swap(other.buffer);
+    std::swap(start, other.start);
+    std::swap(count, other.count);
+}
+
+RadarPoint* PointRing::findBySequence(uint32_t sequence) {
+    if (count == 0) return nullptr;
+    
+    // 点按序号递增写入，由最新点的序号即可算出位置
+    uint32_t age = (*this)[count - 1].sequence - sequence;
+    if (age >= count) return nullptr;
+    
+    RadarPoint& point = (*this)[count - 1 - age];
+    return point.sequence == sequence ? &point : nullptr;
+}
@@ -0,0 +1,57 @@
+#ifndef POINT_RING_H
+#define POINT_RING_H
+
+#include "common.h"
+
+// 雷达点环形缓冲区：容量固定，满后覆盖最旧的点，插入和淘汰均为 O(1)
+// 下标 0 为最旧的点，size() - 1 为最新的点
+class PointRing {
+public:
+    class const_iterator {
+    public:
+        const_iterator(const PointRing* r, size_t i) : ring(r), index(i) {}
+        const RadarPoint& operator*() const { return (*ring)[index]; }
+        const RadarPoint* operator->() const { return &(*ring)[index]; }
+        const_iterator& operator++() { index++; return *this; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        
+    private:
+        const PointRing* ring;
+        size_t index;
+    };
+    
+    PointRing();
+    
+    void setCapacity(size_t cap);
+    size_t capacity() const { return buffer.size(); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == buffer.size(); }
+    
+    // 写入新点；缓冲区已满时返回 true 并通过 evicted 带回被覆盖的最旧点
+    bool push(const RadarPoint& point, RadarPoint* evicted);
+    void clear();
+    // 复制另一个同容量缓冲区的内容，不分配内存（可在临界区内调用）
+    bool assignFrom(const PointRing& other);
+    // 与另一个缓冲区交换存储和内容，不分配内存（可在临界区内更换容量）
+    void swap(PointRing& other);
+    
+    const RadarPoint& operator[](size_t i) const { return buffer[(start + i) % buffer.size()]; }
+    RadarPoint& operator[](size_t i) { return buffer[(start + i) % buffer.size()]; }
+    const RadarPoint& front() const { return (*this)[0]; }
+    const RadarPoint& back() const { return (*this)[count - 1]; }
+    
+    // 按事件序号查找仍在缓冲区中的点，已被淘汰时返回 nullptr
+    RadarPoint* findBySequence(uint32_t sequence);
+    
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+    
+private:
+    std::vector<RadarPoint> buffer;
+    size_t start;
+    size_t count;
+};
+
+#endif // POINT_RING_H
@@ -0,0 +1,129 @@
+#include "power.h"
+#include "config.h"
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+
+PowerManager::PowerManager(LoRaAdapter* loraModule)
+    : lora(loraModule), lowPower(false), screenOff(false), radioLowPower(false),
+      lastRadioActivityMs(0), sessionStartUs(0), sleepUs(0), sleepCount(0),
+      radioWakeCount(0), sessionStartEvents(0), sessionStartBattery(0) {
+    // 优先使用 AUX 唤醒：E220 在串口输出前 2~3 ms 拉低 AUX，足够从浅睡眠恢复；
+    // 未连接 AUX 时退化为 RX 引脚唤醒，唤醒帧的前几个字节可能丢失
+    wakePin = LORA_E220_AUX_PIN >= 0 ? LORA_E220_AUX_PIN : LORA_E220_RX_PIN;
+}
+
+void PowerManager::setLowPower(bool enable, uint32_t totalEvents, uint8_t batteryPct) {
+    if (enable == lowPower) return;
+    
+    if (enable) {
+        sessionStartUs = esp_timer_get_time();
+        sleepUs = 0;
+        sleepCount = 0;
+        radioWakeCount = 0;
+        sessionStartEvents = totalEvents;
+        sessionStartBattery = batteryPct;
+        
+        setCpuFrequencyMhz(LOW_POWER_CPU_MHZ);
+        radioLowPower = lora && lora->setLowPowerMode(true);
+        lowPower = true;
+        
+        USBSerial.printf("[Power] Low-power scan enabled (CPU %lu MHz, radio %s)\n",
+            LOW_POWER_CPU_MHZ, radioLowPower ? "duty-cycled" : "in normal receive mode");
+    } else {
+        lowPower = false;
+        if (radioLowPower && lora) {
+            lora->setLowPowerMode(false);
+        }
+        radioLowPower = false;
+        setCpuFrequencyMhz(NORMAL_CPU_MHZ);
+        
+        USBSerial.println("[Power] Low-power scan disabled");
+        printReport(totalEvents, batteryPct);
+    }
+}
+
+bool PowerManager::isLowPower() const {
+    return lowPower;
+}
+
+void PowerManager::setScreenOff(bool off) {
+    screenOff = off;
+}
+
+void PowerManager::noteRadioActivity() {
+    lastRadioActivityMs = millis();
+}
+
+bool PowerManager::radioBusy() {
+    // 串口回调已把字节搬进适配器的帧缓冲，Serial2 本身可能为空
+    if (lora && lora->frameAvailable()) {
+        noteRadioActivity();
+        return true;
+    }
+    
+#if LORA_E220_AUX_PIN >= 0
+    if (digitalRead(LORA_E220_AUX_PIN) == LOW) {
+        noteRadioActivity();
+        return true;
+    }
+#endif
+    
+    return millis() - lastRadioActivityMs < LOW_POWER_RX_HOLD_MS;
+}
+
+bool PowerManager::idle(uint32_t maxSleepMs) {
+    // 只在息屏时睡眠：浅睡眠会打断进行中的 SPI 刷屏
+    if (!lowPower || !screenOff || radioBusy()) {
+        return false;
+    }
+    
+    esp_sleep_enable_timer_wakeup((uint64_t)maxSleepMs * 1000ULL);
+    gpio_wakeup_enable((gpio_num_t)wakePin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    
+    USBSerial.flush();
+    
+    int64_t start = esp_timer_get_time();
+    esp_light_sleep_start();
+    sleepUs += esp_timer_get_time() - start;
+    sleepCount++;
+    
+    gpio_wakeup_disable((gpio_num_t)wakePin);
+    
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO) {
+        radioWakeCount++;
+        noteRadioActivity();
+    }
+    
+    return true;
+}
+
+void PowerManager::printReport(uint32_t totalEvents, uint8_t batteryPct) {
+    if (sessionStartUs == 0) {
+        USBSerial.println("[Power] No low-power session recorded");
+        return;
+    }
+    
+    uint64_t endUs = esp_timer_get_time();
+    float elapsedH = (float)(endUs - sessionStartUs) / 3600e6f;
+    float sleepH = (float)sleepUs / 3600e6f;
+    float awakeH = elapsedH - sleepH;
+    if (elapsedH <= 0) return;
+    
+    float lowPowerMah = awakeH * CURRENT_LOW_POWER_AWAKE_MA + sleepH * CURRENT_LIGHT_SLEEP_MA;
+    float baselineMah = elapsedH * CURRENT_BASELINE_MA;
+    float avgMa = lowPowerMah / elapsedH;
+    uint32_t events = totalEvents - sessionStartEvents;
+    
+    // 电流为 power.h 中的估算常数（非实测），只有会话时长、睡眠占比和事件数是测得的
+    USBSerial.println("=== Power Report (currents estimated, not measured) ===");
+    USBSerial.printf("  Session: %.0f s, asleep %.1f %%, sleeps %lu (radio wakes %lu)\n",
+        elapsedH * 3600.0f, sleepH / elapsedH * 100.0f, sleepCount, radioWakeCount);
+    USBSerial.printf("  Avg current (est): %.1f mA, baseline %.1f mA\n", avgMa, CURRENT_BASELINE_MA);
+    USBSerial.printf("  Runtime @%.0f mAh (est): %.1f h, baseline %.1f h\n",
+        BATTERY_CAPACITY_MAH, BATTERY_CAPACITY_MAH / avgMa, BATTERY_CAPACITY_MAH / CURRENT_BASELINE_MA);
+    USBSerial.printf("  Events: %lu, per mAh (est): %.2f, baseline %.2f\n",
+        events, events / lowPowerMah, events / baselineMah);
+    USBSerial.printf("  Battery: %d%% -> %d%%\n", sessionStartBattery, batteryPct);
+}
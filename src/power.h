@@ -0,0 +1,56 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "common.h"
+#include "lora_adapter.h"
+
+// 低功耗模式下每次浅睡眠的最长时间 (ms)，同时决定键盘轮询间隔
+const uint32_t LOW_POWER_SLEEP_MS = 250;
+// 检测到无线电活动后保持唤醒的时间 (ms)，保证整帧被读出
+const uint32_t LOW_POWER_RX_HOLD_MS = 300;
+// 低功耗模式下的 CPU 频率 (MHz)
+const uint32_t LOW_POWER_CPU_MHZ = 80;
+const uint32_t NORMAL_CPU_MHZ = 240;
+
+// 续航估算参数（估算值，非实测）
+const float BATTERY_CAPACITY_MAH = 1520.0f;      // 机身 120 mAh + 底座 1400 mAh
+const float CURRENT_BASELINE_MA = 60.0f;         // 息屏但主循环/监听任务持续轮询 (240 MHz)
+const float CURRENT_LOW_POWER_AWAKE_MA = 35.0f;  // 低功耗模式唤醒期间 (80 MHz)
+const float CURRENT_LIGHT_SLEEP_MA = 13.0f;      // 浅睡眠 + E220 持续接收
+
+// 电源管理：息屏后在 RX 窗口之间进入浅睡眠，由定时器或无线电活动唤醒
+class PowerManager {
+private:
+    LoRaAdapter* lora;
+    bool lowPower;
+    bool screenOff;
+    bool radioLowPower;
+    int wakePin;
+    
+    volatile uint32_t lastRadioActivityMs;
+    
+    // 本次低功耗会话的统计
+    uint64_t sessionStartUs;
+    uint64_t sleepUs;
+    uint32_t sleepCount;
+    uint32_t radioWakeCount;
+    uint32_t sessionStartEvents;
+    uint8_t sessionStartBattery;
+    
+    bool radioBusy();
+    
+public:
+    PowerManager(LoRaAdapter* loraModule);
+    
+    void setLowPower(bool enable, uint32_t totalEvents, uint8_t batteryPct);
+    bool isLowPower() const;
+    void setScreenOff(bool off);
+    void noteRadioActivity();
+    
+    // 系统空闲时进入浅睡眠，未睡眠时返回 false
+    bool idle(uint32_t maxSleepMs);
+    
+    void printReport(uint32_t totalEvents, uint8_t batteryPct);
+};
+
+#endif // POWER_H
@@ -0,0 +1,43 @@
+#include "quantile_sketch.h"
+
+RssiQuantileSketch::RssiQuantileSketch() {
+    clear();
+}
+
+void RssiQuantileSketch::clear() {
+    memset(bins, 0, sizeof(bins));
+    count = 0;
+}
+
+void RssiQuantileSketch::add(int16_t rssi) {
+    int16_t bin = (rssi - QUANTILE_MIN_RSSI) / QUANTILE_BIN_DB;
+    if (rssi < QUANTILE_MIN_RSSI) bin = 0;
+    if (bin >= QUANTILE_BINS) bin = QUANTILE_BINS - 1;
+    
+    // 总数到 32 位上限后不再计入，已有的分布保持不变
+    if (count == UINT32_MAX) return;
+    bins[bin]++;
+    count++;
+}
+
+int16_t RssiQuantileSketch::quantile(float q) const {
+    if (count == 0) return QUANTILE_MIN_RSSI;
+    
+    // 累计值用 double：32 位计数超出 float 的精确整数范围
+    q = constrain_float(q, 0.0f, 1.0f);
+    double target = (double)q * count;
+    double cumulative = 0;
+    
+    for (uint8_t i = 0; i < QUANTILE_BINS; i++) {
+        if (bins[i] == 0) continue;
+        
+        if (cumulative + bins[i] >= target) {
+            float fraction = (float)((target - cumulative) / bins[i]);
+            float value = QUANTILE_MIN_RSSI + (i + fraction) * QUANTILE_BIN_DB;
+            return (int16_t)floorf(value + 0.5f);
+        }
+        cumulative += bins[i];
+    }
+    
+    return QUANTILE_MIN_RSSI + QUANTILE_BINS * QUANTILE_BIN_DB - 1;
+}
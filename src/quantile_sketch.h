@@ -0,0 +1,30 @@
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include "common.h"
+
+// 固定区间 RSSI 分位数草图：-120 ~ -49 dBm，每格 2 dB，共 36 格
+const int16_t QUANTILE_MIN_RSSI = -120;
+const uint8_t QUANTILE_BIN_DB = 2;
+const uint8_t QUANTILE_BINS = 36;
+
+// 每格 32 位精确计数，不做衰减，分位数覆盖开始统计以来的全部样本；
+// 内存固定为 148 字节/频点（默认 84 频点计划约 12 KB）
+class RssiQuantileSketch {
+public:
+    RssiQuantileSketch();
+    
+    void add(int16_t rssi);
+    void clear();
+    
+    // q 取 0.0-1.0，格内线性插值；空草图返回 -120
+    int16_t quantile(float q) const;
+    uint32_t getCount() const { return count; }
+    bool empty() const { return count == 0; }
+    
+private:
+    uint32_t bins[QUANTILE_BINS];
+    uint32_t count;     // 各格之和
+};
+
+#endif // QUANTILE_SKETCH_H
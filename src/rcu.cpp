@@ -0,0 +1,72 @@
+#include "rcu.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+RcuDomain::RcuDomain() : version(1) {
+    for (uint8_t i = 0; i < RCU_READER_COUNT; i++) {
+        readers[i] = 0;
+    }
+}
+
+RcuDomain::~RcuDomain() {
+    // 析构时不再有读端
+    for (const Retired& item : retired) {
+        item.deleter(item.object);
+    }
+}
+
+void RcuDomain::readLock(RcuReader reader) {
+    // 先登记版本再读指针：写端先替换指针再推进版本，
+    // 因此登记到新版本的读端一定读到新指针
+    __atomic_store_n(&readers[reader], __atomic_load_n(&version, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+}
+
+void RcuDomain::readUnlock(RcuReader reader) {
+    __atomic_store_n(&readers[reader], 0, __ATOMIC_SEQ_CST);
+}
+
+uint32_t RcuDomain::advance() {
+    return __atomic_add_fetch(&version, 1, __ATOMIC_SEQ_CST);
+}
+
+void RcuDomain::retire(void* object, void (*deleter)(void*)) {
+    Retired item;
+    item.object = object;
+    item.deleter = deleter;
+    item.version = __atomic_load_n(&version, __ATOMIC_SEQ_CST);
+    retired.push_back(item);
+}
+
+bool RcuDomain::gracePassed(uint32_t retiredVersion) const {
+    for (uint8_t i = 0; i < RCU_READER_COUNT; i++) {
+        uint32_t seen = __atomic_load_n(&readers[i], __ATOMIC_SEQ_CST);
+        if (seen != 0 && seen < retiredVersion) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t RcuDomain::reclaim() {
+    size_t kept = 0;
+    for (size_t i = 0; i < retired.size(); i++) {
+        if (gracePassed(retired[i].version)) {
+            retired[i].deleter(retired[i].object);
+        } else {
+            retired[kept++] = retired[i];
+        }
+    }
+    retired.resize(kept);
+    return kept;
+}
+
+void RcuDomain::synchronize() {
+    // 读端临界区最长为一个接收窗口
+    while (reclaim() > 0) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+uint32_t RcuDomain::getVersion() const {
+    return __atomic_load_n(&version, __ATOMIC_SEQ_CST);
+}
@@ -0,0 +1,86 @@
+#ifndef RCU_H
+#define RCU_H
+
+#include <Arduino.h>
+#include <vector>
+
+// 读端槽位：每个在临界区内读取已发布对象的任务一个
+enum RcuReader {
+    RCU_READER_LISTEN,      // 监听任务，每个接收窗口一次
+    RCU_READER_CLASSIFY,    // 分类工作任务，每个分类结果一次
+    RCU_READER_COUNT
+};
+
+// RCU 风格的发布/回收：
+// 写端（单一任务）原子替换指针后把旧对象登记为待回收，并推进版本号；
+// 读端进入临界区时记下当时的版本号，离开时清零。
+// 旧对象在所有读端都已离开、或进入时已看到新版本之后才释放（宽限期）。
+// 写端任务本身不占槽位：它在自己的静止点调用 reclaim()，此时不持有旧指针
+class RcuDomain {
+public:
+    RcuDomain();
+    ~RcuDomain();
+    
+    void readLock(RcuReader reader);
+    void readUnlock(RcuReader reader);
+    
+    // 写端：替换指针之后调用，返回新版本号
+    uint32_t advance();
+    void retire(void* object, void (*deleter)(void*));
+    // 释放宽限期已过的旧对象，返回仍在等待的数量
+    size_t reclaim();
+    // 阻塞等待当前所有读端临界区结束，然后回收
+    void synchronize();
+    
+    uint32_t getVersion() const;
+    size_t getPendingCount() const { return retired.size(); }
+    
+private:
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        uint32_t version;   // 替换它的版本；读端槽位 < 该值时可能仍持有
+    };
+    
+    volatile uint32_t version;
+    volatile uint32_t readers[RCU_READER_COUNT];
+    std::vector<Retired> retired;
+    
+    bool gracePassed(uint32_t retiredVersion) const;
+};
+
+// 单个已发布对象。get() 只能在读端临界区内或写端任务中使用，
+// 返回的对象在离开临界区（写端：下次 reclaim）前一直有效。
+// 需要不可变版本时以 const 类型实例化，例如 RcuPointer<const ListenerConfig>
+template <typename T>
+class RcuPointer {
+public:
+    explicit RcuPointer(RcuDomain& domain) : domain(domain), current(nullptr) {}
+    
+    ~RcuPointer() {
+        delete current;
+    }
+    
+    T* get() const {
+        return __atomic_load_n(&current, __ATOMIC_SEQ_CST);
+    }
+    
+    // 发布新对象（取得所有权），旧对象在宽限期后释放
+    void publish(T* next) {
+        T* previous = __atomic_exchange_n(&current, next, __ATOMIC_SEQ_CST);
+        domain.advance();
+        if (previous) {
+            domain.retire(const_cast<void*>(static_cast<const void*>(previous)), destroy);
+        }
+    }
+    
+private:
+    static void destroy(void* object) {
+        delete static_cast<T*>(object);
+    }
+    
+    RcuDomain& domain;
+    T* current;
+};
+
+#endif // RCU_H
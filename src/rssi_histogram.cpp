@@ -0,0 +1,118 @@
+#include "rssi_histogram.h"
+#include <algorithm>
+
+RssiHistogram::RssiHistogram()
+    : numBins(0), cumulative(false), windowTotal(0), numChannels(0) {
+    setUniform(-120, -50, 10);
+}
+
+bool RssiHistogram::setEdges(const std::vector<int16_t>& newEdges) {
+    if (newEdges.size() < 2 || newEdges.size() > RSSI_HISTOGRAM_MAX_BINS + 1) {
+        return false;
+    }
+    
+    for (size_t i = 1; i < newEdges.size(); i++) {
+        if (newEdges[i] <= newEdges[i - 1]) return false;
+    }
+    
+    numBins = newEdges.size() - 1;
+    for (size_t i = 0; i < newEdges.size(); i++) {
+        edges[i] = newEdges[i];
+    }
+    
+    channelCounts.assign((size_t)numChannels * numBins, 0);
+    clear();
+    return true;
+}
+
+void RssiHistogram::setUniform(int16_t minRssi, int16_t maxRssi, uint8_t bins) {
+    if (bins == 0 || bins > RSSI_HISTOGRAM_MAX_BINS || maxRssi - minRssi < bins) return;
+    
+    std::vector<int16_t> uniform;
+    for (uint8_t i = 0; i <= bins; i++) {
+        uniform.push_back(minRssi + (int32_t)(maxRssi - minRssi) * i / bins);
+    }
+    setEdges(uniform);
+}
+
+void RssiHistogram::setChannelCount(uint16_t channels) {
+    numChannels = channels;
+    channelCounts.assign((size_t)numChannels * numBins, 0);
+    clearWindow();
+}
+
+void RssiHistogram::swapChannelTable(std::vector<uint16_t>& table, uint16_t channels) {
+    if (table.size() != (size_t)channels * numBins) return;
+    
+    channelCounts.swap(table);
+    numChannels = channels;
+}
+
+void RssiHistogram::setCumulative(bool enabled) {
+    cumulative = enabled;
+}
+
+uint8_t RssiHistogram::binFor(int16_t rssi) const {
+    // 区间不超过 16 个，直接线性查找
+    for (uint8_t i = 1; i < numBins; i++) {
+        if (rssi < edges[i]) return i - 1;
+    }
+    return numBins - 1;
+}
+
+void RssiHistogram::add(int16_t rssi, uint16_t channel) {
+    uint8_t bin = binFor(rssi);
+    
+    windowCounts[bin]++;
+    windowTotal++;
+    if (channel < numChannels) {
+        channelCounts[(size_t)channel * numBins + bin]++;
+    }
+    if (cumulative) {
+        cumulativeCounts[bin]++;
+    }
+}
+
+void RssiHistogram::remove(int16_t rssi, uint16_t channel) {
+    uint8_t bin = binFor(rssi);
+    
+    if (windowCounts[bin] > 0) windowCounts[bin]--;
+    if (windowTotal > 0) windowTotal--;
+    if (channel < numChannels) {
+        uint16_t& count = channelCounts[(size_t)channel * numBins + bin];
+        if (count > 0) count--;
+    }
+}
+
+void RssiHistogram::clearWindow() {
+    memset(windowCounts, 0, sizeof(windowCounts));
+    std::fill(channelCounts.begin(), channelCounts.end(), 0);
+    windowTotal = 0;
+}
+
+void RssiHistogram::clearCumulative() {
+    memset(cumulativeCounts, 0, sizeof(cumulativeCounts));
+}
+
+void RssiHistogram::clear() {
+    clearWindow();
+    clearCumulative();
+}
+
+void RssiHistogram::snapshot(uint16_t channel, RssiHistogramSnapshot* out) const {
+    out->binCount = numBins;
+    out->cumulative = cumulative;
+    out->windowTotal = windowTotal;
+    for (uint8_t bin = 0; bin <= numBins; bin++) {
+        out->edges[bin] = edges[bin];
+    }
+    for (uint8_t bin = 0; bin < numBins; bin++) {
+        out->counts[bin] = cumulative ? cumulativeCounts[bin] : windowCounts[bin];
+        out->channelCounts[bin] = getChannelCount(channel, bin);
+    }
+}
+
+uint16_t RssiHistogram::getChannelCount(uint16_t channel, uint8_t bin) const {
+    if (channel >= numChannels || bin >= numBins) return 0;
+    return channelCounts[(size_t)channel * numBins + bin];
+}
@@ -0,0 +1,67 @@
+#ifndef RSSI_HISTOGRAM_H
+#define RSSI_HISTOGRAM_H
+
+#include "common.h"
+
+const uint8_t RSSI_HISTOGRAM_MAX_BINS = 16;
+
+// 绘制用的直方图快照：分箱、全局计数与一个频点的窗口计数，复制开销 O(bins)
+struct RssiHistogramSnapshot {
+    uint8_t binCount;
+    bool cumulative;
+    uint32_t windowTotal;
+    int16_t edges[RSSI_HISTOGRAM_MAX_BINS + 1];
+    uint32_t counts[RSSI_HISTOGRAM_MAX_BINS];          // cumulative 时为累计计数，否则为窗口计数
+    uint16_t channelCounts[RSSI_HISTOGRAM_MAX_BINS];   // 所选频点的窗口计数
+    
+    RssiHistogramSnapshot() : binCount(0), cumulative(false), windowTotal(0) {}
+};
+
+// 增量维护的 RSSI 直方图
+// 窗口计数随雷达点进出环形缓冲区增减（全局 + 按频点），
+// 可选的累计计数只增不减，与 maxPoints 无关；绘制只需 O(bins)
+class RssiHistogram {
+public:
+    RssiHistogram();
+    
+    // 边界升序，n 个边界对应 n-1 个区间；超出两端的值计入首/末区间
+    bool setEdges(const std::vector<int16_t>& edges);
+    void setUniform(int16_t minRssi, int16_t maxRssi, uint8_t bins);
+    void setChannelCount(uint16_t channels);
+    // 换入预先分配好的按频点计数表（channels × getBinCount()），旧表经 table 带回；
+    // 不分配内存，可在临界区内更换频点计划
+    void swapChannelTable(std::vector<uint16_t>& table, uint16_t channels);
+    void setCumulative(bool enabled);
+    bool isCumulative() const { return cumulative; }
+    
+    void add(int16_t rssi, uint16_t channel);
+    void remove(int16_t rssi, uint16_t channel);
+    // 窗口计数与环形缓冲区中的点一一对应，只能随缓冲区一起清空
+    void clearWindow();
+    void clearCumulative();
+    void clear();
+    
+    uint8_t getBinCount() const { return numBins; }
+    int16_t getBinStart(uint8_t bin) const { return edges[bin]; }
+    int16_t getBinEnd(uint8_t bin) const { return edges[bin + 1]; }
+    uint8_t binFor(int16_t rssi) const;
+    
+    uint16_t getWindowCount(uint8_t bin) const { return windowCounts[bin]; }
+    uint16_t getChannelCount(uint16_t channel, uint8_t bin) const;
+    uint32_t getCumulativeCount(uint8_t bin) const { return cumulativeCounts[bin]; }
+    uint32_t getWindowTotal() const { return windowTotal; }
+    // 复制到快照；调用方负责与写端同步
+    void snapshot(uint16_t channel, RssiHistogramSnapshot* out) const;
+    
+private:
+    int16_t edges[RSSI_HISTOGRAM_MAX_BINS + 1];
+    uint8_t numBins;
+    bool cumulative;
+    uint32_t windowTotal;
+    uint16_t windowCounts[RSSI_HISTOGRAM_MAX_BINS];
+    uint32_t cumulativeCounts[RSSI_HISTOGRAM_MAX_BINS];
+    uint16_t numChannels;
+    std::vector<uint16_t> channelCounts;  // numChannels × numBins
+};
+
+#endif // RSSI_HISTOGRAM_H
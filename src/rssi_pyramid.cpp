@@ -0,0 +1,214 @@
+#include "rssi_pyramid.h"
+#include <algorithm>
+
+static int8_t clampRssi(int16_t rssi) {
+    return rssi < -128 ? -128 : (rssi > 127 ? 127 : rssi);
+}
+
+void PyramidBucket::clear() {
+    minRssi = 127;
+    maxRssi = -128;
+    meanRssi16 = 0;
+    count = 0;
+    errors = 0;
+}
+
+void PyramidBucket::add(int16_t rssi) {
+    int8_t value = clampRssi(rssi);
+    if (value < minRssi) minRssi = value;
+    if (value > maxRssi) maxRssi = value;
+    if (count == 0xFFFF) return;
+    
+    // 增量均值，按四舍五入取整，避免截断误差单向累积
+    count++;
+    int32_t delta = (int32_t)value * 16 - meanRssi16;
+    int32_t half = count / 2;
+    meanRssi16 += (delta >= 0 ? delta + half : delta - half) / (int32_t)count;
+}
+
+void PyramidBucket::addError() {
+    if (errors < 0xFFFF) errors++;
+}
+
+void PyramidBucket::merge(const PyramidBucket& other) {
+    if (other.count > 0) {
+        if (other.minRssi < minRssi) minRssi = other.minRssi;
+        if (other.maxRssi > maxRssi) maxRssi = other.maxRssi;
+        uint32_t total = (uint32_t)count + other.count;
+        meanRssi16 = ((int32_t)meanRssi16 * count + (int32_t)other.meanRssi16 * other.count) / (int32_t)total;
+        count = total > 0xFFFF ? 0xFFFF : total;
+    }
+    uint32_t totalErrors = (uint32_t)errors + other.errors;
+    errors = totalErrors > 0xFFFF ? 0xFFFF : totalErrors;
+}
+
+RssiPyramid::RssiPyramid() : followedChannel(CHANNEL_NONE) {
+    // 全部桶在构造时一次分配，add 在监听器的临界区内调用，不能分配内存
+    initSeries(global, CHANNEL_NONE, 0);
+    for (uint8_t i = 0; i < PYRAMID_CHANNEL_SLOTS; i++) {
+        initSeries(channels[i], CHANNEL_NONE, PYRAMID_CHANNEL_FIRST_LEVEL);
+    }
+}
+
+void RssiPyramid::initSeries(Series& series, uint16_t channel, uint8_t firstLevel) {
+    series.firstLevel = firstLevel;
+    size_t total = 0;
+    for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+        series.offset[level] = total;
+        if (level >= firstLevel) total += PYRAMID_LEVEL_TABLE[level].buckets;
+    }
+    series.buckets.resize(total);
+    resetSeries(series, channel);
+}
+
+void RssiPyramid::resetSeries(Series& series, uint16_t channel) {
+    series.channel = channel;
+    series.started = false;
+    series.lastUseUs = 0;
+    for (auto& bucket : series.buckets) {
+        bucket.clear();
+    }
+    for (uint8_t level = 0; level < PYRAMID_LEVELS; level++) {
+        series.head[level] = 0;
+    }
+}
+
+void RssiPyramid::clear() {
+    resetSeries(global, CHANNEL_NONE);
+    clearChannels();
+}
+
+void RssiPyramid::clearChannels() {
+    for (uint8_t i = 0; i < PYRAMID_CHANNEL_SLOTS; i++) {
+        resetSeries(channels[i], CHANNEL_NONE);
+    }
+}
+
+void RssiPyramid::addToSeries(Series& series, uint64_t timestampUs, int16_t rssi, bool error) {
+    for (uint8_t level = series.firstLevel; level < PYRAMID_LEVELS; level++) {
+        const PyramidLevel& spec = PYRAMID_LEVEL_TABLE[level];
+        uint32_t index = timestampUs / ((uint64_t)spec.bucketMs * US_PER_MS);
+        PyramidBucket* ring = &series.buckets[series.offset[level]];
+        uint32_t& head = series.head[level];
+    
+        if (!series.started) {
+            head = index;
+        } else if (index > head) {
+            // 时间前进：清空新进入环的桶，超过一圈时整层清空
+            uint32_t steps = index - head;
+            if (steps >= spec.buckets) {
+                for (uint16_t i = 0; i < spec.buckets; i++) ring[i].clear();
+            } else {
+                for (uint32_t i = 1; i <= steps; i++) ring[(head + i) % spec.buckets].clear();
+            }
+            head = index;
+        } else if (head - index >= spec.buckets) {
+            // 早于本层保留范围
+            continue;
+        }
+    
+        PyramidBucket& bucket = ring[index % spec.buckets];
+        if (error) {
+            bucket.addError();
+        } else {
+            bucket.add(rssi);
+        }
+    }
+    series.started = true;
+}
+
+void RssiPyramid::add(uint16_t channel, uint64_t timestampUs, int16_t rssi, bool error) {
+    addToSeries(global, timestampUs, rssi, error);
+    if (channel == CHANNEL_NONE) return;
+    
+    uint16_t followed = followedChannel;
+    Series* victim = nullptr;
+    Series* series = nullptr;
+    for (uint8_t i = 0; i < PYRAMID_CHANNEL_SLOTS; i++) {
+        if (channels[i].channel == channel) {
+            series = &channels[i];
+            break;
+        }
+        // 跟随频点的槽位不参与替换
+        bool pinned = followed != CHANNEL_NONE && channels[i].channel == followed;
+        if (!pinned && (!victim || channels[i].lastUseUs < victim->lastUseUs)) {
+            victim = &channels[i];
+        }
+    }
+    
+    if (!series) {
+        // 没有空闲槽位时该频点只计入全局；跟随的频点总是抢占最久未用的槽位
+        if (!victim) return;
+        bool idle = victim->channel == CHANNEL_NONE || channel == followed ||
+                    (timestampUs > victim->lastUseUs && timestampUs - victim->lastUseUs >= PYRAMID_CHANNEL_IDLE_US);
+        if (!idle) return;
+        series = victim;
+        resetSeries(*series, channel);
+    }
+    if (timestampUs > series->lastUseUs) {
+        series->lastUseUs = timestampUs;
+    }
+    addToSeries(*series, timestampUs, rssi, error);
+}
+
+const RssiPyramid::Series* RssiPyramid::findSeries(uint16_t channel) const {
+    if (channel == CHANNEL_NONE) return &global;
+    for (uint8_t i = 0; i < PYRAMID_CHANNEL_SLOTS; i++) {
+        if (channels[i].channel == channel) return &channels[i];
+    }
+    return nullptr;
+}
+
+bool RssiPyramid::render(uint16_t channel, uint64_t startUs, uint64_t endUs, PyramidBucket* out, uint16_t columns) const {
+    for (uint16_t c = 0; c < columns; c++) {
+        out[c].clear();
+    }
+    
+    const Series* series = findSeries(channel);
+    if (!series || !series->started || endUs <= startUs || columns == 0) return false;
+    
+    // 能覆盖 startUs 的最细一层；都不能覆盖时用最粗一层
+    uint8_t level = series->firstLevel;
+    for (; level < PYRAMID_LEVELS - 1; level++) {
+        const PyramidLevel& spec = PYRAMID_LEVEL_TABLE[level];
+        uint64_t bucketUs = (uint64_t)spec.bucketMs * US_PER_MS;
+        uint32_t head = series->head[level];
+        uint64_t oldestUs = head >= spec.buckets ? (uint64_t)(head - spec.buckets + 1) * bucketUs : 0;
+        if (startUs >= oldestUs) break;
+    }
+    
+    const PyramidLevel& spec = PYRAMID_LEVEL_TABLE[level];
+    uint64_t bucketUs = (uint64_t)spec.bucketMs * US_PER_MS;
+    const PyramidBucket* ring = &series->buckets[series->offset[level]];
+    uint32_t head = series->head[level];
+    uint32_t oldest = head >= spec.buckets ? head - spec.buckets + 1 : 0;
+    
+    uint32_t first = std::max((uint64_t)oldest, startUs / bucketUs);
+    uint32_t last = std::min((uint64_t)head, (endUs - 1) / bucketUs);
+    uint64_t spanUs = endUs - startUs;
+    bool any = false;
+    
+    for (uint32_t index = first; index <= last && index >= first; index++) {
+        const PyramidBucket& bucket = ring[index % spec.buckets];
+        if (bucket.empty()) continue;
+    
+        // 桶覆盖的列：桶比列宽时写入多列，比列窄时多个桶合并到一列
+        uint64_t bucketStart = (uint64_t)index * bucketUs;
+        uint64_t bucketEnd = bucketStart + bucketUs;
+        uint16_t colFirst = bucketStart <= startUs ? 0 : (bucketStart - startUs) * columns / spanUs;
+        uint16_t colLast = bucketEnd >= endUs ? columns - 1 : (bucketEnd - 1 - startUs) * columns / spanUs;
+        for (uint16_t c = colFirst; c <= colLast; c++) {
+            out[c].merge(bucket);
+        }
+        any = true;
+    }
+    return any;
+}
+
+size_t RssiPyramid::getMemoryBytes() const {
+    size_t bytes = global.buckets.size() * sizeof(PyramidBucket);
+    for (uint8_t i = 0; i < PYRAMID_CHANNEL_SLOTS; i++) {
+        bytes += channels[i].buckets.size() * sizeof(PyramidBucket);
+    }
+    return bytes;
+}
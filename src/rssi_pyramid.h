@@ -0,0 +1,87 @@
+#ifndef RSSI_PYRAMID_H
+#define RSSI_PYRAMID_H
+
+#include "common.h"
+
+// 金字塔的一层：桶宽 × 桶数 = 覆盖时长
+struct PyramidLevel {
+    uint32_t bucketMs;
+    uint16_t buckets;
+};
+
+const uint8_t PYRAMID_LEVELS = 5;
+// 由细到粗：1 分钟、10 分钟、30 分钟、3 小时、24 小时；相邻两层桶宽相差不超过 10 倍
+const PyramidLevel PYRAMID_LEVEL_TABLE[PYRAMID_LEVELS] = {
+    {100, 600},
+    {1000, 600},
+    {10000, 180},
+    {60000, 180},
+    {600000, 144}
+};
+const uint64_t PYRAMID_MAX_SPAN_US = 24ULL * 3600ULL * US_PER_SEC;
+// 按频点的金字塔从 10 s 层开始（约 4 KB/频点），全局约 13.6 KB，合计约 30 KB
+const uint8_t PYRAMID_CHANNEL_FIRST_LEVEL = 2;
+// 同时跟踪的频点数：扫描时各频点轮流出现事件，按最近使用替换会不停清空槽位，
+// 因此只有空闲超过 PYRAMID_CHANNEL_IDLE_US 的槽位才让给新频点；界面跟随的频点例外（见 follow）
+const uint8_t PYRAMID_CHANNEL_SLOTS = 4;
+const uint64_t PYRAMID_CHANNEL_IDLE_US = 10ULL * 60ULL * US_PER_SEC;
+
+// 一个时间桶，或绘制时合并后的一列；只有成功接收计入 RSSI
+struct PyramidBucket {
+    int8_t minRssi;
+    int8_t maxRssi;
+    int16_t meanRssi16;     // 平均 RSSI × 16
+    uint16_t count;         // 成功接收数（饱和）
+    uint16_t errors;        // 错误事件数（饱和）
+    
+    void clear();
+    void add(int16_t rssi);
+    void addError();
+    void merge(const PyramidBucket& other);
+    bool empty() const { return count == 0 && errors == 0; }
+    int16_t mean() const { return (meanRssi16 + (meanRssi16 < 0 ? -8 : 8)) / 16; }
+};
+
+// 多分辨率 RSSI 金字塔（全局 + 按频点）：每层是一个按时间分桶的环，
+// 插入时各层 O(1) 更新；绘制任意时间范围只需扫描一层，开销与屏幕宽度同量级
+class RssiPyramid {
+public:
+    RssiPyramid();
+    
+    void add(uint16_t channel, uint64_t timestampUs, int16_t rssi, bool error);
+    // 界面跟随的频点（CHANNEL_NONE 为不跟随），可由其他任务设置：该频点没有槽位时
+    // 下一次事件直接替换最久未用的槽位，已有的槽位不会让给其他频点
+    void follow(uint16_t channel) { followedChannel = channel; }
+    void clear();
+    // 频点计划更换后，按频点的部分随旧的频点索引一起作废
+    void clearChannels();
+    
+    // 把 [startUs, endUs) 均分为 columns 列，每列合并落入其中的桶；channel 为 CHANNEL_NONE 时取全局。
+    // 选能覆盖 startUs 的最细一层，扫描的桶数不超过该层桶数。返回是否有任一列有数据
+    bool render(uint16_t channel, uint64_t startUs, uint64_t endUs, PyramidBucket* out, uint16_t columns) const;
+    bool hasChannel(uint16_t channel) const { return findSeries(channel) != nullptr; }
+    size_t getMemoryBytes() const;
+    
+private:
+    // 一组层：各层的桶连续存放，offset 为各层在 buckets 中的起点
+    struct Series {
+        uint16_t channel;
+        uint8_t firstLevel;
+        bool started;
+        uint64_t lastUseUs;             // 最近一次事件的时间
+        uint32_t head[PYRAMID_LEVELS];      // 各层最新桶的序号（时间 / 桶宽）
+        uint16_t offset[PYRAMID_LEVELS];
+        std::vector<PyramidBucket> buckets;
+    };
+    
+    Series global;
+    Series channels[PYRAMID_CHANNEL_SLOTS];
+    volatile uint16_t followedChannel;
+    
+    static void initSeries(Series& series, uint16_t channel, uint8_t firstLevel);
+    static void resetSeries(Series& series, uint16_t channel);
+    static void addToSeries(Series& series, uint64_t timestampUs, int16_t rssi, bool error);
+    const Series* findSeries(uint16_t channel) const;
+};
+
+#endif // RSSI_PYRAMID_H
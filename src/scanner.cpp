@@ -1,11 +1,19 @@
 #include "scanner.h"
 #include "display.h"
 #include "statistics.h"
+#include "boot_timing.h"
+#include "metrics.h"
 #include <M5Cardputer.h>
 
 FrequencyListener::FrequencyListener(LoRaAdapter* loraModule)
     : lora(loraModule), listenTaskHandle(nullptr),
-      isListening(false), shouldStop(false), lastEventTime(0), scopeDisplay(nullptr) {
+      isListening(false), shouldStop(false), lastEventTime(0),
+      config(rcu), tables(rcu), currentFreqIndex(0), currentRate(0), nextSequence(1),
+      pointsResetEpoch(0), scopeDisplay(nullptr) {
+    // 始终有一个已发布版本，init 失败时访问器也不会取到空指针
+    config.publish(new ListenerConfig());
+    tables.publish(new ChannelTables());
+    rcu.reclaim();
 }
 
 FrequencyListener::~FrequencyListener() {
@@ -13,45 +21,105 @@ FrequencyListener::~FrequencyListener() {
 }
 
 bool FrequencyListener::init(const ListenerConfig& cfg) {
-    config = cfg;
+    config.publish(new ListenerConfig(cfg));
+    currentFreqIndex = cfg.currentFreqIndex;
+    radarPoints.setCapacity(cfg.maxPoints);
+    payloadPool.clear();
+    
+    if (!cfg.rssiBinEdges.empty() && !rssiHistogram.setEdges(cfg.rssiBinEdges)) {
+        USBSerial.println("[Listener] Invalid RSSI bin edges, using defaults");
+    }
+    rssiHistogram.setChannelCount(cfg.plan->size());
+    rssiHistogram.setCumulative(cfg.cumulativeHistogram);
+    
+    if (!classifier.begin(&payloadPool, onClassified, this)) {
+        USBSerial.println("[Listener] Protocol classification unavailable");
+    }
     
     if (!lora || !lora->init()) {
         USBSerial.println("[Listener] Failed to initialize LoRa adapter");
         return false;
     }
     
-    if (config.frequencies.empty()) {
+    if (cfg.plan->empty()) {
         USBSerial.println("[Listener] No frequencies configured");
         return false;
     }
     
-    if (!setFrequency(config.frequencies[config.currentFreqIndex].frequency)) {
-        USBSerial.println("[Listener] Failed to set initial frequency");
-        return false;
-    }
+    tables.publish(buildTables(cfg, nullptr, true));
+    currentRate = 0;
     
-    if (!lora->setBandwidth(config.bandwidth)) {
-        USBSerial.println("[Listener] Failed to set bandwidth");
+    // 频率/带宽/扩频因子/编码率合并为一次写入，与模块现有配置相同则跳过
+    FrequencyConfig initial = radioSettingsFor(cfg, *tables.get(), currentFreqIndex, currentRate);
+    
+    if (!lora->applySettings(initial)) {
+        USBSerial.println("[Listener] Failed to apply initial radio settings");
+        return false;
     }
     
-    delay(20);
+    USBSerial.printf("[Listener] Initialized with %d frequencies, RX window: %u ms\n", 
+        cfg.plan->size(), cfg.rxWindowMs);
     
-    if (!lora->setSpreadingFactor(config.spreadingFactor)) {
-        USBSerial.println("[Listener] Failed to set spreading factor");
+    return true;
+}
+
+std::vector<DataRate> FrequencyListener::effectiveRates(const ListenerConfig& cfg) const {
+    std::vector<DataRate> rates;
+    for (const auto& rate : cfg.dataRates) {
+        if (lora->supportsDataRate(rate.spreadingFactor, rate.bandwidth)) {
+            rates.push_back(rate);
+        } else {
+            USBSerial.printf("[Listener] SF%d/%d kHz not supported by %s, skipped\n",
+                rate.spreadingFactor, rate.bandwidth, lora->getModuleName().c_str());
+        }
     }
+    if (rates.empty()) {
+        rates.push_back(DataRate(cfg.spreadingFactor, cfg.bandwidth));
+    }
+    return rates;
+}
+
+ChannelTables* FrequencyListener::buildTables(const ListenerConfig& cfg, const ChannelTables* previous,
+                                              bool planChanged) const {
+    ChannelTables* built = new ChannelTables();
+    size_t channels = cfg.plan->size();
     
-    delay(20);
-    
-    if (!lora->setCodingRate(config.codingRate)) {
-        USBSerial.println("[Listener] Failed to set coding rate");
+    built->rates = effectiveRates(cfg);
+    if (previous && !planChanged) {
+        // 只换速率表：按频点的统计与速率无关，复制当前版本。复制期间和发布之前
+        // 写入旧表的少量事件不会出现在新表中
+        built->sources = previous->sources;
+        built->protocols = previous->protocols;
+        built->quantiles = previous->quantiles;
+    } else {
+        built->sources.assign(channels, HyperLogLog());
+        built->protocols.assign(channels, 0);
+        built->quantiles.assign(channels, RssiQuantileSketch());
     }
     
-    delay(50);
+    if (built->rates.size() > 1) {
+        built->lastRate.assign(channels, 0);
+        uint32_t cells = channels * built->rates.size();
+        if (cells <= MAX_SWEEP_CELLS) {
+            built->sweepCells.assign(cells, SweepCellStats());
+        } else {
+            USBSerial.printf("[Listener] %lu sweep cells exceed limit, per-cell stats disabled\n", cells);
+        }
+        USBSerial.printf("[Listener] Sweeping %d data rates per channel\n", built->rates.size());
+    }
     
-    USBSerial.printf("[Listener] Initialized with %d frequencies, RX window: %u ms\n", 
-        config.frequencies.size(), config.rxWindowMs);
+    if (previous && !planChanged) {
+        built->occupancy = previous->occupancy;
+    } else {
+        // 以频点计划的指纹标识计划，计划改变时旧检查点作废
+        built->occupancy.setChannelCount(channels, cfg.plan->getId());
+        built->occupancy.load();
+        if (previous) {
+            built->occupancy.copyClock(previous->occupancy);
+        }
+    }
     
-    return true;
+    return built;
 }
 
 void FrequencyListener::start() {
@@ -62,6 +130,13 @@ void FrequencyListener::start() {
     
     USBSerial.println("[Listener] Starting...");
     
+    // 串口收到数据时唤醒监听任务
+    lora->setFrameCallback([this]() {
+        if (listenTaskHandle) {
+            xTaskNotifyGive(listenTaskHandle);
+        }
+    });
+    
     xTaskCreate(
         [](void* pvParameters) {
             FrequencyListener* listener = static_cast<FrequencyListener*>(pvParameters);
@@ -80,16 +155,25 @@ void FrequencyListener::stop() {
     
     USBSerial.println("[Listener] Stopping...");
     shouldStop = true;
+    if (lora) {
+        lora->setFrameCallback(nullptr);
+    }
     
     if (listenTaskHandle) {
+        xTaskNotifyGive(listenTaskHandle);
         vTaskDelay(pdMS_TO_TICKS(100));
         if (isListening) {
             vTaskDelete(listenTaskHandle);
+            // 被强制结束的任务可能停在读侧临界区内
+            rcu.readUnlock(RCU_READER_LISTEN);
         }
         listenTaskHandle = nullptr;
     }
     
     isListening = false;
+    if (lora) {
+        lora->flushSettings();
+    }
 }
 
 void FrequencyListener::listenTaskWrapper(void* pvParameters) {
@@ -99,34 +183,97 @@ void FrequencyListener::listenTaskWrapper(void* pvParameters) {
 
 void FrequencyListener::listenTask() {
     USBSerial.println("[Listener] Task started");
+    BootTiming::markFirstRx();
+    
+    const ListenerConfig* tunedConfig = nullptr;
+    const ChannelTables* tunedTables = nullptr;
     
     while (!shouldStop) {
+        // 整个接收窗口内使用同一版本的配置，新版本从下一个窗口开始生效
+        rcu.readLock(RCU_READER_LISTEN);
+        const ListenerConfig& cfg = *config.get();
+        ChannelTables& channels = *tables.get();
+        
+        if (channels.protocols.size() != cfg.plan->size()) {
+            // 配置与统计表分两次发布，刚好落在两者之间：稍后重取
+            rcu.readUnlock(RCU_READER_LISTEN);
+            vTaskDelay(pdMS_TO_TICKS(10));
+            continue;
+        }
+        
+        if (&channels != tunedTables) {
+            // 频点计划或速率表已替换：旧索引下的周期预测不再有效
+            periodicity.clear();
+            if (currentFreqIndex >= cfg.plan->size()) currentFreqIndex = 0;
+            if (currentRate >= channels.rates.size()) currentRate = 0;
+        }
+        
+        uint16_t windowIndex = currentFreqIndex;
+        uint8_t windowRate = currentRate;
+        uint32_t windowMs = cfg.rxWindowMs;
+        bool predicted = planWindow(cfg, channels, millis(), &windowIndex, &windowRate, &windowMs);
+        
+        // 配置版本变化时即使频点不变也重新下发射频参数
+        if (windowIndex != currentFreqIndex || windowRate != currentRate ||
+            &cfg != tunedConfig || &channels != tunedTables) {
+            tuneTo(cfg, channels, windowIndex, windowRate);
+            tunedConfig = &cfg;
+            tunedTables = &channels;
+        }
+        
         uint32_t rxStartTime = millis();
         bool eventReceived = false;
         
         // USBSerial.printf("[Listener] RX window started at %lu ms\n", rxStartTime);
         
-        while (millis() - rxStartTime < config.rxWindowMs && !shouldStop) {
-            if (Serial2.available() > 0) {
+        while (millis() - rxStartTime < windowMs && !shouldStop) {
+            if (lora->frameAvailable()) {
                 // USBSerial.println("[Listener] Data available on Serial2");
                 
-                RecvFrame_t frame;
-                int result = lora->receiveFrame(&frame);
+                // 时间戳取在检测到数据时，而不是整帧读完后
+                uint64_t rxTimeUs = nowMicros();
+                FrameView frame;
+                int result = lora->readFrame(&frame);
                 
                 // USBSerial.printf("[Listener] RecieveFrame returned: %d\n", result);
                 
                 if (result == 0) {
-                    handleRxDone(frame);
+                    Metrics::increment(METRIC_FRAMES_RECEIVED);
+                    handleRxDone(cfg, channels, frame, rxTimeUs);
+                    lora->releaseFrame();
                     eventReceived = true;
                     break;
                 } else if (result == 1) {
-                    handleRxError();
+                    lora->releaseFrame();
+                    Metrics::increment(METRIC_PARSE_ERRORS);
+                    handleRxError(cfg, channels, rxTimeUs);
                     eventReceived = true;
                     break;
                 }
             }
             
-            vTaskDelay(pdMS_TO_TICKS(10));
+            // 阻塞等待串口接收通知而不是每 10 ms 轮询，窗口结束时超时返回
+            uint32_t elapsed = millis() - rxStartTime;
+            if (elapsed < windowMs) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(windowMs - elapsed));
+            }
+        }
+        
+        // 每个窗口只处理一个事件，此时仍在等待的帧要到下个窗口才会读取
+        if (eventReceived && lora->frameAvailable()) {
+            Metrics::increment(METRIC_DEFERRED_FRAMES);
+        }
+        
+        SweepCellStats* cell = sweepCell(channels, currentFreqIndex, currentRate);
+        if (cell && cell->windows < 0xFFFF) {
+            cell->windows++;
+        }
+        rcu.readUnlock(RCU_READER_LISTEN);
+        
+        hopStats.windows[predicted]++;
+        hopStats.listenMs[predicted] += millis() - rxStartTime;
+        if (eventReceived) {
+            hopStats.events[predicted]++;
         }
         
         // if (!eventReceived) {
@@ -142,93 +289,129 @@ void FrequencyListener::listenTask() {
     isListening = false;
 }
 
-bool FrequencyListener::setFrequency(uint32_t freq) {
+bool FrequencyListener::setFrequency(uint16_t index) {
     if (!lora) return false;
     
+    const ListenerConfig& cfg = *config.get();
+    uint32_t freq = cfg.plan->frequencyAt(index);
     USBSerial.printf("[Listener] Setting frequency: %lu Hz\n", freq);
     
-    if (!lora->setFrequency(freq)) {
+    // 经 applySettings() 下发，只写入发生变化的参数
+    FrequencyConfig settings = radioSettingsFor(cfg, *tables.get(), index, currentRate);
+    
+    if (!lora->applySettings(settings)) {
+        Metrics::increment(METRIC_SET_FREQ_FAILURES);
         USBSerial.println("[Listener] Failed to set frequency");
         return false;
     }
     
-    delay(100);
-    
     USBSerial.println("[Listener] Frequency set successfully");
     return true;
 }
 
-void FrequencyListener::nextFrequency() {
-    if (config.frequencies.empty()) return;
+FrequencyConfig FrequencyListener::radioSettingsFor(const ListenerConfig& cfg, const ChannelTables& channels,
+                                                    uint16_t index, uint8_t rate) const {
+    FrequencyConfig settings(cfg.plan->frequencyAt(index), cfg.rxWindowMs);
+    settings.codingRate = cfg.codingRate;
     
-    uint16_t nextIndex = (config.currentFreqIndex + 1) % config.frequencies.size();
-    uint32_t newFreq = config.frequencies[nextIndex].frequency;
-    
-    USBSerial.printf("[Listener] Switching to next frequency: %lu Hz (index: %d)\n", 
-        newFreq, nextIndex);
-    
-    bool success = setFrequency(newFreq);
-    
-    // 即使设置失败，也要更新索引，这样用户可以继续浏览频点
-    config.currentFreqIndex = nextIndex;
-    
-    if (scopeDisplay) {
-        scopeDisplay->setCurrentFreq(newFreq);
-        scopeDisplay->setCurrentFreqIndex(config.currentFreqIndex, config.frequencies.size());
+    if (rate < channels.rates.size()) {
+        settings.spreadingFactor = channels.rates[rate].spreadingFactor;
+        settings.bandwidth = channels.rates[rate].bandwidth;
+    } else {
+        settings.spreadingFactor = cfg.spreadingFactor;
+        settings.bandwidth = cfg.bandwidth;
     }
+    return settings;
+}
+
+void FrequencyListener::tuneTo(const ListenerConfig& cfg, const ChannelTables& channels, uint16_t index, uint8_t rate) {
+    if (index >= cfg.plan->size()) return;
     
-    if (!success) {
+    FrequencyConfig settings = radioSettingsFor(cfg, channels, index, rate);
+    if (!lora || !lora->applySettings(settings)) {
+        Metrics::increment(METRIC_SET_FREQ_FAILURES);
         USBSerial.println("[Listener] Frequency setting failed, but index updated");
     }
+    currentFreqIndex = index;
+    currentRate = rate;
+    
+    if (scopeDisplay) {
+        scopeDisplay->setCurrentFreq(settings.frequency);
+        scopeDisplay->setCurrentFreqIndex(index, cfg.plan->size());
+    }
 }
 
-void FrequencyListener::prevFrequency() {
-    if (config.frequencies.empty()) return;
-    
-    uint16_t prevIndex = (config.currentFreqIndex == 0) 
-        ? config.frequencies.size() - 1 
-        : config.currentFreqIndex - 1;
-    uint32_t newFreq = config.frequencies[prevIndex].frequency;
-    
-    USBSerial.printf("[Listener] Switching to previous frequency: %lu Hz (index: %d)\n", 
-        newFreq, prevIndex);
+bool FrequencyListener::planWindow(const ListenerConfig& cfg, const ChannelTables& channels, uint32_t nowMs,
+                                   uint16_t* index, uint8_t* rate, uint32_t* windowMs) {
+    *index = currentFreqIndex;
+    *rate = currentRate;
+    *windowMs = cfg.rxWindowMs;
     
-    bool success = setFrequency(newFreq);
+    if (cfg.plan->empty()) {
+        return false;
+    }
     
-    // 即使设置失败，也要更新索引，这样用户可以继续浏览频点
-    config.currentFreqIndex = prevIndex;
+    uint8_t nextRate = channels.rates.empty() ? 0 : (currentRate + 1) % channels.rates.size();
     
-    if (scopeDisplay) {
-        scopeDisplay->setCurrentFreq(newFreq);
-        scopeDisplay->setCurrentFreqIndex(config.currentFreqIndex, config.frequencies.size());
+    if (cfg.hopMode == HOP_PREDICTIVE) {
+        uint16_t predIndex;
+        uint32_t predictedMs, toleranceMs;
+        
+        if (periodicity.nextPrediction(nowMs, &predIndex, &predictedMs, &toleranceMs) &&
+            predIndex < cfg.plan->size()) {
+            // 窗口覆盖 [预测 - 容差, 预测 + 容差]，并预留切换时间
+            int32_t lead = (int32_t)(predictedMs - toleranceMs - nowMs);
+            
+            if (lead <= (int32_t)HOP_RETUNE_MS) {
+                int32_t remaining = (int32_t)(predictedMs + toleranceMs - nowMs);
+                *index = predIndex;
+                // 使用该频点上次收到包时的速率
+                *rate = predIndex < channels.lastRate.size() ? channels.lastRate[predIndex] : 0;
+                *windowMs = remaining > (int32_t)HOP_MIN_WINDOW_MS ? remaining : HOP_MIN_WINDOW_MS;
+                return true;
+            }
+            
+            // 继续探索，但缩短窗口以便按时切回
+            uint32_t available = lead - HOP_RETUNE_MS;
+            if (available < *windowMs) {
+                *windowMs = available > HOP_MIN_WINDOW_MS ? available : HOP_MIN_WINDOW_MS;
+            }
+        }
     }
     
-    if (!success) {
-        USBSerial.println("[Listener] Frequency setting failed, but index updated");
+    // 先在当前频点轮换完所有速率，再按跳频方式切换频点
+    *rate = nextRate;
+    if (cfg.hopMode != HOP_FIXED && nextRate == 0) {
+        *index = (currentFreqIndex + 1) % cfg.plan->size();
     }
+    return false;
 }
 
-void FrequencyListener::nextFrequency(int step) {
-    if (config.frequencies.empty() || step <= 0) return;
+SweepCellStats* FrequencyListener::sweepCell(ChannelTables& channels, uint16_t index, uint8_t rate) {
+    size_t cell = (size_t)index * channels.rates.size() + rate;
+    return cell < channels.sweepCells.size() ? &channels.sweepCells[cell] : nullptr;
+}
+
+void FrequencyListener::switchToIndex(uint16_t index, const char* direction, int step) {
+    const ListenerConfig& cfg = *config.get();
+    uint32_t newFreq = cfg.plan->frequencyAt(index);
     
-    // 计算新索引，确保不超过边界
-    uint16_t nextIndex = config.currentFreqIndex + step;
-    if (nextIndex >= config.frequencies.size()) {
-        nextIndex = config.frequencies.size() - 1;
+    if (step > 1) {
+        USBSerial.printf("[Listener] Switching to %s frequency (step %d): %lu Hz (index: %d)\n", 
+            direction, step, newFreq, index);
+    } else {
+        USBSerial.printf("[Listener] Switching to %s frequency: %lu Hz (index: %d)\n", 
+            direction, newFreq, index);
     }
     
-    uint32_t newFreq = config.frequencies[nextIndex].frequency;
-    USBSerial.printf("[Listener] Switching to next frequency (step %d): %lu Hz (index: %d)\n", 
-        step, newFreq, nextIndex);
-    
-    bool success = setFrequency(newFreq);
+    bool success = setFrequency(index);
     
     // 即使设置失败，也要更新索引，这样用户可以继续浏览频点
-    config.currentFreqIndex = nextIndex;
+    currentFreqIndex = index;
     
     if (scopeDisplay) {
         scopeDisplay->setCurrentFreq(newFreq);
-        scopeDisplay->setCurrentFreqIndex(config.currentFreqIndex, config.frequencies.size());
+        scopeDisplay->setCurrentFreqIndex(index, cfg.plan->size());
     }
     
     if (!success) {
@@ -236,62 +419,86 @@ void FrequencyListener::nextFrequency(int step) {
     }
 }
 
-void FrequencyListener::prevFrequency(int step) {
-    if (config.frequencies.empty() || step <= 0) return;
-    
-    // 计算新索引，确保不小于0
-    uint16_t prevIndex = config.currentFreqIndex >= step ? config.currentFreqIndex - step : 0;
-    
-    uint32_t newFreq = config.frequencies[prevIndex].frequency;
-    USBSerial.printf("[Listener] Switching to previous frequency (step %d): %lu Hz (index: %d)\n", 
-        step, newFreq, prevIndex);
+void FrequencyListener::nextFrequency() {
+    const ListenerConfig& cfg = *config.get();
+    if (cfg.plan->empty()) return;
     
-    bool success = setFrequency(newFreq);
+    switchToIndex((currentFreqIndex + 1) % cfg.plan->size(), "next", 1);
+}
+
+void FrequencyListener::prevFrequency() {
+    const ListenerConfig& cfg = *config.get();
+    if (cfg.plan->empty()) return;
     
-    // 即使设置失败，也要更新索引，这样用户可以继续浏览频点
-    config.currentFreqIndex = prevIndex;
+    uint16_t prevIndex = (currentFreqIndex == 0) 
+        ? cfg.plan->size() - 1 
+        : currentFreqIndex - 1;
+    switchToIndex(prevIndex, "previous", 1);
+}
+
+void FrequencyListener::nextFrequency(int step) {
+    const ListenerConfig& cfg = *config.get();
+    if (cfg.plan->empty() || step <= 0) return;
     
-    if (scopeDisplay) {
-        scopeDisplay->setCurrentFreq(newFreq);
-        scopeDisplay->setCurrentFreqIndex(config.currentFreqIndex, config.frequencies.size());
+    // 计算新索引，确保不超过边界
+    uint32_t nextIndex = currentFreqIndex + step;
+    if (nextIndex >= cfg.plan->size()) {
+        nextIndex = cfg.plan->size() - 1;
     }
+    switchToIndex(nextIndex, "next", step);
+}
+
+void FrequencyListener::prevFrequency(int step) {
+    const ListenerConfig& cfg = *config.get();
+    if (cfg.plan->empty() || step <= 0) return;
     
-    if (!success) {
-        USBSerial.println("[Listener] Frequency setting failed, but index updated");
-    }
+    // 计算新索引，确保不小于0
+    uint16_t prevIndex = currentFreqIndex >= step ? currentFreqIndex - step : 0;
+    switchToIndex(prevIndex, "previous", step);
 }
 
-void FrequencyListener::handleRxDone(const RecvFrame_t& frame) {
+void FrequencyListener::handleRxDone(const ListenerConfig& cfg, ChannelTables& channels,
+                                     const FrameView& frame, uint64_t rxTimeUs) {
     int16_t rssi = frame.rssi;
     
     if (rssi < -120 || rssi > -50) {
+        Metrics::increment(METRIC_RSSI_REJECTED);
         USBSerial.printf("[Listener] Invalid RSSI: %d dBm, ignoring\n", rssi);
         return;
     }
     
     RadarPoint point;
-    point.timestamp = millis();
-    point.frequency = config.frequencies[config.currentFreqIndex].frequency;
+    point.sequence = nextSequence++;
+    point.setTimestampUs(rxTimeUs);
+    point.frequency = cfg.plan->frequencyAt(currentFreqIndex);
+    point.channelIndex = currentFreqIndex;
+    point.dataRateIndex = currentRate;
     point.rssi = rssi;
     point.snr = -20;
-    point.packetLength = frame.recv_data_len;
+    point.packetLength = frame.length;
     point.eventType = EVENT_RX_DONE;
+    point.payload = payloadPool.store(frame.data, frame.length);
+    point.fingerprint = fingerprintPayload(frame.data, frame.length);
+    point.duplicate = duplicateFilter.check(point.fingerprint, (uint32_t)(point.timestampUs() / US_PER_MS));
     
-    USBSerial.printf("[Listener] RX_DONE - Time: %lu, RSSI: %d dBm, Len: %d\n",
-        point.timestamp, point.rssi, point.packetLength);
+    USBSerial.printf("[Listener] RX_DONE - Time: %llu us, RSSI: %d dBm, Len: %d\n",
+        point.timestampUs(), point.rssi, point.packetLength);
     
-    radarPoints.push_back(point);
+    recordPoint(point);
     
-    if (radarPoints.size() > config.maxPoints) {
-        radarPoints.erase(radarPoints.begin());
-    }
+    rssiQuantiles.add(point.rssi);
+    int16_t p10 = rssiQuantiles.quantile(0.10f);
+    int16_t p50 = rssiQuantiles.quantile(0.50f);
+    int16_t p90 = rssiQuantiles.quantile(0.90f);
+    int16_t p99 = rssiQuantiles.quantile(0.99f);
     
+    statsLock.writeBegin();
     eventStats.totalEvents++;
     eventStats.rxDoneCount++;
-    eventStats.lastEventTime = point.timestamp;
+    eventStats.lastEventTime = point.timestampUs();
     
     if (eventStats.firstEventTime == 0) {
-        eventStats.firstEventTime = point.timestamp;
+        eventStats.firstEventTime = point.timestampUs();
     }
     
     if (point.rssi > eventStats.maxRssi) {
@@ -302,7 +509,44 @@ void FrequencyListener::handleRxDone(const RecvFrame_t& frame) {
         eventStats.minRssi = point.rssi;
     }
     
-    eventStats.avgRssi = (eventStats.avgRssi * (eventStats.totalEvents - 1) + point.rssi) / eventStats.totalEvents;
+    eventStats.rssiSum += point.rssi;
+    eventStats.avgRssi = (float)eventStats.rssiSum / eventStats.rxDoneCount;
+    eventStats.rssiP10 = p10;
+    eventStats.rssiP50 = p50;
+    eventStats.rssiP90 = p90;
+    eventStats.rssiP99 = p99;
+    
+    if (point.duplicate) {
+        eventStats.duplicateCount++;
+    }
+    statsLock.writeEnd();
+    
+    if (point.channelIndex < channels.quantiles.size()) {
+        channels.quantiles[point.channelIndex].add(point.rssi);
+    }
+    channels.occupancy.add(point.channelIndex, point.timestampUs());
+    
+    SweepCellStats* cell = sweepCell(channels, point.channelIndex, point.dataRateIndex);
+    if (cell) {
+        if (cell->rxDone < 0xFFFF) cell->rxDone++;
+        if (point.rssi > cell->maxRssi) cell->maxRssi = point.rssi;
+    }
+    if (point.channelIndex < channels.lastRate.size()) {
+        channels.lastRate[point.channelIndex] = point.dataRateIndex;
+    }
+    
+    if (!point.duplicate) {
+        // 重复帧（中继/重传）会打乱发送节奏，只用首次出现的帧估计周期
+        periodicity.addArrival(point.channelIndex, (uint32_t)(point.timestampUs() / US_PER_MS));
+    }
+    
+    // 协议识别与发送方估计交给分类阶段，这里只做非阻塞入队
+    ClassifyJob job;
+    job.sequence = point.sequence;
+    job.payload = point.payload;
+    job.channelIndex = point.channelIndex;
+    job.duplicate = point.duplicate;
+    classifier.submit(job);
     
     if (scopeDisplay) {
         scopeDisplay->setCurrentFreq(point.frequency);
@@ -310,29 +554,117 @@ void FrequencyListener::handleRxDone(const RecvFrame_t& frame) {
     }
 }
 
-void FrequencyListener::handleRxError() {
+void FrequencyListener::handleRxError(const ListenerConfig& cfg, ChannelTables& channels, uint64_t rxTimeUs) {
     RadarPoint point;
-    point.timestamp = millis();
-    point.frequency = config.frequencies[config.currentFreqIndex].frequency;
+    point.sequence = nextSequence++;
+    point.setTimestampUs(rxTimeUs);
+    point.frequency = cfg.plan->frequencyAt(currentFreqIndex);
+    point.channelIndex = currentFreqIndex;
+    point.dataRateIndex = currentRate;
     point.rssi = -120;
     point.snr = -20;
     point.packetLength = 0;
     point.eventType = EVENT_RX_CRC_ERROR;
+    point.protocol = PROTO_UNKNOWN;
     
-    USBSerial.printf("[Listener] RX_CRC_ERROR - Time: %lu\n", point.timestamp);
-    
-    radarPoints.push_back(point);
+    USBSerial.printf("[Listener] RX_CRC_ERROR - Time: %llu us\n", point.timestampUs());
     
-    if (radarPoints.size() > config.maxPoints) {
-        radarPoints.erase(radarPoints.begin());
-    }
+    recordPoint(point);
     
+    statsLock.writeBegin();
     eventStats.totalEvents++;
     eventStats.rxErrorCount++;
-    eventStats.lastEventTime = point.timestamp;
+    eventStats.lastEventTime = point.timestampUs();
     
     if (eventStats.firstEventTime == 0) {
-        eventStats.firstEventTime = point.timestamp;
+        eventStats.firstEventTime = point.timestampUs();
+    }
+    statsLock.writeEnd();
+    
+    channels.occupancy.add(point.channelIndex, point.timestampUs());
+    
+    SweepCellStats* cell = sweepCell(channels, point.channelIndex, point.dataRateIndex);
+    if (cell && cell->rxError < 0xFFFF) {
+        cell->rxError++;
+    }
+}
+
+void FrequencyListener::recordPoint(const RadarPoint& point) {
+    RadarPoint evicted;
+    
+    pointsLock.writeBegin();
+    RadarPoint tagged = point;
+    tagged.epoch = pointsLock.writeEpoch();
+    bool wasEvicted = radarPoints.push(tagged, &evicted);
+    if (wasEvicted) {
+        rssiHistogram.remove(evicted.rssi, evicted.channelIndex);
+    }
+    rssiHistogram.add(point.rssi, point.channelIndex);
+    // 金字塔与雷达点无关，点被淘汰后聚合仍保留
+    rssiPyramid.add(point.channelIndex, point.timestampUs(), point.rssi, point.eventType != EVENT_RX_DONE);
+    size_t pointCount = radarPoints.size();
+    pointsLock.writeEnd();
+    
+    Metrics::set(METRIC_RING_POINTS, pointCount);
+    
+    if (wasEvicted) {
+        Metrics::increment(METRIC_POINT_EVICTIONS);
+        // 负载随雷达点一起按先进先出淘汰
+        payloadPool.release(evicted.payload);
+    }
+}
+
+void FrequencyListener::onClassified(void* context, const ClassifyJob& job, const ClassifyResult& result) {
+    static_cast<FrequencyListener*>(context)->applyClassification(job, result);
+}
+
+void FrequencyListener::applyClassification(const ClassifyJob& job, const ClassifyResult& result) {
+    // 在分类工作任务中运行
+    rcu.readLock(RCU_READER_CLASSIFY);
+    applyClassification(*tables.get(), job, result);
+    rcu.readUnlock(RCU_READER_CLASSIFY);
+}
+
+void FrequencyListener::applyClassification(ChannelTables& channels, const ClassifyJob& job, const ClassifyResult& result) {
+    pointsLock.writeBegin();
+    RadarPoint* point = radarPoints.findBySequence(job.sequence);
+    if (point && point->payload == job.payload) {
+        point->protocol = result.protocol;
+        point->epoch = pointsLock.writeEpoch();
+    }
+    pointsLock.writeEnd();
+    
+    if (job.channelIndex < channels.protocols.size()) {
+        channels.protocols[job.channelIndex] |= (1 << result.protocol);
+    }
+    
+    if (job.duplicate) return;
+    
+    // 识别出协议地址时用真实地址，否则退化为负载前缀
+    uint32_t sourceKey = result.sourceId;
+    if (!result.hasSource) {
+        // 来源键只看负载开头：复制这一段，避免监听任务同时覆盖该槽位
+        uint8_t prefix[MESHTASTIC_SENDER_OFFSET + SOURCE_KEY_PREFIX_BYTES];
+        uint8_t length = payloadPool.copy(job.payload, prefix, sizeof(prefix));
+        if (length == 0) return;
+        sourceKey = sourceKeyFromPayload(prefix, length, result.protocol);
+    }
+    
+    globalSources.add(sourceKey);
+    uint32_t distinctSources = globalSources.estimate();
+    
+    statsLock.writeBegin();
+    eventStats.distinctSources = distinctSources;
+    statsLock.writeEnd();
+    
+    if (job.channelIndex < channels.sources.size()) {
+        HyperLogLog& sketch = channels.sources[job.channelIndex];
+        sketch.add(sourceKey);
+        
+        if (scopeDisplay) {
+            scopeDisplay->setChannelSources(job.channelIndex, sketch.estimate());
+            scopeDisplay->setChannelProtocols(job.channelIndex, channels.protocols[job.channelIndex]);
+        }
     }
 }
 
@@ -345,47 +677,357 @@ bool FrequencyListener::isRunning() const {
 }
 
 uint32_t FrequencyListener::getCurrentFrequency() const {
-    if (config.frequencies.empty()) return 0;
-    return config.frequencies[config.currentFreqIndex].frequency;
+    return config.get()->plan->frequencyAt(currentFreqIndex);
 }
 
 uint16_t FrequencyListener::getCurrentFreqIndex() const {
-    return config.currentFreqIndex;
+    return currentFreqIndex;
 }
 
 uint32_t FrequencyListener::getFrequencyAt(uint16_t index) const {
-    if (index < config.frequencies.size()) {
-        return config.frequencies[index].frequency;
-    }
-    return 0;
+    return config.get()->plan->frequencyAt(index);
+}
+
+ChannelPlanRef FrequencyListener::getChannelPlan() const {
+    return config.get()->plan;
+}
+
+uint16_t FrequencyListener::getFrequencyCount() const {
+    return config.get()->plan->size();
+}
+
+void FrequencyListener::setHopMode(uint8_t mode) {
+    if (mode >= HOP_MODE_COUNT) return;
+    
+    static const char* const names[HOP_MODE_COUNT] = {"fixed", "round-robin", "predictive"};
+    ListenerConfig next = getConfig();
+    next.hopMode = mode;
+    setConfig(next);
+    USBSerial.printf("[Listener] Hop mode: %s\n", names[mode]);
+}
+
+uint8_t FrequencyListener::getHopMode() const {
+    return config.get()->hopMode;
+}
+
+const std::vector<DataRate>& FrequencyListener::getDataRates() const {
+    return tables.get()->rates;
+}
+
+uint8_t FrequencyListener::getCurrentDataRate() const {
+    return currentRate;
 }
 
-uint8_t FrequencyListener::getFrequencyCount() const {
-    return config.frequencies.size();
+const SweepCellStats* FrequencyListener::getSweepCell(uint16_t index, uint8_t rate) const {
+    const ChannelTables& channels = *tables.get();
+    size_t cell = (size_t)index * channels.rates.size() + rate;
+    return cell < channels.sweepCells.size() ? &channels.sweepCells[cell] : nullptr;
+}
+
+const PeriodicityTracker& FrequencyListener::getPeriodicity() const {
+    return periodicity;
+}
+
+const HopStats& FrequencyListener::getHopStats() const {
+    return hopStats;
+}
+
+void FrequencyListener::printHopReport() const {
+    static const char* const kinds[2] = {"explore", "predicted"};
+    
+    USBSerial.printf("[Listener] Periodic channels tracked: %u\n", periodicity.getTrackedCount());
+    for (uint8_t i = 0; i < 2; i++) {
+        float listenSec = hopStats.listenMs[i] / 1000.0f;
+        float perMinute = listenSec > 0 ? hopStats.events[i] * 60.0f / listenSec : 0;
+        USBSerial.printf("[Listener] %-9s windows: %lu, events: %lu, listen: %.1f s, %.2f events/min\n",
+            kinds[i], hopStats.windows[i], hopStats.events[i], listenSec, perMinute);
+    }
 }
 
 ListenerConfig FrequencyListener::getConfig() const {
-    return config;
+    ListenerConfig copy = *config.get();
+    copy.currentFreqIndex = currentFreqIndex;
+    return copy;
 }
 
 void FrequencyListener::setConfig(const ListenerConfig& cfg) {
-    config = cfg;
+    // 上一次替换的旧版本：调用方（界面任务）此时不持有旧指针
+    rcu.reclaim();
+    
+    const ListenerConfig& previous = *config.get();
+    const ChannelTables& previousTables = *tables.get();
+    bool capacityChanged = cfg.maxPoints != previous.maxPoints;
+    bool planChanged = !cfg.plan->sameAs(*previous.plan);
+    
+    std::vector<DataRate> rates = effectiveRates(cfg);
+    bool ratesChanged = rates.size() != previousTables.rates.size();
+    for (size_t i = 0; !ratesChanged && i < rates.size(); i++) {
+        ratesChanged = rates[i].spreadingFactor != previousTables.rates[i].spreadingFactor ||
+                       rates[i].bandwidth != previousTables.rates[i].bandwidth;
+    }
+    
+    // 频点计划或速率表变化时按频点索引的统计随之换新，计划不变则沿用
+    ChannelTables* nextTables = nullptr;
+    if (planChanged || ratesChanged) {
+        // 换表前先写检查点，换表后旧表随宽限期释放
+        if (previousTables.occupancy.isDirty()) {
+            tables.get()->occupancy.save();
+        }
+        nextTables = buildTables(cfg, &previousTables, planChanged);
+    }
+    
+    if (capacityChanged || planChanged) {
+        // 缓冲区在临界区外分配，临界区内只交换；旧缓冲区只在 pointsLock 内被其他任务访问，
+        // 交换后可在此直接释放。雷达点的频点索引属于旧计划，一并清空
+        PointRing freshPoints;
+        freshPoints.setCapacity(cfg.maxPoints);
+        std::vector<uint16_t> freshChannels((size_t)cfg.plan->size() * rssiHistogram.getBinCount(), 0);
+        
+        pointsLock.writeBegin();
+        radarPoints.swap(freshPoints);
+        rssiHistogram.swapChannelTable(freshChannels, cfg.plan->size());
+        rssiHistogram.clearWindow();
+        if (planChanged) {
+            rssiPyramid.clearChannels();
+        }
+        pointsResetEpoch = pointsLock.writeEpoch();
+        pointsLock.writeEnd();
+        payloadPool.clear();
+        Metrics::set(METRIC_RING_POINTS, 0);
+    }
+    
+    config.publish(new ListenerConfig(cfg));
+    if (nextTables) {
+        tables.publish(nextTables);
+    }
+    
+    if (scopeDisplay && (planChanged || nextTables)) {
+        scopeDisplay->setChannelPlan(cfg.plan);
+        scopeDisplay->setOccupancy(&tables.get()->occupancy);
+    }
+    
+    USBSerial.printf("[Listener] Config version %lu published (%d frequencies%s)\n",
+        rcu.getVersion(), cfg.plan->size(), nextTables ? ", channel tables rebuilt" : "");
+}
+
+size_t FrequencyListener::reclaimConfigs() {
+    return rcu.reclaim();
+}
+
+uint32_t FrequencyListener::getPointsEpoch() const {
+    return pointsLock.epoch();
+}
+
+bool FrequencyListener::snapshotPoints(PointRing& out, uint32_t sinceEpoch, PointSnapshotInfo* info) const {
+    if (out.capacity() != radarPoints.capacity()) {
+        out.setCapacity(radarPoints.capacity());
+        sinceEpoch = 0;
+    }
+    
+    RadarPoint staged[SNAPSHOT_MAX_DELTA];
+    
+    for (uint8_t attempt = 0; attempt < SEQLOCK_MAX_RETRIES; attempt++) {
+        uint32_t start = pointsLock.readBegin();
+        uint32_t epoch = start >> 1;
+        
+        if (sinceEpoch != 0 && sinceEpoch == epoch) {
+            if (info) {
+                info->epoch = epoch;
+                info->full = false;
+                info->changed = 0;
+            }
+            return false;
+        }
+        
+        // 调用方纪元之后被清空过、或纪元无效时做全量复制
+        bool full = sinceEpoch == 0 || sinceEpoch > epoch || pointsResetEpoch > sinceEpoch;
+        size_t changed = 0;
+        
+        if (!full) {
+            // 只收集纪元更新的点（新写入或被就地修改）
+            for (size_t i = 0; i < radarPoints.size(); i++) {
+                const RadarPoint& point = radarPoints[i];
+                if (point.epoch <= sinceEpoch) continue;
+                if (changed == SNAPSHOT_MAX_DELTA) {
+                    full = true;
+                    break;
+                }
+                staged[changed++] = point;
+            }
+        }
+        
+        if (full) {
+            out.assignFrom(radarPoints);
+            changed = radarPoints.size();
+        }
+        
+        if (pointsLock.readRetry(start)) continue;
+        
+        if (!full) {
+            for (size_t i = 0; i < changed; i++) {
+                RadarPoint* existing = out.findBySequence(staged[i].sequence);
+                if (existing) {
+                    *existing = staged[i];
+                } else {
+                    out.push(staged[i], nullptr);
+                }
+            }
+        }
+        
+        if (info) {
+            info->epoch = epoch;
+            info->full = full;
+            info->changed = changed;
+        }
+        return true;
+    }
+    
+    // 写入过于频繁，短暂加锁完成一次全量复制
+    pointsLock.lock();
+    out.assignFrom(radarPoints);
+    uint32_t epoch = pointsLock.epoch();
+    pointsLock.unlock();
+    
+    if (info) {
+        info->epoch = epoch;
+        info->full = true;
+        info->changed = out.size();
+    }
+    return true;
+}
+
+uint8_t FrequencyListener::copyPayload(const RadarPoint& point, uint8_t* buffer, uint8_t cap) const {
+    return payloadPool.copy(point.payload, buffer, cap);
+}
+
+const PayloadPool& FrequencyListener::getPayloadPool() const {
+    return payloadPool;
+}
+
+void FrequencyListener::snapshotHistogram(uint16_t channel, RssiHistogramSnapshot* out) const {
+    for (uint8_t attempt = 0; attempt < SEQLOCK_MAX_RETRIES; attempt++) {
+        uint32_t start = pointsLock.readBegin();
+        rssiHistogram.snapshot(channel, out);
+        if (!pointsLock.readRetry(start)) {
+            return;
+        }
+    }
+    
+    pointsLock.lock();
+    rssiHistogram.snapshot(channel, out);
+    pointsLock.unlock();
 }
 
-const std::vector<RadarPoint>& FrequencyListener::getRadarPoints() const {
-    return radarPoints;
+const RssiPyramid& FrequencyListener::getRssiPyramid() const {
+    return rssiPyramid;
 }
 
-const EventStats& FrequencyListener::getEventStats() const {
-    return eventStats;
+void FrequencyListener::followTimelineChannel(uint16_t index) {
+    rssiPyramid.follow(index);
+}
+
+EventStats FrequencyListener::getEventStats() const {
+    for (uint8_t attempt = 0; attempt < SEQLOCK_MAX_RETRIES; attempt++) {
+        uint32_t start = statsLock.readBegin();
+        EventStats snapshot = eventStats;
+        if (!statsLock.readRetry(start)) {
+            return snapshot;
+        }
+    }
+    
+    statsLock.lock();
+    EventStats snapshot = eventStats;
+    statsLock.unlock();
+    return snapshot;
+}
+
+uint32_t FrequencyListener::getStatsEpoch() const {
+    return statsLock.epoch();
+}
+
+uint8_t FrequencyListener::getChannelProtocols(uint16_t index) const {
+    const ChannelTables& channels = *tables.get();
+    if (index < channels.protocols.size()) {
+        return channels.protocols[index];
+    }
+    return 0;
+}
+
+const RssiQuantileSketch* FrequencyListener::getChannelQuantiles(uint16_t index) const {
+    const ChannelTables& channels = *tables.get();
+    if (index < channels.quantiles.size()) {
+        return &channels.quantiles[index];
+    }
+    return nullptr;
+}
+
+const ClassificationStage& FrequencyListener::getClassifier() const {
+    return classifier;
+}
+
+const OccupancyHeatmap& FrequencyListener::getOccupancy() const {
+    return tables.get()->occupancy;
+}
+
+void FrequencyListener::setTimeOfDay(uint32_t secondsOfDay) {
+    tables.get()->occupancy.setTimeOfDay(secondsOfDay, nowMicros());
+    USBSerial.printf("[Listener] Time of day set to %02lu:%02lu\n", secondsOfDay / 3600, (secondsOfDay / 60) % 60);
+}
+
+bool FrequencyListener::checkpointOccupancy(uint32_t nowMs, bool force) {
+    OccupancyHeatmap& occupancy = tables.get()->occupancy;
+    return force ? occupancy.save() : occupancy.checkpointIfDue(nowMs);
+}
+
+void FrequencyListener::clearOccupancy() {
+    tables.get()->occupancy.clear();
+    USBSerial.println("[Listener] Occupancy heatmap cleared");
+}
+
+uint32_t FrequencyListener::getDistinctSources(uint16_t index) const {
+    const ChannelTables& channels = *tables.get();
+    if (index < channels.sources.size()) {
+        return channels.sources[index].estimate();
+    }
+    return 0;
 }
 
 void FrequencyListener::clearRadarPoints() {
+    pointsLock.writeBegin();
     radarPoints.clear();
+    rssiHistogram.clearWindow();
+    pointsResetEpoch = pointsLock.writeEpoch();
+    pointsLock.writeEnd();
+    payloadPool.clear();
+    Metrics::set(METRIC_RING_POINTS, 0);
     USBSerial.println("[Listener] Radar points cleared");
 }
 
 void FrequencyListener::clearEventStats() {
+    statsLock.writeBegin();
     eventStats = EventStats();
+    statsLock.writeEnd();
+    hopStats = HopStats();
+    pointsLock.writeBegin();
+    // 窗口计数属于仍在缓冲区中的点，点淘汰时会逐个减去，这里只清累计计数
+    rssiHistogram.clearCumulative();
+    rssiPyramid.clear();
+    pointsLock.writeEnd();
+    periodicity.clear();
+    ChannelTables& channels = *tables.get();
+    std::fill(channels.sweepCells.begin(), channels.sweepCells.end(), SweepCellStats());
+    rssiQuantiles.clear();
+    for (auto& sketch : channels.quantiles) {
+        sketch.clear();
+    }
+    duplicateFilter.clear();
+    globalSources.clear();
+    for (auto& sketch : channels.sources) {
+        sketch.clear();
+    }
+    std::fill(channels.protocols.begin(), channels.protocols.end(), 0);
+    if (scopeDisplay) {
+        scopeDisplay->clearChannelSources();
+    }
     USBSerial.println("[Listener] Event stats cleared");
 }
@@ -3,29 +3,108 @@
 
 #include "common.h"
 #include "lora_adapter.h"
+#include "point_ring.h"
+#include "payload_pool.h"
+#include "fingerprint.h"
+#include "classifier.h"
+#include "periodicity.h"
+#include "rssi_histogram.h"
+#include "rssi_pyramid.h"
+#include "quantile_sketch.h"
+#include "occupancy.h"
+#include "seqlock.h"
+#include "rcu.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
 class ScopeDisplay;
 
+// 预测窗口：提前切换余量（模块重新配置 + 稳定）与最短窗口 (ms)
+const uint32_t HOP_RETUNE_MS = 150;
+const uint32_t HOP_MIN_WINDOW_MS = 100;
+// 增量快照一次最多合并的变化点数，超出则全量复制
+const size_t SNAPSHOT_MAX_DELTA = 16;
+
+// 雷达点快照结果
+struct PointSnapshotInfo {
+    uint32_t epoch;     // 快照对应的数据纪元，下次增量读取时传回
+    bool full;          // 是否做了全量复制
+    size_t changed;     // 复制或合并的点数
+    
+    PointSnapshotInfo() : epoch(0), full(false), changed(0) {}
+};
+
+// (频点, SF, BW) 单元统计的上限，超出时只轮换不统计
+const uint32_t MAX_SWEEP_CELLS = 4096;
+
+// 按频点索引的统计表：随频点计划/速率表整体发布，替换计划时一起换新
+struct ChannelTables {
+    std::vector<DataRate> rates;                    // 生效的 (SF, BW) 轮换表，至少一项
+    std::vector<HyperLogLog> sources;               // 不同来源估计
+    std::vector<uint8_t> protocols;                 // 出现过的协议位掩码
+    std::vector<RssiQuantileSketch> quantiles;
+    std::vector<uint8_t> lastRate;                  // 最近一次收包时的速率序号
+    std::vector<SweepCellStats> sweepCells;         // 频点 × 速率
+    OccupancyHeatmap occupancy;                     // 频点 × 小时的长期占用，不随清除统计重置
+};
+
 class FrequencyListener {
 private:
     LoRaAdapter* lora;
-    ListenerConfig config;
     TaskHandle_t listenTaskHandle;
     volatile bool isListening;
     volatile bool shouldStop;
     
-    uint32_t lastEventTime;
-    std::vector<RadarPoint> radarPoints;
+    uint64_t lastEventTime;
+    PointRing radarPoints;
+    PayloadPool payloadPool;
+    RssiHistogram rssiHistogram;
+    RssiPyramid rssiPyramid;        // 时间线的多分辨率聚合，只由监听任务写入
     EventStats eventStats;
-    uint8_t packetBuffer[256];
+    
+    DuplicateFilter duplicateFilter;
+    HyperLogLog globalSources;
+    RssiQuantileSketch rssiQuantiles;
+    
+    ClassificationStage classifier;
+    PeriodicityTracker periodicity;
+    HopStats hopStats;
+    
+    // 运行时配置与按频点的统计表以不可变版本发布：写端（界面任务）整体替换，
+    // 监听/分类任务在读端临界区内取用，旧版本在宽限期后释放
+    RcuDomain rcu;
+    RcuPointer<const ListenerConfig> config;
+    RcuPointer<ChannelTables> tables;
+    volatile uint16_t currentFreqIndex;
+    uint8_t currentRate;
+    uint32_t nextSequence;
+    
+    // 雷达点（及随之增减的直方图）与事件统计各用一个顺序锁：
+    // 写端（监听/分类任务）之间短暂自旋互斥，读端（界面任务）从不阻塞写端
+    SeqLock pointsLock;
+    SeqLock statsLock;
+    uint32_t pointsResetEpoch;                // 最近一次清空/重建雷达点时的纪元
     
     void listenTaskWrapper(void* pvParameters);
     void listenTask();
-    bool setFrequency(uint32_t freq);
-    void handleRxDone(const RecvFrame_t& frame);
-    void handleRxError();
+    bool setFrequency(uint16_t index);
+    void switchToIndex(uint16_t index, const char* direction, int step);
+    std::vector<DataRate> effectiveRates(const ListenerConfig& cfg) const;
+    // previous 为当前已发布的表（初始化时为空）：计划不变时沿用按频点的统计和热力图，
+    // 只重建依赖速率表的部分；热力图的时钟设定总是沿用
+    ChannelTables* buildTables(const ListenerConfig& cfg, const ChannelTables* previous, bool planChanged) const;
+    FrequencyConfig radioSettingsFor(const ListenerConfig& cfg, const ChannelTables& channels,
+                                     uint16_t index, uint8_t rate) const;
+    void tuneTo(const ListenerConfig& cfg, const ChannelTables& channels, uint16_t index, uint8_t rate);
+    bool planWindow(const ListenerConfig& cfg, const ChannelTables& channels, uint32_t nowMs,
+                    uint16_t* index, uint8_t* rate, uint32_t* windowMs);
+    static SweepCellStats* sweepCell(ChannelTables& channels, uint16_t index, uint8_t rate);
+    void handleRxDone(const ListenerConfig& cfg, ChannelTables& channels, const FrameView& frame, uint64_t rxTimeUs);
+    void handleRxError(const ListenerConfig& cfg, ChannelTables& channels, uint64_t rxTimeUs);
+    void recordPoint(const RadarPoint& point);
+    static void onClassified(void* context, const ClassifyJob& job, const ClassifyResult& result);
+    void applyClassification(const ClassifyJob& job, const ClassifyResult& result);
+    void applyClassification(ChannelTables& channels, const ClassifyJob& job, const ClassifyResult& result);
     
     ScopeDisplay* scopeDisplay;
     
@@ -43,16 +122,51 @@ public:
     uint32_t getCurrentFrequency() const;
     uint16_t getCurrentFreqIndex() const;
     uint32_t getFrequencyAt(uint16_t index) const;
-    uint8_t getFrequencyCount() const;
+    uint16_t getFrequencyCount() const;
+    // 在界面任务中调用：当前配置版本的频点计划
+    ChannelPlanRef getChannelPlan() const;
     void nextFrequency();
     void prevFrequency();
     void nextFrequency(int step);
     void prevFrequency(int step);
+    void setHopMode(uint8_t mode);
+    uint8_t getHopMode() const;
+    const PeriodicityTracker& getPeriodicity() const;
+    const HopStats& getHopStats() const;
+    const std::vector<DataRate>& getDataRates() const;
+    uint8_t getCurrentDataRate() const;
+    const SweepCellStats* getSweepCell(uint16_t index, uint8_t rate) const;
+    void printHopReport() const;
     ListenerConfig getConfig() const;
+    // 在界面任务中调用：发布新配置，监听任务从下一个接收窗口起生效；
+    // 频点计划或速率表变化时按频点的统计表一并换新（旧计划的热力图先写入闪存）。
+    // RSSI 直方图的分箱边界只在 init 时设置
     void setConfig(const ListenerConfig& cfg);
+    // 在界面任务中定期调用：释放宽限期已过的旧配置版本，返回仍在等待的数量
+    size_t reclaimConfigs();
     
-    const std::vector<RadarPoint>& getRadarPoints() const;
-    const EventStats& getEventStats() const;
+    // 一致性快照：sinceEpoch 为上次快照的纪元时只合并之后新增/修改的点，
+    // 为 0 或期间被清空时全量复制；数据无变化时返回 false 且不修改 out
+    bool snapshotPoints(PointRing& out, uint32_t sinceEpoch, PointSnapshotInfo* info) const;
+    uint32_t getPointsEpoch() const;
+    uint8_t copyPayload(const RadarPoint& point, uint8_t* buffer, uint8_t cap) const;
+    const PayloadPool& getPayloadPool() const;
+    // 直方图的一致性快照（与雷达点同一顺序锁），channel 为叠加显示的频点
+    void snapshotHistogram(uint16_t channel, RssiHistogramSnapshot* out) const;
+    const RssiPyramid& getRssiPyramid() const;
+    // 时间线跟随的频点，为其保留按频点金字塔的槽位；CHANNEL_NONE 取消
+    void followTimelineChannel(uint16_t index);
+    EventStats getEventStats() const;
+    uint32_t getStatsEpoch() const;
+    uint32_t getDistinctSources(uint16_t index) const;
+    uint8_t getChannelProtocols(uint16_t index) const;
+    const RssiQuantileSketch* getChannelQuantiles(uint16_t index) const;
+    const ClassificationStage& getClassifier() const;
+    const OccupancyHeatmap& getOccupancy() const;
+    void setTimeOfDay(uint32_t secondsOfDay);
+    // 在界面任务中调用：到期（或 force）时把占用热力图写入闪存
+    bool checkpointOccupancy(uint32_t nowMs, bool force);
+    void clearOccupancy();
     void clearRadarPoints();
     void clearEventStats();
 };
@@ -0,0 +1,39 @@
+#include "seqlock.h"
+
+SeqLock::SeqLock() : sequence(0) {
+    writeMux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+void SeqLock::writeBegin() {
+    portENTER_CRITICAL(&writeMux);
+    sequence = sequence + 1;
+    __sync_synchronize();
+}
+
+void SeqLock::writeEnd() {
+    __sync_synchronize();
+    sequence = sequence + 1;
+    portEXIT_CRITICAL(&writeMux);
+}
+
+uint32_t SeqLock::readBegin() const {
+    uint32_t start;
+    // 写端在临界区内不会被抢占，奇数只会出现在另一个核正在写时，等待很短
+    while ((start = sequence) & 1) {
+    }
+    __sync_synchronize();
+    return start;
+}
+
+bool SeqLock::readRetry(uint32_t start) const {
+    __sync_synchronize();
+    return sequence != start;
+}
+
+void SeqLock::lock() const {
+    portENTER_CRITICAL(&writeMux);
+}
+
+void SeqLock::unlock() const {
+    portEXIT_CRITICAL(&writeMux);
+}
@@ -0,0 +1,36 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+
+// 读重试若干次仍不一致时，退化为短暂加锁读取，避免读端饿死
+const uint8_t SEQLOCK_MAX_RETRIES = 8;
+
+// 顺序锁：写端之间用自旋锁串行，读端不加锁，
+// 读前后序号一致且为偶数时读到的数据才有效。序号 / 2 即数据纪元
+class SeqLock {
+public:
+    SeqLock();
+    
+    void writeBegin();
+    void writeEnd();
+    
+    uint32_t readBegin() const;
+    bool readRetry(uint32_t start) const;
+    
+    // 读端重试用尽后的兜底：与写端互斥
+    void lock() const;
+    void unlock() const;
+    
+    // 已完成的写入次数
+    uint32_t epoch() const { return sequence >> 1; }
+    // 写入过程中调用，返回本次写入完成后的纪元
+    uint32_t writeEpoch() const { return (sequence + 1) >> 1; }
+    
+private:
+    volatile uint32_t sequence;
+    mutable portMUX_TYPE writeMux;
+};
+
+#endif // SEQLOCK_H
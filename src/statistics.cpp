@@ -2,22 +2,36 @@
 #include <algorithm>
 #include <cmath>
 
-StatisticsCollector::StatisticsCollector() {
+StatisticsCollector::StatisticsCollector(ChannelPlanRef channelPlan) {
+    setChannelPlan(channelPlan);
+}
+
+void StatisticsCollector::setChannelPlan(ChannelPlanRef channelPlan) {
+    plan = channelPlan ? channelPlan : ChannelPlan::none();
+    clear();
 }
 
 void StatisticsCollector::addSample(const ScanSample& sample) {
+    if (sample.channelIndex >= slotOf.size()) return;
+    
     recentSamples.push_back(sample);
     
     if (recentSamples.size() > maxRecentSamples) {
         recentSamples.pop_front();
     }
     
-    FrequencyStats& stats = freqStatsMap[sample.frequency];
-    
-    if (stats.frequency == 0) {
-        stats.frequency = sample.frequency;
+    uint16_t slot = slotOf[sample.channelIndex];
+    if (slot == CHANNEL_NONE) {
+        slot = entries.size();
+        slotOf[sample.channelIndex] = slot;
+        entries.push_back(ChannelEntry());
+        entries[slot].stats.frequency = plan->frequencyAt(sample.channelIndex);
+        entries[slot].stats.channelIndex = sample.channelIndex;
     }
     
+    ChannelEntry& entry = entries[slot];
+    FrequencyStats& stats = entry.stats;
+    
     stats.sampleCount++;
     stats.lastSeen = sample.timestamp;
     
@@ -25,13 +39,14 @@ void StatisticsCollector::addSample(const ScanSample& sample) {
         stats.packetCount++;
     }
     
-    rssiWindows[sample.frequency].add(sample.rssi);
+    entry.rssiWindow.add(sample.rssi);
+    entry.rssiSketch.add(sample.rssi);
 }
 
 void StatisticsCollector::updateStatistics() {
-    for (auto& pair : freqStatsMap) {
-        FrequencyStats& stats = pair.second;
-        SlidingWindow& window = rssiWindows[pair.first];
+    for (auto& entry : entries) {
+        FrequencyStats& stats = entry.stats;
+        SlidingWindow& window = entry.rssiWindow;
         
         if (window.size() > 0) {
             stats.avgRssi = window.getAverage();
@@ -39,24 +54,35 @@ void StatisticsCollector::updateStatistics() {
             stats.minRssi = window.getMin();
         }
         
+        const RssiQuantileSketch& sketch = entry.rssiSketch;
+        if (!sketch.empty()) {
+            stats.p10Rssi = sketch.quantile(0.10f);
+            stats.p50Rssi = sketch.quantile(0.50f);
+            stats.p90Rssi = sketch.quantile(0.90f);
+            stats.p99Rssi = sketch.quantile(0.99f);
+        }
+        
         stats.activityScore = calculateActivityScore(stats);
     }
 }
 
 FrequencyStats* StatisticsCollector::getStats(uint32_t frequency) {
-    auto it = freqStatsMap.find(frequency);
-    if (it != freqStatsMap.end()) {
-        return &(it->second);
+    return getStatsAt(plan->indexOf(frequency));
+}
+
+FrequencyStats* StatisticsCollector::getStatsAt(uint16_t channelIndex) {
+    if (channelIndex >= slotOf.size() || slotOf[channelIndex] == CHANNEL_NONE) {
+        return nullptr;
     }
-    return nullptr;
+    return &entries[slotOf[channelIndex]].stats;
 }
 
 std::vector<FrequencyStats> StatisticsCollector::getAllStats() {
     std::vector<FrequencyStats> result;
-    result.reserve(freqStatsMap.size());
+    result.reserve(entries.size());
     
-    for (auto& pair : freqStatsMap) {
-        result.push_back(pair.second);
+    for (const auto& entry : entries) {
+        result.push_back(entry.stats);
     }
     
     std::sort(result.begin(), result.end(), 
@@ -67,22 +93,30 @@ std::vector<FrequencyStats> StatisticsCollector::getAllStats() {
     return result;
 }
 
+void StatisticsCollector::removeEntry(uint16_t slot) {
+    // 与末项交换后删除，保持紧凑
+    uint16_t last = entries.size() - 1;
+    slotOf[entries[slot].stats.channelIndex] = CHANNEL_NONE;
+    if (slot != last) {
+        entries[slot] = std::move(entries[last]);
+        slotOf[entries[slot].stats.channelIndex] = slot;
+    }
+    entries.pop_back();
+}
+
 void StatisticsCollector::cleanup(uint32_t maxAgeMs) {
-    uint32_t currentTime = millis();
+    uint64_t currentTime = nowMicros();
+    uint64_t maxAgeUs = (uint64_t)maxAgeMs * US_PER_MS;
     
-    auto it = freqStatsMap.begin();
-    while (it != freqStatsMap.end()) {
-        if (currentTime - it->second.lastSeen > maxAgeMs) {
-            rssiWindows.erase(it->first);
-            it = freqStatsMap.erase(it);
-        } else {
-            ++it;
+    for (size_t slot = entries.size(); slot-- > 0; ) {
+        if (currentTime - entries[slot].stats.lastSeen > maxAgeUs) {
+            removeEntry(slot);
         }
     }
     
     auto sampleIt = recentSamples.begin();
     while (sampleIt != recentSamples.end()) {
-        if (currentTime - sampleIt->timestamp > maxAgeMs) {
+        if (currentTime - sampleIt->timestamp > maxAgeUs) {
             sampleIt = recentSamples.erase(sampleIt);
         } else {
             ++sampleIt;
@@ -105,8 +139,8 @@ float StatisticsCollector::calculateActivityScore(const FrequencyStats& stats) {
     float rssiRange = stats.maxRssi - stats.minRssi;
     stabilityScore = 1.0f - normalize(rssiRange, 0.0f, 30.0f);
     
-    uint32_t age = millis() - stats.lastSeen;
-    float maxAge = 5.0f * 60.0f * 1000.0f;
+    uint64_t age = nowMicros() - stats.lastSeen;
+    float maxAge = 5.0f * 60.0f * US_PER_SEC;
     freshnessScore = std::max(0.0f, 1.0f - (float)age / maxAge);
     
     float score = 0.35f * rssiScore + 
@@ -118,9 +152,9 @@ float StatisticsCollector::calculateActivityScore(const FrequencyStats& stats) {
 }
 
 void StatisticsCollector::clear() {
-    freqStatsMap.clear();
     recentSamples.clear();
-    rssiWindows.clear();
+    entries.clear();
+    slotOf.assign(plan->size(), CHANNEL_NONE);
 }
 
 size_t StatisticsCollector::getRecentSampleCount() const {
@@ -128,5 +162,5 @@ size_t StatisticsCollector::getRecentSampleCount() const {
 }
 
 size_t StatisticsCollector::getFrequencyCount() const {
-    return freqStatsMap.size();
+    return entries.size();
 }
@@ -2,12 +2,11 @@
 #define STATISTICS_H
 
 #include "common.h"
+#include "quantile_sketch.h"
 #include <deque>
-#include <map>
 
 class StatisticsCollector {
 private:
-    std::map<uint32_t, FrequencyStats> freqStatsMap;
     std::deque<ScanSample> recentSamples;
     const size_t maxRecentSamples = 100;
     
@@ -59,14 +58,32 @@ private:
         }
     };
     
-    std::map<uint32_t, SlidingWindow> rssiWindows;
+    struct ChannelEntry {
+        FrequencyStats stats;
+        SlidingWindow rssiWindow;
+        RssiQuantileSketch rssiSketch;  // 全程分位数，每频点固定 148 字节
+    };
+    
+    // 与监听器共享的频点计划；有数据的频点紧凑存放，按频点索引 O(1) 定位
+    ChannelPlanRef plan;
+    std::vector<uint16_t> slotOf;       // 频点索引 → entries 下标，CHANNEL_NONE 表示尚无数据
+    std::vector<ChannelEntry> entries;
+    
+    void removeEntry(uint16_t slot);
     
 public:
-    StatisticsCollector();
+    explicit StatisticsCollector(ChannelPlanRef channelPlan = ChannelPlan::none());
+    
+    // 更换频点计划，已有统计随之清空
+    void setChannelPlan(ChannelPlanRef channelPlan);
+    const ChannelPlanRef& getChannelPlan() const { return plan; }
     
+    // 按 sample.channelIndex 归类，不在计划内的样本丢弃
     void addSample(const ScanSample& sample);
     void updateStatistics();
+    // 返回的指针在下次 addSample/cleanup/clear 前有效
     FrequencyStats* getStats(uint32_t frequency);
+    FrequencyStats* getStatsAt(uint16_t channelIndex);
     std::vector<FrequencyStats> getAllStats();
     void cleanup(uint32_t maxAgeMs);
     
@@ -0,0 +1,50 @@
+#include "stream.h"
+#include "event_codec.h"
+#include "metrics.h"
+
+BinaryStream::BinaryStream(Print& out)
+    : out(out), enabled(false), lastSequence(0), lastMetricsMs(0) {
+}
+
+void BinaryStream::setEnabled(bool enable) {
+    enabled = enable;
+}
+
+void BinaryStream::writePoints(const PointRing& points) {
+    uint8_t record[EVENT_RECORD_SIZE];
+    
+    for (const auto& point : points) {
+        if (point.sequence <= lastSequence) continue;
+        
+        lastSequence = point.sequence;
+        if (enabled) {
+            size_t length = encodeEvent(point, record);
+            writeRecord(STREAM_RECORD_EVENT, record, length);
+        }
+    }
+}
+
+void BinaryStream::writeMetrics() {
+    uint8_t record[Metrics::ENCODED_SIZE];
+    size_t length = Metrics::encode(record);
+    writeRecord(STREAM_RECORD_METRICS, record, length);
+}
+
+void BinaryStream::poll(uint32_t nowMs) {
+    if (!enabled || nowMs - lastMetricsMs < STREAM_METRICS_INTERVAL_MS) return;
+    
+    lastMetricsMs = nowMs;
+    writeMetrics();
+}
+
+void BinaryStream::writeRecord(uint8_t type, const uint8_t* payload, uint8_t length) {
+    uint8_t header[3] = { STREAM_SYNC, type, length };
+    uint8_t checksum = type + length;
+    for (uint8_t i = 0; i < length; i++) {
+        checksum += payload[i];
+    }
+    
+    out.write(header, sizeof(header));
+    out.write(payload, length);
+    out.write(checksum);
+}
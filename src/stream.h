@@ -0,0 +1,39 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "point_ring.h"
+
+// 串口二进制流：每条记录为 同步字节 (0xA5) + 类型 (1) + 长度 (1) + 负载 + 校验和 (1)
+// 校验和为类型、长度和负载各字节之和的低 8 位
+const uint8_t STREAM_SYNC = 0xA5;
+const uint32_t STREAM_METRICS_INTERVAL_MS = 5000;
+
+enum StreamRecordType {
+    STREAM_RECORD_EVENT = 1,    // 负载为 encodeEvent() 的定长事件记录
+    STREAM_RECORD_METRICS = 2   // 负载为 Metrics::encode() 的指标快照
+};
+
+class BinaryStream {
+public:
+    explicit BinaryStream(Print& out);
+    
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    
+    // 输出快照中尚未发送过的事件（按事件序号），未启用时只记录进度
+    void writePoints(const PointRing& points);
+    // 立即输出一条指标记录（与是否启用无关，供串口查询使用）
+    void writeMetrics();
+    // 启用时按固定间隔输出指标记录
+    void poll(uint32_t nowMs);
+    
+private:
+    void writeRecord(uint8_t type, const uint8_t* payload, uint8_t length);
+    
+    Print& out;
+    bool enabled;
+    uint32_t lastSequence;
+    uint32_t lastMetricsMs;
+};
+
+#endif // STREAM_H
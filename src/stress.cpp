@@ -0,0 +1,270 @@
+#include "stress.h"
+
+#ifdef LORASCOPE_STRESS
+
+#include "config.h"
+#include "metrics.h"
+
+// 串口上每字节 10 位（8N1）的传输时间，以及一帧的传输时间和接收超时
+const uint32_t INJECT_BYTE_WIRE_US = 10UL * 1000000UL / LORA_E220_UART_BAUD;
+const uint32_t INJECT_FRAME_WIRE_US = INJECT_BYTE_WIRE_US * INJECT_FRAME_BYTES;
+const uint32_t INJECT_UART_IDLE_US = INJECT_BYTE_WIRE_US * INJECT_UART_IDLE_SYMBOLS;
+// 模块侧串口发送排队上限按一个最大帧计，线路积压超过该时长的新帧在模块内丢弃
+const uint32_t INJECT_LINE_BACKLOG_US = INJECT_BYTE_WIRE_US * E220_MAX_FRAME_BYTES;
+
+InjectedAdapter::InjectedAdapter()
+    : uartPending(0), uartFrames(0), lineFreeUs(0), producerHandle(nullptr), rate(0),
+      offered(0), mergedFrames(0), lineDropped(0) {
+}
+
+InjectedAdapter::~InjectedAdapter() {
+    if (producerHandle) {
+        vTaskDelete(producerHandle);
+    }
+}
+
+bool InjectedAdapter::init() {
+    if (producerHandle) return true;
+    
+    BaseType_t ok = xTaskCreate(producerTask, "InjectTask", 2048, this, 2, &producerHandle);
+    if (ok != pdPASS) {
+        producerHandle = nullptr;
+        return false;
+    }
+    
+    USBSerial.printf("[Stress] Injected adapter ready (%u bps, wire %lu us/frame, ring %u B/%u frames)\n",
+        LORA_E220_UART_BAUD, INJECT_FRAME_WIRE_US, E220_RX_RING_BYTES, E220_RX_RING_FRAMES);
+    return true;
+}
+
+void InjectedAdapter::setRate(uint16_t eventsPerSec) {
+    rate = eventsPerSec;
+}
+
+void InjectedAdapter::producerTask(void* param) {
+    InjectedAdapter* adapter = static_cast<InjectedAdapter*>(param);
+    uint32_t nextUs = micros();
+    
+    while (true) {
+        uint32_t now = micros();
+        uint16_t current = adapter->rate;
+        
+        if (current == 0) {
+            nextUs = now;
+        }
+        // 先处理已到时刻的帧（可能与缓冲中的一段粘连），再判断线路是否已空闲
+        while (current > 0 && (int32_t)(now - nextUs) >= 0) {
+            adapter->transmit(nextUs);
+            nextUs += 1000000UL / current;
+        }
+        if (adapter->uartPending > 0 && (int32_t)(now - adapter->lineFreeUs) >= (int32_t)INJECT_UART_IDLE_US) {
+            adapter->deliver();
+        }
+        vTaskDelay(1);
+    }
+}
+
+void InjectedAdapter::transmit(uint32_t arrivalUs) {
+    uint32_t sequence = ++offered;
+    int16_t rssi = -110 + (int16_t)(sequence % 60);
+    
+    // 负载以序号开头并逐字节变化，保证指纹唯一，不被重复包过滤；帧尾为 RSSI 字节
+    uint8_t frame[INJECT_FRAME_BYTES];
+    uint32_t seed = sequence * 2654435761u;
+    for (uint8_t i = 0; i < INJECT_PAYLOAD_LEN; i++) {
+        frame[i] = i < 4 ? (uint8_t)(sequence >> (8 * i)) : (uint8_t)(seed >> ((i % 4) * 8)) ^ i;
+    }
+    frame[INJECT_PAYLOAD_LEN] = (uint8_t)(rssi + 256);
+    
+    uint32_t startUs = arrivalUs;
+    if (uartPending > 0) {
+        int32_t gap = (int32_t)(arrivalUs - lineFreeUs);
+        if (gap >= (int32_t)INJECT_UART_IDLE_US) {
+            deliver();
+        } else if (gap < 0) {
+            // 线路仍在传上一帧：模块排队后紧跟着发出，中间没有空闲间隔
+            if ((uint32_t)-gap > INJECT_LINE_BACKLOG_US) {
+                lineDropped++;
+                return;
+            }
+            startUs = lineFreeUs;
+        }
+    }
+    lineFreeUs = startUs + INJECT_FRAME_WIRE_US;
+    
+    uint16_t room = INJECT_UART_BUFFER_BYTES - uartPending;
+    uint16_t length = INJECT_FRAME_BYTES;
+    if (room < length) {
+        // 驱动缓冲区满，放不下的字节被丢弃，与串口驱动报告的溢出一致
+        Metrics::increment(METRIC_UART_OVERRUNS);
+        length = room;
+    } else if (uartFrames > 0) {
+        // 没有空闲间隔就不会触发接收超时，本帧与缓冲中的帧作为一段读出
+        mergedFrames++;
+    }
+    
+    memcpy(uartBuffer + uartPending, frame, length);
+    uartPending += length;
+    uartFrames++;
+}
+
+void InjectedAdapter::deliver() {
+    // 与 E220Adapter 的串口回调相同：整段搬入环形区后唤醒监听任务
+    rxRing.fill(uartBuffer, uartPending);
+    uartPending = 0;
+    uartFrames = 0;
+    if (frameCallback) {
+        frameCallback();
+    }
+}
+
+bool InjectedAdapter::frameAvailable() {
+    return rxRing.available();
+}
+
+void InjectedAdapter::setFrameCallback(std::function<void()> callback) {
+    frameCallback = callback;
+}
+
+int InjectedAdapter::readFrame(FrameView* view) {
+    return rxRing.peek(view);
+}
+
+void InjectedAdapter::releaseFrame() {
+    rxRing.release();
+}
+
+int InjectedAdapter::receiveFrame(void* frame) {
+    FrameView view;
+    int result = rxRing.peek(&view);
+    if (result == 0) {
+        RecvFrame_t* out = (RecvFrame_t*)frame;
+        memcpy(out->recv_data, view.data, view.length);
+        out->recv_data_len = view.length;
+        out->rssi = view.rssi;
+    }
+    if (result >= 0) {
+        rxRing.release();
+    }
+    return result;
+}
+
+StressHarness::StressHarness(InjectedAdapter* adapter)
+    : adapter(adapter), running(false), step(0), stepStartMs(0),
+      lastSequence(0), displayed(0), unseen(0), frames(0) {
+    memset(&stepStart, 0, sizeof(stepStart));
+    memset(deliveredPerSec, 0, sizeof(deliveredPerSec));
+    memset(offeredCount, 0, sizeof(offeredCount));
+    memset(lostCount, 0, sizeof(lostCount));
+}
+
+void StressHarness::begin(uint32_t nowMs) {
+    step = 0;
+    stepStartMs = nowMs;
+    stepStart = capture();
+    running = true;
+    adapter->setRate(STRESS_RATES[0]);
+}
+
+StressHarness::Totals StressHarness::capture() const {
+    Totals t;
+    t.offered = adapter->getOffered();
+    t.uartDropped = Metrics::get(METRIC_UART_OVERRUNS);
+    t.mergedFrames = adapter->getMergedFrames();
+    t.lineDropped = adapter->getLineDropped();
+    t.ringFull = Metrics::get(METRIC_FRAME_RING_FULL);
+    t.framesReceived = Metrics::get(METRIC_FRAMES_RECEIVED);
+    t.parseErrors = Metrics::get(METRIC_PARSE_ERRORS);
+    t.deferredFrames = Metrics::get(METRIC_DEFERRED_FRAMES);
+    t.evictions = Metrics::get(METRIC_POINT_EVICTIONS);
+    t.displayed = displayed;
+    t.unseen = unseen;
+    t.frames = frames;
+    return t;
+}
+
+void StressHarness::observeSnapshot(const PointRing& points) {
+    frames++;
+    
+    // 快照按序号递增排列；序号出现跳跃说明中间的点在显示前已被淘汰
+    for (const auto& point : points) {
+        if (point.sequence <= lastSequence) continue;
+        
+        if (lastSequence != 0 && point.sequence > lastSequence + 1) {
+            unseen += point.sequence - lastSequence - 1;
+        }
+        displayed++;
+        lastSequence = point.sequence;
+    }
+}
+
+void StressHarness::poll(uint32_t nowMs, Print& out) {
+    if (!running || nowMs - stepStartMs < STRESS_STEP_MS) return;
+    
+    finishStep(nowMs, out);
+}
+
+void StressHarness::finishStep(uint32_t nowMs, Print& out) {
+    Totals t = capture();
+    uint32_t elapsedMs = nowMs - stepStartMs;
+    
+    uint32_t offeredDelta = t.offered - stepStart.offered;
+    uint32_t lineLost = t.lineDropped - stepStart.lineDropped;
+    uint32_t uartLost = t.uartDropped - stepStart.uartDropped;
+    uint32_t ringLost = t.ringFull - stepStart.ringFull;
+    uint32_t parseLost = (t.mergedFrames - stepStart.mergedFrames) + (t.parseErrors - stepStart.parseErrors);
+    uint32_t deferred = t.deferredFrames - stepStart.deferredFrames;
+    uint32_t evicted = t.evictions - stepStart.evictions;
+    uint32_t unseenDelta = t.unseen - stepStart.unseen;
+    uint32_t shown = t.displayed - stepStart.displayed;
+    uint32_t fps = (t.frames - stepStart.frames) * 1000 / elapsedMs;
+    
+    uint32_t lost = lineLost + uartLost + ringLost + parseLost + unseenDelta;
+    uint32_t delivered = offeredDelta > lost ? offeredDelta - lost : 0;
+    deliveredPerSec[step] = delivered * 1000.0f / elapsedMs;
+    offeredCount[step] = offeredDelta;
+    lostCount[step] = lost;
+    
+    if (step == 0) {
+        out.println("=== Ingest Stress ===");
+        out.println("  rate  offered   line   uart   ring  parse  deferred  evicted  unseen  shown  fps  deliv/s");
+    }
+    out.printf("  %4u  %7lu  %5lu  %5lu  %5lu  %5lu  %8lu  %7lu  %6lu  %5lu  %3lu  %7.1f\n",
+        STRESS_RATES[step], offeredDelta, lineLost, uartLost, ringLost, parseLost, deferred, evicted,
+        unseenDelta, shown, fps, deliveredPerSec[step]);
+    
+    step++;
+    if (step >= STRESS_RATE_COUNT) {
+        adapter->setRate(0);
+        running = false;
+        report(out);
+        return;
+    }
+    
+    adapter->setRate(STRESS_RATES[step]);
+    stepStart = t;
+    stepStartMs = nowMs;
+}
+
+void StressHarness::report(Print& out) {
+    out.println("Throughput curve (offered -> delivered ev/s):");
+    
+    int8_t saturated = -1;
+    for (uint8_t i = 0; i < STRESS_RATE_COUNT; i++) {
+        out.printf("  %4u -> %.1f\n", STRESS_RATES[i], deliveredPerSec[i]);
+        if (saturated < 0 && lostCount[i] * 100 > offeredCount[i] * (100 - STRESS_SATURATION_PCT)) {
+            saturated = i;
+        }
+    }
+    
+    if (saturated < 0) {
+        out.printf("Saturation point: not reached up to %u ev/s\n", STRESS_RATES[STRESS_RATE_COUNT - 1]);
+    } else if (saturated == 0) {
+        out.printf("Saturation point: below %u ev/s\n", STRESS_RATES[0]);
+    } else {
+        out.printf("Saturation point: %u ev/s (last sustained %u ev/s)\n",
+            STRESS_RATES[saturated], STRESS_RATES[saturated - 1]);
+    }
+}
+
+#endif // LORASCOPE_STRESS
@@ -0,0 +1,124 @@
+#ifndef STRESS_H
+#define STRESS_H
+
+#include "common.h"
+#include "lora_adapter.h"
+#include "point_ring.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// 接收通路压力测试（仅在定义 LORASCOPE_STRESS 时编译，见 platformio.ini 的 m5cardputer_stress 环境）
+
+// 注入帧的负载长度与串口模型：工作波特率取 LORA_E220_UART_BAUD（8N1 每字节 10 位），
+// 驱动接收缓冲按 Arduino-ESP32 默认的 256 字节，线路空闲 2 个字符时间后触发接收回调
+const uint8_t INJECT_PAYLOAD_LEN = 24;
+const uint8_t INJECT_FRAME_BYTES = INJECT_PAYLOAD_LEN + 1;   // 负载 + RSSI 字节
+const uint16_t INJECT_UART_BUFFER_BYTES = 256;
+const uint8_t INJECT_UART_IDLE_SYMBOLS = 2;
+
+// 逐级提高的注入速率 (事件/秒) 与每级持续时间
+const uint16_t STRESS_RATES[] = { 1, 2, 5, 10, 20, 50, 100, 200 };
+const uint8_t STRESS_RATE_COUNT = sizeof(STRESS_RATES) / sizeof(STRESS_RATES[0]);
+const uint32_t STRESS_STEP_MS = 10000;
+// 送达率（1 - 丢失/注入）低于该百分比的最低速率视为饱和点
+const uint8_t STRESS_SATURATION_PCT = 95;
+
+// 注入帧适配器：按设定速率生成合成帧，经串口线路和驱动缓冲模型后
+// 在线路空闲时用 E220FrameRing::fill() 搬入与 E220Adapter 相同尺寸的帧环形区
+class InjectedAdapter : public LoRaAdapter {
+public:
+    InjectedAdapter();
+    ~InjectedAdapter();
+    
+    bool init() override;
+    bool setFrequency(uint32_t freqHz) override { return true; }
+    bool setBandwidth(uint16_t bandwidth) override { return true; }
+    bool setSpreadingFactor(uint8_t sf) override { return true; }
+    bool setCodingRate(uint8_t cr) override { return true; }
+    int16_t getRSSI() override { return -120; }
+    int16_t getSNR() override { return -20; }
+    bool receivePacket(uint8_t* buffer, size_t* length) override { return false; }
+    void standby() override {}
+    bool sleep() override { return false; }
+    LoRaModuleType getModuleType() override { return LORA_CUSTOM; }
+    String getModuleName() override { return "Injected"; }
+    
+    int receiveFrame(void* frame) override;
+    int readFrame(FrameView* view) override;
+    void releaseFrame() override;
+    bool frameAvailable() override;
+    void setFrameCallback(std::function<void()> callback) override;
+    
+    void setRate(uint16_t eventsPerSec);
+    uint32_t getOffered() const { return offered; }
+    uint32_t getMergedFrames() const { return mergedFrames; }
+    uint32_t getLineDropped() const { return lineDropped; }
+    
+private:
+    static void producerTask(void* param);
+    // 一帧开始在串口线路上传输（线路忙时紧跟上一帧之后）
+    void transmit(uint32_t startUs);
+    // 线路空闲：模拟串口驱动的接收超时回调
+    void deliver();
+    
+    E220FrameRing rxRing;
+    uint8_t uartBuffer[INJECT_UART_BUFFER_BYTES];   // 驱动接收缓冲，仅生产者任务访问
+    uint16_t uartPending;
+    uint8_t uartFrames;                               // 缓冲中已开始的帧数
+    uint32_t lineFreeUs;                              // 当前一段最后一个字节传完的时刻
+    
+    TaskHandle_t producerHandle;
+    std::function<void()> frameCallback;
+    volatile uint16_t rate;
+    volatile uint32_t offered;
+    volatile uint32_t mergedFrames;
+    volatile uint32_t lineDropped;
+};
+
+// 逐级注入并统计各阶段丢失，输出吞吐曲线与饱和点
+class StressHarness {
+public:
+    explicit StressHarness(InjectedAdapter* adapter);
+    
+    void begin(uint32_t nowMs);
+    // 界面每帧取得快照后调用，按事件序号统计显示到的和未显示就被淘汰的点
+    void observeSnapshot(const PointRing& points);
+    void poll(uint32_t nowMs, Print& out);
+    bool isRunning() const { return running; }
+    
+private:
+    struct Totals {
+        uint32_t offered;
+        uint32_t lineDropped;
+        uint32_t uartDropped;
+        uint32_t mergedFrames;
+        uint32_t ringFull;
+        uint32_t framesReceived;
+        uint32_t parseErrors;
+        uint32_t deferredFrames;
+        uint32_t evictions;
+        uint32_t displayed;
+        uint32_t unseen;
+        uint32_t frames;
+    };
+    
+    Totals capture() const;
+    void finishStep(uint32_t nowMs, Print& out);
+    void report(Print& out);
+    
+    InjectedAdapter* adapter;
+    bool running;
+    uint8_t step;
+    uint32_t stepStartMs;
+    Totals stepStart;
+    float deliveredPerSec[STRESS_RATE_COUNT];
+    uint32_t offeredCount[STRESS_RATE_COUNT];
+    uint32_t lostCount[STRESS_RATE_COUNT];
+    
+    uint32_t lastSequence;
+    uint32_t displayed;
+    uint32_t unseen;
+    uint32_t frames;
+};
+
+#endif // STRESS_H
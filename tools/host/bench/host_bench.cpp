@@ -0,0 +1,126 @@
+// 主机上的数据通路基准：多轮运行 datapath_bench 取每项最快一轮，
+// 与检入的基线文件比较，任一项慢于基线超过阈值时以非零状态退出
+#include "datapath_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+static const unsigned DEFAULT_ROUNDS = 15;
+static const double DEFAULT_THRESHOLD_PCT = 30.0;
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --baseline FILE  baseline file (default: %s)\n"
+            "  --threshold PCT  allowed slowdown over baseline (default: %.0f)\n"
+            "  --rounds N       runs per benchmark, fastest kept (default: %u)\n"
+            "  --update         rewrite the baseline with this run's results\n",
+            program, HOST_BENCH_BASELINE, DEFAULT_THRESHOLD_PCT, DEFAULT_ROUNDS);
+}
+
+// 每行 "名称 ns/op"，# 开头为注释
+static bool loadBaseline(const char* path, std::map<std::string, double>* baseline) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    
+    char line[256];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char name[64];
+        double nsPerOp;
+        if (sscanf(line, "%63s %lf", name, &nsPerOp) == 2) {
+            (*baseline)[name] = nsPerOp;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool saveBaseline(const char* path, const BenchResult* results, const double* nsPerOp, unsigned rounds) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    
+    fprintf(f, "# 数据通路基准基线（ns/op，%u 轮取最快），由 host_bench --update 生成\n", rounds);
+    fprintf(f, "# 编译器 %s\n", __VERSION__);
+    fprintf(f, "# 基线与测量机器相关：更换参考机器或有意改变热点路径的开销时重新生成并提交\n");
+    for (uint8_t i = 0; i < DATAPATH_BENCH_COUNT; i++) {
+        fprintf(f, "%-16s %.2f\n", results[i].name, nsPerOp[i]);
+    }
+    return fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* baselinePath = HOST_BENCH_BASELINE;
+    double thresholdPct = DEFAULT_THRESHOLD_PCT;
+    unsigned rounds = DEFAULT_ROUNDS;
+    bool update = false;
+    
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && hasValue) {
+            thresholdPct = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rounds") == 0 && hasValue) {
+            rounds = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0 ? 0 : 2;
+        }
+    }
+    if (rounds == 0) rounds = 1;
+    
+    BenchResult results[DATAPATH_BENCH_COUNT];
+    double best[DATAPATH_BENCH_COUNT];
+    for (unsigned round = 0; round < rounds; round++) {
+        if (!runDataPathBenchmarks(results, USBSerial)) {
+            fprintf(stderr, "[Bench] self-check failed\n");
+            return 1;
+        }
+        for (uint8_t i = 0; i < DATAPATH_BENCH_COUNT; i++) {
+            double nsPerOp = results[i].elapsedUs * 1000.0 / results[i].ops;
+            if (round == 0 || nsPerOp < best[i]) best[i] = nsPerOp;
+        }
+    }
+    
+    if (update) {
+        if (!saveBaseline(baselinePath, results, best, rounds)) {
+            fprintf(stderr, "[Bench] cannot write %s\n", baselinePath);
+            return 1;
+        }
+        printf("Baseline written to %s\n", baselinePath);
+        return 0;
+    }
+    
+    std::map<std::string, double> baseline;
+    if (!loadBaseline(baselinePath, &baseline)) {
+        fprintf(stderr, "[Bench] cannot read %s (run with --update to create it)\n", baselinePath);
+        return 1;
+    }
+    
+    printf("=== Host Benchmarks (fastest of %u rounds, threshold +%.0f%%) ===\n", rounds, thresholdPct);
+    printf("  name                  ns/op   baseline   change\n");
+    
+    bool ok = true;
+    for (uint8_t i = 0; i < DATAPATH_BENCH_COUNT; i++) {
+        std::map<std::string, double>::const_iterator it = baseline.find(results[i].name);
+        if (it == baseline.end() || it->second <= 0) {
+            printf("  %-16s %10.2f          -  no baseline\n", results[i].name, best[i]);
+            ok = false;
+            continue;
+        }
+    
+        double changePct = (best[i] - it->second) * 100.0 / it->second;
+        bool regressed = changePct > thresholdPct;
+        printf("  %-16s %10.2f %10.2f  %+6.1f%%%s\n", results[i].name, best[i], it->second, changePct,
+               regressed ? "  REGRESSION" : "");
+        if (regressed) ok = false;
+    }
+    
+    printf(ok ? "Result: PASS\n" : "Result: REGRESSION\n");
+    return ok ? 0 : 1;
+}
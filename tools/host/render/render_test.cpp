@@ -0,0 +1,291 @@
+// 渲染回归测试：把录制的设备事件流按监听器的方式写入雷达点缓冲区和各项聚合，
+// 在固定时钟下离屏渲染全部视图，帧指纹与检入的黄金值比较
+#include "display.h"
+#include "config.h"
+#include "event_codec.h"
+#include "quantile_sketch.h"
+#include "stream.h"
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// 录制结束 2 秒后渲染；热力图的本地时钟在录制开始时为 14:05
+static const uint64_t RENDER_DELAY_US = 2 * US_PER_SEC;
+static const uint32_t TRACE_TIME_OF_DAY = 14 * 3600 + 5 * 60;
+// 当前频点：录制中最活跃的 LoRaWAN 频点
+static const uint16_t TRACE_CURRENT_CHANNEL = 23;
+
+static const char* MODE_NAMES[] = {
+    "TIMELINE", "HISTOGRAM", "EVENTLIST", "STATISTICS", "FREQCOMPARE", "REALTIME", "RADAR", "HEATMAP"
+};
+
+static bool readFile(const std::string& path, std::vector<uint8_t>* out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    uint8_t buffer[1024];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        out->insert(out->end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return true;
+}
+
+// 从串口流中取出事件记录：跳过启动日志等文本和校验失败的记录
+static std::vector<RadarPoint> decodeTrace(const std::vector<uint8_t>& data) {
+    std::vector<RadarPoint> points;
+    size_t pos = 0;
+    while (pos + 3 < data.size()) {
+        uint8_t type = data[pos + 1];
+        uint8_t length = data[pos + 2];
+        if (data[pos] != STREAM_SYNC || pos + 4 + length > data.size()) {
+            pos++;
+            continue;
+        }
+    
+        uint8_t sum = type + length;
+        for (uint8_t i = 0; i < length; i++) sum += data[pos + 3 + i];
+        if (sum != data[pos + 3 + length]) {
+            pos++;
+            continue;
+        }
+    
+        RadarPoint point;
+        if (type == STREAM_RECORD_EVENT && decodeEvent(&data[pos + 3], length, &point)) {
+            points.push_back(point);
+        }
+        pos += 4 + length;
+    }
+    return points;
+}
+
+// 每行 "视图名 指纹"，# 开头为注释
+static bool loadGolden(const char* path, std::map<std::string, uint32_t>* golden) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        char name[32];
+        unsigned long checksum;
+        if (sscanf(line, "%31s %lx", name, &checksum) == 2) {
+            (*golden)[name] = (uint32_t)checksum;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool saveGolden(const char* path, const uint32_t* checksums) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    
+    fprintf(f, "# 渲染黄金指纹：render_test 用 data/trace.bin 在主机画布上渲染的各视图帧指纹\n");
+    fprintf(f, "# 由 render_test --update 生成；界面有意改动后重新生成并检查 --dump 输出的图像\n");
+    for (uint8_t m = MODE_TIMELINE; m <= MODE_HEATMAP; m++) {
+        fprintf(f, "%-12s %08lx\n", MODE_NAMES[m], (unsigned long)checksums[m]);
+    }
+    return fclose(f) == 0;
+}
+
+// 把当前帧（大端 RGB565）写成 PPM，便于查看差异
+static bool writePpm(const std::string& path, const ScopeDisplay& display) {
+    struct FrameCapture : public Print {
+        std::vector<uint8_t> bytes;
+        size_t write(uint8_t c) { bytes.push_back(c); return 1; }
+    } capture;
+    display.dumpFrame(capture);
+    
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n240 135\n255\n");
+    for (size_t i = 0; i + 1 < capture.bytes.size(); i += 2) {
+        uint16_t color = (capture.bytes[i] << 8) | capture.bytes[i + 1];
+        uint8_t rgb[3] = {
+            (uint8_t)((color >> 11) * 255 / 31),
+            (uint8_t)(((color >> 5) & 0x3F) * 255 / 63),
+            (uint8_t)((color & 0x1F) * 255 / 31)
+        };
+        fwrite(rgb, 1, 3, f);
+    }
+    return fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+    const char* goldenPath = RENDER_GOLDEN;
+    const char* dumpDir = nullptr;
+    bool update = false;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            goldenPath = argv[++i];
+        } else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+            dumpDir = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--update] [--golden FILE] [--dump DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    std::vector<uint8_t> data;
+    if (!readFile(RENDER_TEST_DATA "/trace.bin", &data)) {
+        fprintf(stderr, "cannot read %s/trace.bin\n", RENDER_TEST_DATA);
+        return 1;
+    }
+    std::vector<RadarPoint> trace = decodeTrace(data);
+    if (trace.empty()) {
+        fprintf(stderr, "trace has no events\n");
+        return 1;
+    }
+    
+    // 与设备默认配置相同的频点计划和缓冲区容量
+    LoRaScopeConfig config;
+    ChannelPlanRef plan = config.getChannelPlan();
+    uint16_t channelCount = plan->size();
+    
+    PointRing points;
+    points.setCapacity(config.maxPoints);
+    RssiHistogram histogram;
+    histogram.setChannelCount(channelCount);
+    RssiPyramid pyramid;
+    OccupancyHeatmap heatmap;
+    heatmap.setChannelCount(channelCount, 0);
+    heatmap.setTimeOfDay(TRACE_TIME_OF_DAY, trace.front().timestampUs());
+    RssiQuantileSketch quantiles;
+    EventStats stats;
+    std::vector<std::set<uint32_t> > sources(channelCount);
+    std::vector<uint8_t> protocols(channelCount, 0);
+    
+    // 按 FrequencyListener::recordPoint 与统计更新的顺序写入
+    for (size_t i = 0; i < trace.size(); i++) {
+        const RadarPoint& point = trace[i];
+        RadarPoint evicted;
+        if (points.push(point, &evicted)) {
+            histogram.remove(evicted.rssi, evicted.channelIndex);
+        }
+        histogram.add(point.rssi, point.channelIndex);
+        pyramid.add(point.channelIndex, point.timestampUs(), point.rssi, point.eventType != EVENT_RX_DONE);
+        heatmap.add(point.channelIndex, point.timestampUs());
+    
+        stats.totalEvents++;
+        stats.lastEventTime = point.timestampUs();
+        if (stats.firstEventTime == 0) stats.firstEventTime = point.timestampUs();
+        if (point.eventType != EVENT_RX_DONE) {
+            stats.rxErrorCount++;
+            continue;
+        }
+    
+        quantiles.add(point.rssi);
+        stats.rxDoneCount++;
+        if (point.rssi > stats.maxRssi) stats.maxRssi = point.rssi;
+        if (point.rssi < stats.minRssi || stats.minRssi == -120) stats.minRssi = point.rssi;
+        stats.rssiSum += point.rssi;
+        stats.avgRssi = (float)stats.rssiSum / stats.rxDoneCount;
+        stats.rssiP10 = quantiles.quantile(0.10f);
+        stats.rssiP50 = quantiles.quantile(0.50f);
+        stats.rssiP90 = quantiles.quantile(0.90f);
+        stats.rssiP99 = quantiles.quantile(0.99f);
+        if (point.duplicate) {
+            stats.duplicateCount++;
+        } else if (point.channelIndex < channelCount) {
+            // 录制中没有负载，发送方按负载指纹区分
+            sources[point.channelIndex].insert(point.fingerprint);
+            protocols[point.channelIndex] |= 1 << point.protocol;
+        }
+    }
+    
+    std::set<uint32_t> allSources;
+    for (uint16_t ch = 0; ch < channelCount; ch++) {
+        allSources.insert(sources[ch].begin(), sources[ch].end());
+    }
+    stats.distinctSources = allSources.size();
+    
+    EventIndex index;
+    index.sync(points, channelCount);
+    RssiHistogramSnapshot histogramSnapshot;
+    histogram.snapshot(TRACE_CURRENT_CHANNEL, &histogramSnapshot);
+    
+    ScopeDisplay display;
+    if (!display.initHeadless()) {
+        fprintf(stderr, "headless display init failed\n");
+        return 1;
+    }
+    display.setClockOverride(trace.back().timestampUs() + RENDER_DELAY_US);
+    display.setChannelPlan(plan);
+    for (uint16_t ch = 0; ch < channelCount; ch++) {
+        display.setChannelSources(ch, sources[ch].size());
+        display.setChannelProtocols(ch, protocols[ch]);
+    }
+    display.setRssiHistogram(&histogramSnapshot);
+    display.setOccupancy(&heatmap);
+    display.setRssiPyramid(&pyramid);
+    display.setEventIndex(&index);
+    display.setModuleName("E220-433");
+    display.setCurrentFreq(plan->frequencyAt(TRACE_CURRENT_CHANNEL));
+    display.setCurrentFreqIndex(TRACE_CURRENT_CHANNEL, channelCount);
+    display.setScanning(true);
+    display.setCurrentRssi(trace.back().rssi);
+    display.setBatteryPct(87);
+    
+    uint32_t checksums[MODE_HEATMAP + 1];
+    int failures = 0;
+    for (uint8_t m = MODE_TIMELINE; m <= MODE_HEATMAP; m++) {
+        display.setMode((DisplayMode)m);
+        // 第二帧走静态部分缓存、标签缓存和余辉层的已打点路径，须与第一帧完全一致
+        display.update(points, stats);
+        uint32_t first = display.frameChecksum();
+        display.update(points, stats);
+        checksums[m] = display.frameChecksum();
+        if (first != checksums[m]) {
+            fprintf(stderr, "%s: cached frame %08lx differs from first frame %08lx\n",
+                    MODE_NAMES[m], (unsigned long)checksums[m], (unsigned long)first);
+            failures++;
+        }
+    
+        if (dumpDir) {
+            std::string path = std::string(dumpDir) + "/" + MODE_NAMES[m] + ".ppm";
+            if (!writePpm(path, display)) {
+                fprintf(stderr, "cannot write %s\n", path.c_str());
+                failures++;
+            }
+        }
+    }
+    
+    if (update) {
+        if (!saveGolden(goldenPath, checksums)) {
+            fprintf(stderr, "cannot write %s\n", goldenPath);
+            return 1;
+        }
+        printf("Golden checksums written to %s\n", goldenPath);
+        return failures == 0 ? 0 : 1;
+    }
+    
+    std::map<std::string, uint32_t> golden;
+    if (!loadGolden(goldenPath, &golden)) {
+        fprintf(stderr, "cannot read %s (run with --update to create it)\n", goldenPath);
+        return 1;
+    }
+    
+    printf("%zu events from trace, %u in ring\n", trace.size(), (unsigned)points.size());
+    printf("  mode          checksum    golden\n");
+    for (uint8_t m = MODE_TIMELINE; m <= MODE_HEATMAP; m++) {
+        std::map<std::string, uint32_t>::const_iterator it = golden.find(MODE_NAMES[m]);
+        bool match = it != golden.end() && it->second == checksums[m];
+        if (it == golden.end()) {
+            printf("  %-12s  %08lx         -  MISSING\n", MODE_NAMES[m], (unsigned long)checksums[m]);
+        } else {
+            printf("  %-12s  %08lx  %08lx%s\n", MODE_NAMES[m], (unsigned long)checksums[m],
+                   (unsigned long)it->second, match ? "" : "  MISMATCH");
+        }
+        if (!match) failures++;
+    }
+    
+    printf(failures == 0 ? "Result: PASS\n" : "Result: FAILED\n");
+    return failures == 0 ? 0 : 1;
+}
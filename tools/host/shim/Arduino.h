@@ -0,0 +1,128 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// 主机构建用的 Arduino 最小子集：String、Print、USBSerial 与时基，
+// 只覆盖设备端源码在主机上编译的部分实际用到的接口
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+#define IRAM_ATTR
+#define PI 3.1415926535897932384626433832795
+#define DEC 10
+#define HEX 16
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class String {
+public:
+    String(const char* text = "") : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    explicit String(char c) : value(1, c) {}
+    String(unsigned char number, unsigned char base = DEC) : value(format((unsigned long)number, base)) {}
+    String(int number, unsigned char base = DEC) : value(formatSigned(number, base)) {}
+    String(unsigned int number, unsigned char base = DEC) : value(format(number, base)) {}
+    String(long number, unsigned char base = DEC) : value(formatSigned(number, base)) {}
+    String(unsigned long number, unsigned char base = DEC) : value(format(number, base)) {}
+    String(long long number, unsigned char base = DEC) : value(formatSigned(number, base)) {}
+    String(unsigned long long number, unsigned char base = DEC) : value(format(number, base)) {}
+    String(float number, unsigned int decimals = 2) : value(formatFloat(number, decimals)) {}
+    String(double number, unsigned int decimals = 2) : value(formatFloat(number, decimals)) {}
+    
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return (unsigned int)value.size(); }
+    bool isEmpty() const { return value.empty(); }
+    void reserve(unsigned int size) { value.reserve(size); }
+    char charAt(unsigned int index) const { return index < value.size() ? value[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    bool concat(const String& other) { value += other.value; return true; }
+    
+    friend String operator+(const String& a, const String& b) { return String(a.value + b.value); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a) + b.value); }
+    friend String operator+(const String& a, const char* b) { return String(a.value + b); }
+    friend String operator+(const String& a, char b) { return String(a.value + b); }
+    
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == other; }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator!=(const char* other) const { return value != other; }
+    
+    bool startsWith(const String& prefix) const { return value.compare(0, prefix.value.size(), prefix.value) == 0; }
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = value.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    String substring(unsigned int from) const { return from < value.size() ? String(value.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= value.size()) return String();
+        return String(value.substr(from, to - from));
+    }
+    long toInt() const { return atol(value.c_str()); }
+    float toFloat() const { return (float)atof(value.c_str()); }
+    void trim() {
+        size_t first = value.find_first_not_of(" \t\r\n");
+        size_t last = value.find_last_not_of(" \t\r\n");
+        value = first == std::string::npos ? std::string() : value.substr(first, last - first + 1);
+    }
+    void toLowerCase() {
+        for (size_t i = 0; i < value.size(); i++) value[i] = (char)tolower((unsigned char)value[i]);
+    }
+    
+private:
+    static std::string format(unsigned long long number, unsigned char base);
+    static std::string formatSigned(long long number, unsigned char base);
+    static std::string formatFloat(double number, unsigned int decimals);
+    
+    std::string value;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+    
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int number, int base = DEC) { return print(String(number, base)); }
+    size_t print(unsigned int number, int base = DEC) { return print(String(number, base)); }
+    size_t print(long number, int base = DEC) { return print(String(number, base)); }
+    size_t print(unsigned long number, int base = DEC) { return print(String(number, base)); }
+    size_t print(double number, int decimals = 2) { return print(String(number, decimals)); }
+    
+    size_t println() { return write("\r\n"); }
+    template<class T> size_t println(const T& value) { return print(value) + println(); }
+    template<class T> size_t println(const T& value, int format) { return print(value, format) + println(); }
+    
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// 标准输出上的串口，行尾与设备一致为 "\r\n"
+class USBCDC : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) { return fwrite(buffer, 1, size, stdout); }
+    using Print::write;
+};
+
+extern USBCDC USBSerial;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+#endif // HOST_ARDUINO_H
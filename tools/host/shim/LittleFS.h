@@ -0,0 +1,24 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+// 主机上没有闪存分区：挂载失败，热力图检查点不读不写
+#include <Arduino.h>
+
+class File {
+public:
+    size_t read(uint8_t*, size_t) { return 0; }
+    size_t write(const uint8_t*, size_t) { return 0; }
+    void close() {}
+    operator bool() const { return false; }
+};
+
+class LittleFSFS {
+public:
+    bool begin(bool) { return false; }
+    File open(const char*, const char*) { return File(); }
+    bool rename(const char*, const char*) { return false; }
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
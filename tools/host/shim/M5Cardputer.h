@@ -0,0 +1,117 @@
+#ifndef HOST_M5CARDPUTER_H
+#define HOST_M5CARDPUTER_H
+
+// 主机构建用的 M5GFX 子集：M5Canvas 在内存中按真实色深（16 位 RGB565、8 位与 1 位调色板）
+// 光栅化，文字使用固定的 5x7 点阵字体。像素与设备上的 M5GFX 不逐点一致，
+// 只保证同一输入在主机上得到同一帧，用于渲染回归比对
+#include <Arduino.h>
+
+#define TFT_BLACK       0x0000
+#define TFT_BLUE        0x001F
+#define TFT_RED         0xF800
+#define TFT_GREEN       0x07E0
+#define TFT_DARKGREEN   0x03E0
+#define TFT_CYAN        0x07FF
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_ORANGE      0xFDA0
+#define TFT_DARKGREY    0x7BEF
+#define TFT_WHITE       0xFFFF
+
+// 与 LovyanGFX 的 textdatum_t 取值一致
+enum textdatum_t {
+    top_left = 0, top_center = 1, top_right = 2,
+    middle_left = 4, middle_center = 5, middle_right = 6,
+    bottom_left = 8, bottom_center = 9, bottom_right = 10
+};
+
+// 屏幕本身不存在，推送到屏幕的操作都是空操作
+class LGFX_Device {
+public:
+    void init() {}
+    void setRotation(uint8_t) {}
+    void fillScreen(uint32_t) {}
+    int32_t width() const { return 240; }
+    int32_t height() const { return 135; }
+};
+
+class M5Canvas {
+public:
+    M5Canvas();
+    explicit M5Canvas(LGFX_Device* parent);
+    explicit M5Canvas(M5Canvas* parent);
+    ~M5Canvas();
+    
+    void setColorDepth(int bits);
+    void* createSprite(int32_t w, int32_t h);
+    void deleteSprite();
+    bool createPalette();
+    // 调色板颜色：RGB565，或分量形式的 RGB888
+    void setPaletteColor(size_t index, uint16_t rgb565);
+    void setPaletteColor(size_t index, uint8_t r, uint8_t g, uint8_t b);
+    
+    // 16 位精灵按大端 RGB565 存放（与 M5GFX 一致），调色板精灵每像素为调色板序号
+    void* getBuffer() const { return buffer; }
+    uint32_t bufferLength() const { return length; }
+    int32_t width() const { return spriteWidth; }
+    int32_t height() const { return spriteHeight; }
+    
+    // 绘制颜色：16 位精灵为 RGB565，调色板精灵为调色板序号
+    void fillSprite(uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+    
+    void setTextColor(uint32_t fg) { textFg = fg; textBgEnabled = false; }
+    void setTextColor(uint32_t fg, uint32_t bg) { textFg = fg; textBg = bg; textBgEnabled = true; }
+    void setTextSize(float size) { textScale = size < 1 ? 1 : (uint8_t)size; }
+    void setTextDatum(uint8_t datum) { textDatum = datum; }
+    int32_t fontHeight() const { return 8 * textScale; }
+    int32_t textWidth(const char* text) const { return 6 * textScale * (int32_t)strlen(text); }
+    int32_t textWidth(const String& text) const { return textWidth(text.c_str()); }
+    size_t drawString(const char* text, int32_t x, int32_t y);
+    size_t drawString(const String& text, int32_t x, int32_t y) { return drawString(text.c_str(), x, y); }
+    
+    // 推送到屏幕：空操作
+    void pushSprite(int32_t, int32_t) {}
+    // 叠加到另一块精灵，transp 为透明色（调色板精灵为调色板序号）
+    void pushSprite(M5Canvas* dst, int32_t x, int32_t y);
+    void pushSprite(M5Canvas* dst, int32_t x, int32_t y, uint32_t transp);
+    
+private:
+    M5Canvas(const M5Canvas&);
+    M5Canvas& operator=(const M5Canvas&);
+    
+    uint16_t readRgb565(int32_t x, int32_t y) const;
+    uint32_t readRaw(int32_t x, int32_t y) const;
+    void pushPixels(M5Canvas* dst, int32_t x, int32_t y, bool transparent, uint32_t transp);
+    void drawGlyph(char c, int32_t x, int32_t y);
+    
+    uint8_t depth;
+    int32_t spriteWidth;
+    int32_t spriteHeight;
+    uint8_t* buffer;
+    uint32_t length;
+    uint16_t palette[256];
+    
+    uint32_t textFg;
+    uint32_t textBg;
+    bool textBgEnabled;
+    uint8_t textScale;
+    uint8_t textDatum;
+};
+
+struct M5Cardputer_Class {
+    LGFX_Device Display;
+};
+
+extern M5Cardputer_Class M5Cardputer;
+
+#endif // HOST_M5CARDPUTER_H
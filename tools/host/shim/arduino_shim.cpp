@@ -0,0 +1,75 @@
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_timer.h>
+#include <time.h>
+#include <unistd.h>
+
+USBCDC USBSerial;
+LittleFSFS LittleFS;
+
+std::string String::format(unsigned long long number, unsigned char base) {
+    if (base < 2 || base > 36) base = DEC;
+    char digits[65];
+    size_t pos = sizeof(digits);
+    digits[--pos] = '\0';
+    do {
+        unsigned digit = (unsigned)(number % base);
+        digits[--pos] = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        number /= base;
+    } while (number > 0);
+    return std::string(digits + pos);
+}
+
+std::string String::formatSigned(long long number, unsigned char base) {
+    // 与 Arduino 一致：只有十进制带符号，其他进制按无符号输出
+    if (base == DEC && number < 0) {
+        return "-" + format(0ULL - (unsigned long long)number, base);
+    }
+    return format((unsigned long long)number, base);
+}
+
+std::string String::formatFloat(double number, unsigned int decimals) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, number);
+    return buffer;
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (size-- > 0) written += write(*buffer++);
+    return written;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if ((size_t)length < sizeof(stackBuffer)) return write((const uint8_t*)stackBuffer, length);
+    
+    std::string text(length + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&text[0], text.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)text.data(), length);
+}
+
+int64_t esp_timer_get_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+unsigned long millis() {
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)esp_timer_get_time();
+}
+
+void delay(unsigned long ms) {
+    usleep(ms * 1000);
+}
@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+
+// 单调时钟（CLOCK_MONOTONIC）的微秒数
+int64_t esp_timer_get_time();
+
+#endif // HOST_ESP_TIMER_H
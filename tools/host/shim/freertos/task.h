@@ -0,0 +1,11 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+inline BaseType_t xTaskCreate(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t*) {
+    return pdFAIL;
+}
+inline void vTaskDelete(TaskHandle_t) {}
+
+#endif // HOST_FREERTOS_TASK_H
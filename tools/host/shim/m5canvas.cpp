@@ -0,0 +1,298 @@
+#include <M5Cardputer.h>
+
+M5Cardputer_Class M5Cardputer;
+
+// 5x7 点阵 ASCII 字体（0x20 ~ 0x7E），每字 5 列，每列低位在上；字符格 6x8
+static const uint8_t FONT_5X7[][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+    {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+    {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x14, 0x08, 0x3E, 0x08, 0x14}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+    {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00},
+    {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3E},
+    {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+    {0x3E, 0x41, 0x49, 0x49, 0x7A}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+    {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+    {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+    {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+    {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7F},
+    {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00},
+    {0x7F, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7C, 0x14, 0x14, 0x14, 0x08},
+    {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+    {0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C},
+    {0x3C, 0x40, 0x30, 0x40, 0x3C}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7F, 0x00, 0x00},
+    {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08}
+};
+// 字体之外的字节（UTF-8 等）显示为空心方块
+static const uint8_t GLYPH_UNKNOWN[5] = {0x7F, 0x41, 0x41, 0x41, 0x7F};
+
+static uint16_t rgb888To565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+M5Canvas::M5Canvas()
+    : depth(16), spriteWidth(0), spriteHeight(0), buffer(nullptr), length(0),
+      textFg(TFT_WHITE), textBg(TFT_BLACK), textBgEnabled(false), textScale(1), textDatum(top_left) {
+    createPalette();
+}
+
+M5Canvas::M5Canvas(LGFX_Device*)
+    : depth(16), spriteWidth(0), spriteHeight(0), buffer(nullptr), length(0),
+      textFg(TFT_WHITE), textBg(TFT_BLACK), textBgEnabled(false), textScale(1), textDatum(top_left) {
+    createPalette();
+}
+
+M5Canvas::M5Canvas(M5Canvas*)
+    : depth(16), spriteWidth(0), spriteHeight(0), buffer(nullptr), length(0),
+      textFg(TFT_WHITE), textBg(TFT_BLACK), textBgEnabled(false), textScale(1), textDatum(top_left) {
+    createPalette();
+}
+
+M5Canvas::~M5Canvas() {
+    deleteSprite();
+}
+
+void M5Canvas::setColorDepth(int bits) {
+    depth = bits <= 1 ? 1 : (bits <= 8 ? 8 : 16);
+}
+
+void* M5Canvas::createSprite(int32_t w, int32_t h) {
+    deleteSprite();
+    if (w <= 0 || h <= 0) return nullptr;
+    
+    uint32_t stride = depth == 1 ? (w + 7) / 8 : w * (depth / 8);
+    length = stride * h;
+    buffer = (uint8_t*)calloc(length, 1);
+    if (!buffer) {
+        length = 0;
+        return nullptr;
+    }
+    spriteWidth = w;
+    spriteHeight = h;
+    return buffer;
+}
+
+void M5Canvas::deleteSprite() {
+    free(buffer);
+    buffer = nullptr;
+    length = 0;
+    spriteWidth = 0;
+    spriteHeight = 0;
+}
+
+bool M5Canvas::createPalette() {
+    // 默认调色板：0 黑、1 白，其余按 RGB332 展开
+    for (uint16_t i = 0; i < 256; i++) {
+        palette[i] = rgb888To565((i >> 5) * 255 / 7, ((i >> 2) & 7) * 255 / 7, (i & 3) * 255 / 3);
+    }
+    palette[1] = TFT_WHITE;
+    return true;
+}
+
+void M5Canvas::setPaletteColor(size_t index, uint16_t rgb565) {
+    if (index < 256) palette[index] = rgb565;
+}
+
+void M5Canvas::setPaletteColor(size_t index, uint8_t r, uint8_t g, uint8_t b) {
+    if (index < 256) palette[index] = rgb888To565(r, g, b);
+}
+
+void M5Canvas::fillSprite(uint32_t color) {
+    fillRect(0, 0, spriteWidth, spriteHeight, color);
+}
+
+void M5Canvas::drawPixel(int32_t x, int32_t y, uint32_t color) {
+    if (!buffer || x < 0 || y < 0 || x >= spriteWidth || y >= spriteHeight) return;
+    
+    if (depth == 16) {
+        uint8_t* pixel = buffer + (y * spriteWidth + x) * 2;
+        pixel[0] = (uint8_t)(color >> 8);
+        pixel[1] = (uint8_t)color;
+    } else if (depth == 8) {
+        buffer[y * spriteWidth + x] = (uint8_t)color;
+    } else {
+        uint8_t* pixel = buffer + y * ((spriteWidth + 7) / 8) + x / 8;
+        uint8_t mask = 0x80 >> (x & 7);
+        *pixel = (color & 1) ? (*pixel | mask) : (*pixel & ~mask);
+    }
+}
+
+uint32_t M5Canvas::readRaw(int32_t x, int32_t y) const {
+    if (depth == 16) {
+        const uint8_t* pixel = buffer + (y * spriteWidth + x) * 2;
+        return ((uint32_t)pixel[0] << 8) | pixel[1];
+    }
+    if (depth == 8) return buffer[y * spriteWidth + x];
+    return (buffer[y * ((spriteWidth + 7) / 8) + x / 8] >> (7 - (x & 7))) & 1;
+}
+
+uint16_t M5Canvas::readRgb565(int32_t x, int32_t y) const {
+    uint32_t raw = readRaw(x, y);
+    return depth == 16 ? (uint16_t)raw : palette[raw];
+}
+
+void M5Canvas::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    for (int32_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void M5Canvas::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    for (int32_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void M5Canvas::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    for (int32_t row = 0; row < h; row++) drawFastHLine(x, y + row, w, color);
+}
+
+void M5Canvas::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    if (w <= 0 || h <= 0) return;
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void M5Canvas::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color) {
+    if (w <= 0 || h <= 0) return;
+    r = std::min(r, std::min(w, h) / 2);
+    fillRect(x, y + r, w, h - 2 * r, color);
+    // 上下各 r 行按圆角收窄
+    for (int32_t dy = 0; dy < r; dy++) {
+        int32_t yy = r - dy;
+        int32_t inset = r - (int32_t)sqrt((double)(r * r - yy * yy));
+        drawFastHLine(x + inset, y + dy, w - 2 * inset, color);
+        drawFastHLine(x + inset, y + h - 1 - dy, w - 2 * inset, color);
+    }
+}
+
+void M5Canvas::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    // Bresenham
+    int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    while (true) {
+        drawPixel(x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int32_t e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+void M5Canvas::drawCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color) {
+    if (r < 0) return;
+    // 中点画圆，八分对称
+    int32_t x = r, y = 0, err = 1 - r;
+    while (x >= y) {
+        drawPixel(cx + x, cy + y, color); drawPixel(cx - x, cy + y, color);
+        drawPixel(cx + x, cy - y, color); drawPixel(cx - x, cy - y, color);
+        drawPixel(cx + y, cy + x, color); drawPixel(cx - y, cy + x, color);
+        drawPixel(cx + y, cy - x, color); drawPixel(cx - y, cy - x, color);
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void M5Canvas::fillCircle(int32_t cx, int32_t cy, int32_t r, uint32_t color) {
+    if (r < 0) return;
+    for (int32_t dy = -r; dy <= r; dy++) {
+        int32_t half = (int32_t)sqrt((double)(r * r - dy * dy));
+        drawFastHLine(cx - half, cy + dy, 2 * half + 1, color);
+    }
+}
+
+void M5Canvas::fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+    // 逐行求三条边与扫描线交点的范围
+    int32_t top = std::min(y0, std::min(y1, y2));
+    int32_t bottom = std::max(y0, std::max(y1, y2));
+    const int32_t xs[3] = {x0, x1, x2};
+    const int32_t ys[3] = {y0, y1, y2};
+    for (int32_t y = top; y <= bottom; y++) {
+        int32_t left = INT32_MAX, right = INT32_MIN;
+        for (uint8_t e = 0; e < 3; e++) {
+            int32_t ax = xs[e], ay = ys[e], bx = xs[(e + 1) % 3], by = ys[(e + 1) % 3];
+            if (y < std::min(ay, by) || y > std::max(ay, by)) continue;
+            if (ay == by) {
+                left = std::min(left, std::min(ax, bx));
+                right = std::max(right, std::max(ax, bx));
+            } else {
+                int32_t x = ax + (bx - ax) * (y - ay) / (by - ay);
+                left = std::min(left, x);
+                right = std::max(right, x);
+            }
+        }
+        if (left <= right) drawFastHLine(left, y, right - left + 1, color);
+    }
+}
+
+void M5Canvas::drawGlyph(char c, int32_t x, int32_t y) {
+    const uint8_t* glyph = (c >= 0x20 && c <= 0x7E) ? FONT_5X7[c - 0x20] : GLYPH_UNKNOWN;
+    if (textBgEnabled) fillRect(x, y, 6 * textScale, 8 * textScale, textBg);
+    for (uint8_t col = 0; col < 5; col++) {
+        for (uint8_t row = 0; row < 7; row++) {
+            if (glyph[col] & (1 << row)) {
+                fillRect(x + col * textScale, y + row * textScale, textScale, textScale, textFg);
+            }
+        }
+    }
+}
+
+size_t M5Canvas::drawString(const char* text, int32_t x, int32_t y) {
+    int32_t width = textWidth(text);
+    int32_t height = fontHeight();
+    // datum 低 2 位为水平对齐，高位为垂直对齐
+    switch (textDatum & 3) {
+        case 1: x -= width / 2; break;
+        case 2: x -= width; break;
+        default: break;
+    }
+    switch (textDatum >> 2) {
+        case 1: y -= height / 2; break;
+        case 2: y -= height; break;
+        default: break;
+    }
+    
+    for (const char* p = text; *p; p++, x += 6 * textScale) {
+        drawGlyph(*p, x, y);
+    }
+    return width;
+}
+
+void M5Canvas::pushSprite(M5Canvas* dst, int32_t x, int32_t y) {
+    pushPixels(dst, x, y, false, 0);
+}
+
+void M5Canvas::pushSprite(M5Canvas* dst, int32_t x, int32_t y, uint32_t transp) {
+    pushPixels(dst, x, y, true, transp);
+}
+
+void M5Canvas::pushPixels(M5Canvas* dst, int32_t x, int32_t y, bool transparent, uint32_t transp) {
+    if (!buffer || !dst || !dst->buffer) return;
+    
+    for (int32_t row = 0; row < spriteHeight; row++) {
+        for (int32_t col = 0; col < spriteWidth; col++) {
+            if (transparent && readRaw(col, row) == transp) continue;
+            // 目标为调色板精灵时按原始值复制
+            uint32_t color = dst->depth == 16 ? readRgb565(col, row) : readRaw(col, row);
+            dst->drawPixel(x + col, y + row, color);
+        }
+    }
+}
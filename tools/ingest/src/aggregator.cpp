@@ -0,0 +1,151 @@
+#include "aggregator.h"
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+void Aggregator::addEvent(const std::string& device, const Event& event) {
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    std::map<uint16_t, ChannelStats>& channels = devices[device].channels;
+    std::map<uint16_t, ChannelStats>::iterator it = channels.find(event.channel);
+    if (it == channels.end()) {
+        ChannelStats stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.rssiMax = -128;
+        it = channels.insert(std::make_pair(event.channel, stats)).first;
+    }
+    
+    ChannelStats& stats = it->second;
+    stats.frequency = event.frequency;
+    if (event.type < TYPE_COUNT) stats.events[event.type]++;
+    if (event.duplicate) stats.duplicates++;
+    if (event.timestampUs > stats.lastSeenUs) stats.lastSeenUs = event.timestampUs;
+    
+    // 只有成功接收的帧带有可信的 RSSI 和协议
+    if (event.type == EVENT_RX_DONE) {
+        stats.rssiSum += event.rssi;
+        stats.rssiCount++;
+        if (event.rssi > stats.rssiMax) stats.rssiMax = event.rssi;
+        if (event.protocol < PROTOCOL_COUNT) stats.protocols[event.protocol]++;
+    }
+}
+
+void Aggregator::setDeviceMetrics(const std::string& device, const std::vector<uint32_t>& values) {
+    std::lock_guard<std::mutex> lock(mutex);
+    devices[device].metrics = values;
+}
+
+void Aggregator::setStreamStats(const std::string& device, const StreamStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex);
+    devices[device].stream = stats;
+}
+
+static void appendf(std::string& out, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+static void appendf(std::string& out, const char* format, ...) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (n > 0) out.append(line, n < (int)sizeof(line) ? n : (int)sizeof(line) - 1);
+}
+
+static void appendHeader(std::string& out, const char* name, const char* type, const char* help) {
+    appendf(out, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+template <typename Fn>
+void Aggregator::appendChannelFamily(std::string& out, const char* name, const char* type,
+                                     const char* help, Fn sample) const {
+    appendHeader(out, name, type, help);
+    std::map<std::string, DeviceStats>::const_iterator dev;
+    std::map<uint16_t, ChannelStats>::const_iterator ch;
+    for (dev = devices.begin(); dev != devices.end(); ++dev) {
+        for (ch = dev->second.channels.begin(); ch != dev->second.channels.end(); ++ch) {
+            sample(out, dev->first.c_str(), ch->first, ch->second);
+        }
+    }
+}
+
+std::string Aggregator::renderPrometheus() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string out;
+    out.reserve(4096);
+    std::map<std::string, DeviceStats>::const_iterator dev;
+    
+    // 文本格式要求同一指标族的样本连续出现在其 HELP/TYPE 之后，因此逐族遍历全部信道
+    appendChannelFamily(out, "lorascope_channel_events_total", "counter", "Events received per channel and event type.",
+        [](std::string& o, const char* device, uint16_t channel, const ChannelStats& s) {
+            for (int t = 0; t < TYPE_COUNT; t++) {
+                appendf(o, "lorascope_channel_events_total{device=\"%s\",channel=\"%u\",frequency=\"%u\",type=\"%s\"} %" PRIu64 "\n",
+                        device, channel, s.frequency, eventTypeName(t), s.events[t]);
+            }
+        });
+    
+    appendChannelFamily(out, "lorascope_channel_protocol_frames_total", "counter", "Received frames per channel and detected protocol.",
+        [](std::string& o, const char* device, uint16_t channel, const ChannelStats& s) {
+            for (int p = 0; p < PROTOCOL_COUNT; p++) {
+                if (s.protocols[p] == 0) continue;
+                appendf(o, "lorascope_channel_protocol_frames_total{device=\"%s\",channel=\"%u\",protocol=\"%s\"} %" PRIu64 "\n",
+                        device, channel, protocolName(p), s.protocols[p]);
+            }
+        });
+    
+    appendChannelFamily(out, "lorascope_channel_duplicates_total", "counter", "Frames flagged as duplicates by the device.",
+        [](std::string& o, const char* device, uint16_t channel, const ChannelStats& s) {
+            appendf(o, "lorascope_channel_duplicates_total{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", device, channel, s.duplicates);
+        });
+    
+    // 不带分位数的 summary：_sum/_count 是 summary 的保留后缀，不能作为独立计数器导出
+    appendChannelFamily(out, "lorascope_channel_rssi_dbm", "summary", "RSSI of received frames.",
+        [](std::string& o, const char* device, uint16_t channel, const ChannelStats& s) {
+            appendf(o, "lorascope_channel_rssi_dbm_sum{device=\"%s\",channel=\"%u\"} %" PRId64 "\n", device, channel, s.rssiSum);
+            appendf(o, "lorascope_channel_rssi_dbm_count{device=\"%s\",channel=\"%u\"} %" PRIu64 "\n", device, channel, s.rssiCount);
+        });
+    
+    appendChannelFamily(out, "lorascope_channel_rssi_max_dbm", "gauge", "Strongest RSSI seen on the channel.",
+        [](std::string& o, const char* device, uint16_t channel, const ChannelStats& s) {
+            if (s.rssiCount == 0) return;
+            appendf(o, "lorascope_channel_rssi_max_dbm{device=\"%s\",channel=\"%u\"} %d\n", device, channel, s.rssiMax);
+        });
+    
+    appendChannelFamily(out, "lorascope_channel_last_seen_seconds", "gauge", "Device uptime of the latest event on the channel.",
+        [](std::string& o, const char* device, uint16_t channel, const ChannelStats& s) {
+            appendf(o, "lorascope_channel_last_seen_seconds{device=\"%s\",channel=\"%u\"} %.6f\n", device, channel, s.lastSeenUs / 1e6);
+        });
+    
+    // 设备端指标各自成族：计数器带 _total 后缀，仪表保持原名
+    for (size_t i = 0; i < DEVICE_METRIC_COUNT; i++) {
+        const DeviceMetricInfo& info = DEVICE_METRICS[i];
+        char name[96];
+        snprintf(name, sizeof(name), "lorascope_device_%s%s", info.name, info.gauge ? "" : "_total");
+        appendHeader(out, name, info.gauge ? "gauge" : "counter", info.help);
+        for (dev = devices.begin(); dev != devices.end(); ++dev) {
+            const std::vector<uint32_t>& values = dev->second.metrics;
+            if (i >= values.size()) continue;
+            appendf(out, "%s{device=\"%s\"} %u\n", name, dev->first.c_str(), values[i]);
+        }
+    }
+    
+    appendDeviceFamily(out, "lorascope_stream_records_total", "counter", "Binary records decoded from the device stream.",
+                       &StreamStats::records);
+    appendDeviceFamily(out, "lorascope_stream_checksum_errors_total", "counter", "Candidate records rejected by checksum.",
+                       &StreamStats::checksumErrors);
+    appendDeviceFamily(out, "lorascope_stream_skipped_bytes_total", "counter", "Non-record bytes skipped while resynchronising.",
+                       &StreamStats::skippedBytes);
+    appendDeviceFamily(out, "lorascope_store_rows", "gauge", "Rows in the on-disk column store.",
+                       &StreamStats::storedRows);
+    
+    return out;
+}
+
+void Aggregator::appendDeviceFamily(std::string& out, const char* name, const char* type, const char* help,
+                                    uint64_t StreamStats::*field) const {
+    appendHeader(out, name, type, help);
+    std::map<std::string, DeviceStats>::const_iterator dev;
+    for (dev = devices.begin(); dev != devices.end(); ++dev) {
+        appendf(out, "%s{device=\"%s\"} %" PRIu64 "\n", name, dev->first.c_str(), dev->second.stream.*field);
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include "record_decoder.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 按 (设备, 信道) 聚合的计数，供 /metrics 导出；各输入线程写入，HTTP 线程读取
+class Aggregator {
+public:
+    struct StreamStats {
+        uint64_t records;
+        uint64_t checksumErrors;
+        uint64_t skippedBytes;
+        uint64_t storedRows;
+    };
+    
+    void addEvent(const std::string& device, const Event& event);
+    void setDeviceMetrics(const std::string& device, const std::vector<uint32_t>& values);
+    void setStreamStats(const std::string& device, const StreamStats& stats);
+    
+    // Prometheus 文本格式 (version 0.0.4)
+    std::string renderPrometheus() const;
+    
+private:
+    static const int TYPE_COUNT = 3;
+    static const int PROTOCOL_COUNT = 5;
+    
+    struct ChannelStats {
+        uint32_t frequency;
+        uint64_t events[TYPE_COUNT];
+        uint64_t protocols[PROTOCOL_COUNT];
+        uint64_t duplicates;
+        int64_t rssiSum;
+        uint64_t rssiCount;
+        int rssiMax;
+        uint64_t lastSeenUs;
+    };
+    
+    struct DeviceStats {
+        std::map<uint16_t, ChannelStats> channels;
+        std::vector<uint32_t> metrics;
+        StreamStats stream;
+        
+        DeviceStats() {
+            stream.records = 0;
+            stream.checksumErrors = 0;
+            stream.skippedBytes = 0;
+            stream.storedRows = 0;
+        }
+    };
+    
+    // 输出一个指标族：HELP/TYPE 之后紧跟全部设备/信道的样本
+    template <typename Fn>
+    void appendChannelFamily(std::string& out, const char* name, const char* type,
+                             const char* help, Fn sample) const;
+    void appendDeviceFamily(std::string& out, const char* name, const char* type, const char* help,
+                            uint64_t StreamStats::*field) const;
+    
+    mutable std::mutex mutex;
+    std::map<std::string, DeviceStats> devices;
+};
+
+#endif // AGGREGATOR_H
@@ -0,0 +1,347 @@
+#include "column_store.h"
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* const COLUMN_NAMES[] = {
+    "time.u64", "channel.u16", "rssi.i8", "length.u8", "type.u8", "protocol.u8", "received.u64"
+};
+static const size_t COLUMN_WIDTHS[] = { 8, 2, 1, 1, 1, 1, 8 };
+
+bool makeDirectories(const std::string& path) {
+    std::string current;
+    size_t pos = 0;
+    
+    while (pos <= path.size()) {
+        size_t next = path.find('/', pos);
+        if (next == std::string::npos) next = path.size();
+        current = path.substr(0, next);
+        
+        if (!current.empty() && mkdir(current.c_str(), 0755) != 0 && errno != EEXIST) {
+            fprintf(stderr, "[Store] mkdir %s: %s\n", current.c_str(), strerror(errno));
+            return false;
+        }
+        pos = next + 1;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+ColumnStore::ColumnStore() : rows(0), bufferedRows(0) {
+    for (int i = 0; i < COL_COUNT; i++) {
+        columns[i].name = COLUMN_NAMES[i];
+        columns[i].width = COLUMN_WIDTHS[i];
+        columns[i].fd = -1;
+    }
+}
+
+ColumnStore::~ColumnStore() {
+    close();
+}
+
+bool ColumnStore::open(const std::string& dir, bool readOnly) {
+    if (!readOnly && !makeDirectories(dir)) return false;
+    
+    uint64_t minRows = UINT64_MAX;
+    bool created[COL_COUNT];
+    for (int i = 0; i < COL_COUNT; i++) {
+        std::string path = dir + "/" + columns[i].name;
+        created[i] = access(path.c_str(), F_OK) != 0;
+        if (readOnly && created[i]) {
+            fprintf(stderr, "[Store] %s: missing\n", path.c_str());
+            close();
+            return false;
+        }
+        columns[i].fd = ::open(path.c_str(), readOnly ? O_RDONLY : O_RDWR | O_CREAT, 0644);
+        if (columns[i].fd < 0) {
+            fprintf(stderr, "[Store] open %s: %s\n", path.c_str(), strerror(errno));
+            close();
+            return false;
+        }
+        columns[i].buffer.reserve(FLUSH_ROWS * columns[i].width);
+        if (created[i]) continue;
+        
+        struct stat st;
+        fstat(columns[i].fd, &st);
+        uint64_t columnRows = (uint64_t)st.st_size / columns[i].width;
+        if (columnRows < minRows) minRows = columnRows;
+    }
+    if (minRows == UINT64_MAX) minRows = 0;
+    
+    // 只读打开时不修复，按最短列的行数读取，写入端可能正在追加
+    for (int i = 0; i < COL_COUNT && !readOnly; i++) {
+        off_t size = (off_t)(minRows * columns[i].width);
+        // 新建的列用 0 填充（ftruncate 扩展的部分读出为 0）
+        if (created[i] && minRows > 0) {
+            fprintf(stderr, "[Store] %s: new column, %llu existing rows marked unknown\n",
+                    columns[i].name, (unsigned long long)minRows);
+        }
+        if (ftruncate(columns[i].fd, size) != 0 || lseek(columns[i].fd, size, SEEK_SET) < 0) {
+            fprintf(stderr, "[Store] truncate %s: %s\n", columns[i].name, strerror(errno));
+            close();
+            return false;
+        }
+    }
+    
+    rows = minRows;
+    bufferedRows = 0;
+    if (!loadIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool ColumnStore::loadIndex() {
+    index.clear();
+    
+    std::vector<uint8_t> channels;
+    std::vector<uint8_t> received;
+    for (uint64_t first = 0; first < rows; first += FLUSH_ROWS) {
+        uint64_t count = std::min<uint64_t>(FLUSH_ROWS, rows - first);
+        if (!readColumn(COL_CHANNEL, first, count, &channels) ||
+            !readColumn(COL_RECEIVED, first, count, &received)) {
+            fprintf(stderr, "[Store] index: read failed at row %llu\n", (unsigned long long)first);
+            return false;
+        }
+        for (uint64_t i = 0; i < count; i++) {
+            uint16_t channel = channels[i * 2] | (channels[i * 2 + 1] << 8);
+            uint64_t receivedUs = 0;
+            for (int b = 0; b < 8; b++) receivedUs |= (uint64_t)received[i * 8 + b] << (8 * b);
+            index.add(first + i, channel, receivedUs);
+        }
+    }
+    return true;
+}
+
+void ColumnStore::close() {
+    flush();
+    for (int i = 0; i < COL_COUNT; i++) {
+        if (columns[i].fd >= 0) {
+            ::close(columns[i].fd);
+            columns[i].fd = -1;
+        }
+    }
+}
+
+void ColumnStore::put(Column column, uint64_t value) {
+    std::vector<uint8_t>& buffer = columns[column].buffer;
+    for (size_t b = 0; b < columns[column].width; b++) {
+        buffer.push_back((uint8_t)(value >> (8 * b)));
+    }
+}
+
+void ColumnStore::append(const Event& event, uint64_t receivedUs) {
+    if (receivedUs < index.getLastReceived()) {
+        receivedUs = index.getLastReceived();
+    }
+    index.add(rows, event.channel, receivedUs);
+    
+    put(COL_TIME, event.timestampUs);
+    put(COL_CHANNEL, event.channel);
+    put(COL_RSSI, (uint8_t)event.rssi);
+    put(COL_LENGTH, event.length);
+    put(COL_TYPE, event.type);
+    put(COL_PROTOCOL, event.protocol);
+    put(COL_RECEIVED, receivedUs);
+    rows++;
+    bufferedRows++;
+    
+    if (bufferedRows >= FLUSH_ROWS) {
+        flush();
+    }
+}
+
+bool ColumnStore::flush() {
+    if (bufferedRows == 0) return true;
+    
+    bool ok = true;
+    for (int i = 0; i < COL_COUNT; i++) {
+        if (columns[i].fd < 0) continue;
+        if (!writeAll(columns[i].fd, columns[i].buffer.data(), columns[i].buffer.size())) {
+            fprintf(stderr, "[Store] write %s: %s\n", columns[i].name, strerror(errno));
+            ok = false;
+        }
+        columns[i].buffer.clear();
+    }
+    bufferedRows = 0;
+    return ok;
+}
+
+bool ColumnStore::readColumn(Column column, uint64_t first, uint64_t count, std::vector<uint8_t>* out) const {
+    const ColumnFile& file = columns[column];
+    out->resize(count * file.width);
+    
+    uint8_t* data = out->data();
+    size_t length = out->size();
+    off_t offset = (off_t)(first * file.width);
+    while (length > 0) {
+        ssize_t n = pread(file.fd, data, length, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        length -= n;
+        offset += n;
+    }
+    return true;
+}
+
+bool ColumnStore::readRows(uint64_t first, uint64_t count, std::vector<StoredEvent>* out) const {
+    std::vector<uint8_t> raw[COL_COUNT];
+    for (int i = 0; i < COL_COUNT; i++) {
+        if (!readColumn((Column)i, first, count, &raw[i])) return false;
+    }
+    
+    out->resize(count);
+    for (uint64_t r = 0; r < count; r++) {
+        uint64_t values[COL_COUNT];
+        for (int i = 0; i < COL_COUNT; i++) {
+            size_t width = columns[i].width;
+            values[i] = 0;
+            for (size_t b = 0; b < width; b++) values[i] |= (uint64_t)raw[i][r * width + b] << (8 * b);
+        }
+        
+        StoredEvent& event = (*out)[r];
+        event.row = first + r;
+        event.timestampUs = values[COL_TIME];
+        event.receivedUs = values[COL_RECEIVED];
+        event.channel = (uint16_t)values[COL_CHANNEL];
+        event.rssi = (int8_t)values[COL_RSSI];
+        event.length = (uint8_t)values[COL_LENGTH];
+        event.type = (uint8_t)values[COL_TYPE];
+        event.protocol = (uint8_t)values[COL_PROTOCOL];
+    }
+    return true;
+}
+
+uint64_t ColumnStore::lowerBound(uint64_t timeUs) const {
+    if (rows == 0) return 0;
+    
+    uint64_t first = index.candidateBlock(timeUs) * StoreIndex::BLOCK_ROWS;
+    uint64_t count = std::min<uint64_t>(StoreIndex::BLOCK_ROWS, rows - first);
+    std::vector<uint8_t> received;
+    if (!readColumn(COL_RECEIVED, first, count, &received)) return rows;
+    
+    // 块内二分；块内都早于 timeUs 时结果是下一块的首行
+    uint64_t low = 0;
+    uint64_t high = count;
+    while (low < high) {
+        uint64_t middle = (low + high) / 2;
+        uint64_t value = 0;
+        for (int b = 0; b < 8; b++) value |= (uint64_t)received[middle * 8 + b] << (8 * b);
+        if (value < timeUs) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return first + low;
+}
+
+StoreCursor ColumnStore::query(const StoreQuery& query) {
+    StoreCursor cursor;
+    cursor.store = this;
+    cursor.query = query;
+    
+    flush();
+    if (rows == 0 || query.firstChannel > query.lastChannel || query.startUs >= query.endUs) {
+        return cursor;
+    }
+    
+    // 主索引：接收时间范围 → 行号区间 [lo, hi)
+    cursor.lo = query.startUs > 0 ? lowerBound(query.startUs) : 0;
+    cursor.hi = query.endUs == UINT64_MAX ? rows : lowerBound(query.endUs);
+    if (cursor.lo >= cursor.hi) return cursor;
+    
+    // 倒排表：各频点落在行号区间内的部分，随机读取的代价低于顺序扫描区间时使用
+    uint64_t postings = 0;
+    uint32_t lastChannel = std::min<uint32_t>(query.lastChannel, (uint32_t)index.getChannelCount() - 1);
+    std::vector<StoreCursor::Lane> lanes;
+    for (uint32_t channel = query.firstChannel; index.getChannelCount() > 0 && channel <= lastChannel; channel++) {
+        const std::vector<uint64_t>* list = index.postings((uint16_t)channel);
+        if (!list) continue;
+        
+        StoreCursor::Lane lane;
+        lane.rows = list;
+        lane.position = std::lower_bound(list->begin(), list->end(), cursor.lo) - list->begin();
+        lane.end = std::lower_bound(list->begin(), list->end(), cursor.hi) - list->begin();
+        if (lane.position == lane.end) continue;
+        postings += lane.end - lane.position;
+        lanes.push_back(lane);
+    }
+    
+    if (postings * POSTING_ROW_COST < cursor.hi - cursor.lo) {
+        cursor.scan = false;
+        cursor.lanes.swap(lanes);
+    }
+    return cursor;
+}
+
+StoreCursor::StoreCursor()
+    : store(nullptr), scan(true), lo(0), hi(0), chunkPosition(0), rowsRead(0) {
+}
+
+uint64_t StoreCursor::nextCandidate() {
+    if (scan) {
+        return lo < hi ? lo++ : UINT64_MAX;
+    }
+    
+    // 行号与接收时间同序，各频点倒排表按行号归并即为时间顺序
+    size_t best = lanes.size();
+    for (size_t i = 0; i < lanes.size(); i++) {
+        if (lanes[i].position == lanes[i].end) continue;
+        if (best == lanes.size() || (*lanes[i].rows)[lanes[i].position] < (*lanes[best].rows)[lanes[best].position]) {
+            best = i;
+        }
+    }
+    if (best == lanes.size()) return UINT64_MAX;
+    return (*lanes[best].rows)[lanes[best].position++];
+}
+
+bool StoreCursor::next(StoredEvent* event) {
+    if (!store) return false;
+    
+    while (true) {
+        if (chunkPosition == chunk.size()) {
+            uint64_t row = nextCandidate();
+            if (row == UINT64_MAX) return false;
+            
+            // 扫描时连同后续行一次读入；nextCandidate() 已取走首行，其余行从 lo 中扣除
+            uint64_t count = 1;
+            if (scan) {
+                count = std::min<uint64_t>(SCAN_CHUNK_ROWS, hi - row);
+                lo = row + count;
+            }
+            if (!store->readRows(row, count, &chunk)) {
+                chunk.clear();
+                chunkPosition = 0;
+                return false;
+            }
+            chunkPosition = 0;
+            rowsRead += count;
+        }
+        
+        const StoredEvent& candidate = chunk[chunkPosition++];
+        if (candidate.channel >= query.firstChannel && candidate.channel <= query.lastChannel &&
+            candidate.rssi >= query.minRssi) {
+            *event = candidate;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef COLUMN_STORE_H
+#define COLUMN_STORE_H
+
+#include "record_decoder.h"
+#include "store_index.h"
+#include <string>
+#include <vector>
+
+class ColumnStore;
+
+// 从列文件读出的一行
+struct StoredEvent {
+    uint64_t row;
+    uint64_t timestampUs;
+    uint64_t receivedUs;
+    uint16_t channel;
+    int8_t rssi;
+    uint8_t length;
+    uint8_t type;
+    uint8_t protocol;
+};
+
+// 查询游标：按行号（即接收时间）顺序逐条取出匹配的行，只从磁盘读取候选行；
+// 存储继续追加不影响已有游标，存储关闭或重新打开后游标失效
+class StoreCursor {
+public:
+    StoreCursor();
+    
+    // 取下一条匹配的行，没有时返回 false
+    bool next(StoredEvent* event);
+    // 已从磁盘读出的行数（含不满足 RSSI 条件的候选行）
+    uint64_t getRowsRead() const { return rowsRead; }
+    bool usesPostings() const { return !scan; }
+    
+private:
+    friend class ColumnStore;
+    
+    struct Lane {
+        const std::vector<uint64_t>* rows;
+        size_t position;
+        size_t end;
+    };
+    
+    // 扫描时一次读入的行数；归并倒排表时逐行读取
+    static const uint64_t SCAN_CHUNK_ROWS = 1024;
+    
+    uint64_t nextCandidate();
+    
+    ColumnStore* store;
+    StoreQuery query;
+    bool scan;                  // true：按行号扫描 [lo, hi)；false：归并各频点倒排表
+    uint64_t lo;
+    uint64_t hi;
+    std::vector<Lane> lanes;
+    std::vector<StoredEvent> chunk;
+    size_t chunkPosition;
+    uint64_t rowsRead;
+};
+
+// 列式存储：每列一个只追加的定宽小端文件，第 i 行位于各文件偏移 i * 宽度处
+//   time.u64  channel.u16  rssi.i8  length.u8  type.u8  protocol.u8  received.u64
+// time 是设备运行时间，设备每次重启都从 0 开始；received 是主机收到记录时的
+// 墙钟时间（Unix 微秒），用于跨重启排序和对齐
+class ColumnStore {
+public:
+    ColumnStore();
+    ~ColumnStore();
+    
+    // 打开（必要时创建）目录；各列行数不一致时截断到最短列，修复上次未写完的行。
+    // 旧版本存储缺少的列按 0（未知）补齐到已有行数。readOnly 时只读取，用于导出
+    bool open(const std::string& dir, bool readOnly = false);
+    void close();
+    
+    // 墙钟回拨（如校时）时沿用上一行的接收时间，保持 received 单调，主索引依赖这一点
+    void append(const Event& event, uint64_t receivedUs);
+    bool flush();
+    
+    // 按频点、接收时间和 RSSI 查询：先落盘缓冲的行，由主索引把时间范围换成行号区间，
+    // 频点范围内的倒排表按随机读取计的代价低于扫描该区间时改为归并倒排表
+    StoreCursor query(const StoreQuery& query);
+    const StoreIndex& getIndex() const { return index; }
+    
+    uint64_t getRowCount() const { return rows; }
+    size_t getBufferedRows() const { return bufferedRows; }
+    
+private:
+    friend class StoreCursor;
+    
+    enum Column {
+        COL_TIME,
+        COL_CHANNEL,
+        COL_RSSI,
+        COL_LENGTH,
+        COL_TYPE,
+        COL_PROTOCOL,
+        COL_RECEIVED,
+        COL_COUNT
+    };
+    
+    struct ColumnFile {
+        const char* name;
+        size_t width;
+        int fd;
+        std::vector<uint8_t> buffer;
+    };
+    
+    // 缓冲到该行数时自动落盘
+    static const size_t FLUSH_ROWS = 4096;
+    // 倒排表逐行随机读取，每行的代价按顺序扫描一行的若干倍计
+    static const uint64_t POSTING_ROW_COST = 8;
+    
+    void put(Column column, uint64_t value);
+    bool readColumn(Column column, uint64_t first, uint64_t count, std::vector<uint8_t>* out) const;
+    // 读出 [first, first + count) 行（必须已落盘）
+    bool readRows(uint64_t first, uint64_t count, std::vector<StoredEvent>* out) const;
+    bool loadIndex();
+    // 第一条 received >= timeUs 的行号，没有时为行数
+    uint64_t lowerBound(uint64_t timeUs) const;
+    
+    ColumnFile columns[COL_COUNT];
+    StoreIndex index;
+    uint64_t rows;
+    size_t bufferedRows;
+};
+
+// 逐级创建目录，等同 mkdir -p
+bool makeDirectories(const std::string& path);
+
+#endif // COLUMN_STORE_H
@@ -0,0 +1,107 @@
+#include "http_server.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void sendAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        length -= n;
+    }
+}
+
+static void sendResponse(int fd, const char* status, const char* contentType, const std::string& body) {
+    char header[256];
+    int n = snprintf(header, sizeof(header),
+                     "HTTP/1.0 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                     status, contentType, body.size());
+    sendAll(fd, header, n);
+    sendAll(fd, body.data(), body.size());
+}
+
+HttpServer::HttpServer(const Aggregator* aggregator) : aggregator(aggregator), listenFd(-1) {
+}
+
+HttpServer::~HttpServer() {
+    if (listenFd >= 0) close(listenFd);
+}
+
+bool HttpServer::start(const std::string& address, uint16_t port) {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        fprintf(stderr, "[HTTP] socket: %s\n", strerror(errno));
+        return false;
+    }
+    
+    int on = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        fprintf(stderr, "[HTTP] invalid address %s\n", address.c_str());
+        return false;
+    }
+    
+    if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 8) != 0) {
+        fprintf(stderr, "[HTTP] bind %s:%u: %s\n", address.c_str(), port, strerror(errno));
+        return false;
+    }
+    
+    fprintf(stderr, "[HTTP] serving http://%s:%u/metrics\n", address.c_str(), port);
+    return true;
+}
+
+void HttpServer::run(const std::atomic<bool>& stop) {
+    while (!stop.load()) {
+        struct pollfd pfd;
+        pfd.fd = listenFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        
+        int client = accept(listenFd, NULL, NULL);
+        if (client < 0) continue;
+        handleClient(client);
+        close(client);
+    }
+}
+
+void HttpServer::handleClient(int client) {
+    // 抓取端一次只发一个小请求，读到头部结束即可
+    struct timeval timeout = { 2, 0 };
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    std::string request;
+    char buffer[512];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        ssize_t n = recv(client, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        request.append(buffer, n);
+    }
+    
+    if (request.compare(0, 4, "GET ") != 0) {
+        sendResponse(client, "405 Method Not Allowed", "text/plain", "method not allowed\n");
+        return;
+    }
+    
+    size_t end = request.find(' ', 4);
+    std::string target = request.substr(4, end == std::string::npos ? std::string::npos : end - 4);
+    if (target == "/metrics" || target.compare(0, 9, "/metrics?") == 0) {
+        sendResponse(client, "200 OK", "text/plain; version=0.0.4", aggregator->renderPrometheus());
+    } else {
+        sendResponse(client, "404 Not Found", "text/plain", "try /metrics\n");
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include "aggregator.h"
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+// 最小的 HTTP/1.0 服务：只在本机回环地址上提供 GET /metrics
+class HttpServer {
+public:
+    explicit HttpServer(const Aggregator* aggregator);
+    ~HttpServer();
+    
+    bool start(const std::string& address, uint16_t port);
+    // 阻塞处理请求直到 stop 置位
+    void run(const std::atomic<bool>& stop);
+    
+private:
+    // 请求头上限，超出直接断开
+    static const size_t MAX_REQUEST_BYTES = 4096;
+    
+    void handleClient(int client);
+    
+    const Aggregator* aggregator;
+    int listenFd;
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,169 @@
+#include "aggregator.h"
+#include "column_store.h"
+#include "http_server.h"
+#include "stream_input.h"
+#include <atomic>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic<bool> stopRequested(false);
+
+static void onSignal(int) {
+    stopRequested.store(true);
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options] [NAME=]PATH...\n"
+            "       %s [--store DIR] --export NAME [query options]\n"
+            "  PATH           serial port, pty or recorded stream file\n"
+            "  NAME           device label (default: basename of PATH)\n"
+            "  --store DIR    column store root (default: ./lorascope-data)\n"
+            "  --port N       metrics port on 127.0.0.1 (default: 9464)\n"
+            "  --baud N       serial baud rate (default: 115200)\n"
+            "  --follow       keep reading files after EOF\n"
+            "  --exit         exit once all file inputs are replayed\n"
+            "Query options (CSV on stdout, store opened read-only):\n"
+            "  --channels A:B channel index range (default: all)\n"
+            "  --since US     received time lower bound, Unix microseconds\n"
+            "  --until US     received time upper bound (exclusive)\n"
+            "  --min-rssi N   RSSI floor in dBm\n",
+            program, program);
+}
+
+// 按接收时间顺序导出匹配的行
+static int exportEvents(const std::string& dir, const StoreQuery& query) {
+    ColumnStore store;
+    if (!store.open(dir, true)) return 1;
+    
+    StoreCursor cursor = store.query(query);
+    StoredEvent event;
+    uint64_t count = 0;
+    printf("received_us,time_us,channel,rssi,length,type,protocol\n");
+    while (cursor.next(&event)) {
+        printf("%llu,%llu,%u,%d,%u,%s,%s\n", (unsigned long long)event.receivedUs,
+               (unsigned long long)event.timestampUs, event.channel, event.rssi, event.length,
+               eventTypeName(event.type), protocolName(event.protocol));
+        count++;
+    }
+    fprintf(stderr, "[Export] %llu of %llu rows (%llu read, %s)\n", (unsigned long long)count,
+            (unsigned long long)store.getRowCount(), (unsigned long long)cursor.getRowsRead(),
+            cursor.usesPostings() ? "channel postings" : "time range scan");
+    return 0;
+}
+
+static std::string deviceNameFor(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+int main(int argc, char** argv) {
+    std::string storeRoot = "lorascope-data";
+    uint16_t port = 9464;
+    uint32_t baud = 115200;
+    bool follow = false;
+    bool exitWhenDone = false;
+    std::string exportDevice;
+    StoreQuery query;
+    std::vector<std::pair<std::string, std::string> > inputs;
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        
+        if (arg == "--store" && hasValue) {
+            storeRoot = argv[++i];
+        } else if (arg == "--port" && hasValue) {
+            port = (uint16_t)atoi(argv[++i]);
+        } else if (arg == "--baud" && hasValue) {
+            baud = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (arg == "--follow") {
+            follow = true;
+        } else if (arg == "--exit") {
+            exitWhenDone = true;
+        } else if (arg == "--export" && hasValue) {
+            exportDevice = argv[++i];
+        } else if (arg == "--channels" && hasValue) {
+            unsigned first = 0;
+            unsigned last = 0;
+            if (sscanf(argv[++i], "%u:%u", &first, &last) != 2 || first > last || last > UINT16_MAX) {
+                printUsage(argv[0]);
+                return 2;
+            }
+            query.firstChannel = (uint16_t)first;
+            query.lastChannel = (uint16_t)last;
+        } else if (arg == "--since" && hasValue) {
+            query.startUs = strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--until" && hasValue) {
+            query.endUs = strtoull(argv[++i], NULL, 10);
+        } else if (arg == "--min-rssi" && hasValue) {
+            query.minRssi = (int16_t)atoi(argv[++i]);
+        } else if (arg == "-h" || arg == "--help" || arg.compare(0, 2, "--") == 0) {
+            printUsage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        } else {
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos) {
+                inputs.push_back(std::make_pair(deviceNameFor(arg), arg));
+            } else {
+                inputs.push_back(std::make_pair(arg.substr(0, eq), arg.substr(eq + 1)));
+            }
+        }
+    }
+    
+    if (!exportDevice.empty()) {
+        return exportEvents(storeRoot + "/" + exportDevice, query);
+    }
+    if (inputs.empty()) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    
+    Aggregator aggregator;
+    std::vector<StreamInput*> streams;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        StreamInput* stream = new StreamInput(inputs[i].first, inputs[i].second, baud, follow, &aggregator);
+        if (!stream->open(storeRoot)) {
+            delete stream;
+            for (size_t j = 0; j < streams.size(); j++) delete streams[j];
+            return 1;
+        }
+        streams.push_back(stream);
+    }
+    
+    HttpServer server(&aggregator);
+    if (!server.start("127.0.0.1", port)) {
+        for (size_t j = 0; j < streams.size(); j++) delete streams[j];
+        return 1;
+    }
+    
+    // 每个设备一个读取线程；回放结束的输入线程退出，HTTP 服务继续提供最终统计
+    std::atomic<int> running((int)streams.size());
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < streams.size(); i++) {
+        StreamInput* stream = streams[i];
+        readers.push_back(std::thread([stream, &running, exitWhenDone]() {
+            stream->run(stopRequested);
+            if (--running == 0 && exitWhenDone) stopRequested.store(true);
+        }));
+    }
+    
+    server.run(stopRequested);
+    
+    for (size_t i = 0; i < readers.size(); i++) {
+        readers[i].join();
+        delete streams[i];
+    }
+    return 0;
+}
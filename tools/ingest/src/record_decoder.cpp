@@ -0,0 +1,137 @@
+#include "record_decoder.h"
+
+const DeviceMetricInfo DEVICE_METRICS[] = {
+    { "uart_overruns", false, "Radio UART receive overruns on the device." },
+    { "frames_received", false, "Frames parsed by the device radio driver." },
+    { "parse_errors", false, "Radio frames the device failed to parse." },
+    { "rssi_rejected", false, "Frames dropped by the device for out-of-range RSSI." },
+    { "deferred_frames", false, "Frames still pending when a dwell window ended early." },
+    { "point_evictions", false, "Points evicted from the device radar ring." },
+    { "set_freq_failures", false, "Failed frequency or parameter changes on the device." },
+    { "ring_points", true, "Points currently held in the device radar ring." },
+    { "free_heap", true, "Free heap on the device in bytes." },
+    { "frame_ring_full", false, "Frames dropped because the device frame ring was full." },
+};
+const size_t DEVICE_METRIC_COUNT = sizeof(DEVICE_METRICS) / sizeof(DEVICE_METRICS[0]);
+
+static uint64_t getLe(const uint8_t*& p, uint8_t bytes) {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < bytes; i++) {
+        v |= (uint64_t)(*p++) << (8 * i);
+    }
+    return v;
+}
+
+bool decodeEvent(const uint8_t* in, size_t len, Event* event) {
+    if (len < EVENT_RECORD_SIZE) return false;
+    
+    const uint8_t* p = in;
+    event->timestampUs = getLe(p, 6);
+    event->frequency = (uint32_t)getLe(p, 4);
+    event->channel = (uint16_t)getLe(p, 2);
+    event->rssi = (int8_t)*p++;
+    event->snr = (int8_t)*p++;
+    event->length = *p++;
+    event->type = *p++;
+    event->protocol = *p++;
+    event->duplicate = (*p++ & EVENT_FLAG_DUPLICATE) != 0;
+    event->dataRate = *p++;
+    event->fingerprint = (uint32_t)getLe(p, 4);
+    event->sequence = (uint32_t)getLe(p, 4);
+    return true;
+}
+
+const char* eventTypeName(uint8_t type) {
+    switch (type) {
+        case EVENT_RX_DONE: return "rx_done";
+        case EVENT_RX_TIMEOUT: return "rx_timeout";
+        case EVENT_RX_CRC_ERROR: return "rx_error";
+        default: return "unknown";
+    }
+}
+
+const char* protocolName(uint8_t protocol) {
+    switch (protocol) {
+        case 0: return "pending";
+        case 1: return "unknown";
+        case 2: return "lorawan";
+        case 3: return "meshtastic";
+        case 4: return "lora_aprs";
+        default: return "other";
+    }
+}
+
+RecordDecoder::RecordDecoder(Handler* handler)
+    : handler(handler), records(0), checksumErrors(0), skippedBytes(0) {
+    pending.reserve(4096);
+}
+
+void RecordDecoder::feed(const uint8_t* data, size_t length) {
+    pending.insert(pending.end(), data, data + length);
+    process();
+}
+
+void RecordDecoder::process() {
+    size_t pos = 0;
+    
+    while (pos < pending.size()) {
+        if (pending[pos] != STREAM_SYNC) {
+            pos++;
+            skippedBytes++;
+            continue;
+        }
+        
+        // 头部未到齐，等待更多数据
+        if (pending.size() - pos < 3) break;
+        
+        uint8_t type = pending[pos + 1];
+        uint8_t length = pending[pos + 2];
+        size_t total = 3 + (size_t)length + 1;
+        if (pending.size() - pos < total) break;
+        
+        const uint8_t* payload = &pending[pos + 3];
+        uint8_t checksum = type + length;
+        for (uint8_t i = 0; i < length; i++) {
+            checksum += payload[i];
+        }
+        
+        // 校验失败说明同步字节出现在文本或噪声中，跳过一个字节继续寻找
+        if (checksum != pending[pos + 3 + length]) {
+            checksumErrors++;
+            pos++;
+            skippedBytes++;
+            continue;
+        }
+        
+        dispatch(type, payload, length);
+        records++;
+        pos += total;
+    }
+    
+    pending.erase(pending.begin(), pending.begin() + pos);
+    
+    // 防止一直找不到完整记录时缓冲区无限增长
+    if (pending.size() > MAX_RECORD_BYTES * 4) {
+        skippedBytes += pending.size();
+        pending.clear();
+    }
+}
+
+void RecordDecoder::dispatch(uint8_t type, const uint8_t* payload, uint8_t length) {
+    if (type == STREAM_RECORD_EVENT) {
+        Event event;
+        if (decodeEvent(payload, length, &event)) {
+            handler->onEvent(event);
+        }
+    } else if (type == STREAM_RECORD_METRICS && length >= 1) {
+        uint8_t count = payload[0];
+        if (length < 1 + (size_t)count * 4) return;
+        
+        std::vector<uint32_t> values(count);
+        const uint8_t* p = payload + 1;
+        for (uint8_t i = 0; i < count; i++) {
+            values[i] = (uint32_t)getLe(p, 4);
+        }
+        handler->onMetrics(values);
+    }
+}
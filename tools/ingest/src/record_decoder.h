@@ -0,0 +1,83 @@
+#ifndef RECORD_DECODER_H
+#define RECORD_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// 与设备端 stream.h / event_codec.h / metrics.h 的格式保持一致
+const uint8_t STREAM_SYNC = 0xA5;
+const uint8_t STREAM_RECORD_EVENT = 1;
+const uint8_t STREAM_RECORD_METRICS = 2;
+const size_t EVENT_RECORD_SIZE = 27;
+const uint8_t EVENT_FLAG_DUPLICATE = 0x01;
+
+// 设备端事件类型 (EventType)
+enum EventType {
+    EVENT_RX_DONE = 0,
+    EVENT_RX_CRC_ERROR = 1,
+    EVENT_RX_TIMEOUT = 2
+};
+
+struct Event {
+    uint64_t timestampUs;
+    uint32_t frequency;
+    uint16_t channel;
+    int8_t rssi;
+    int8_t snr;
+    uint8_t length;
+    uint8_t type;
+    uint8_t protocol;
+    bool duplicate;
+    uint8_t dataRate;
+    uint32_t fingerprint;
+    uint32_t sequence;
+};
+
+// 设备端 MetricId 的顺序，指标记录只携带数值
+struct DeviceMetricInfo {
+    const char* name;
+    bool gauge;         // 否则为计数器（设备重启后从 0 重新计数）
+    const char* help;
+};
+extern const DeviceMetricInfo DEVICE_METRICS[];
+extern const size_t DEVICE_METRIC_COUNT;
+
+bool decodeEvent(const uint8_t* in, size_t len, Event* event);
+const char* eventTypeName(uint8_t type);
+// 设备端 ProtocolId
+const char* protocolName(uint8_t protocol);
+
+// 流式分帧：文本日志与二进制记录共用串口，按同步字节和校验和重新同步
+class RecordDecoder {
+public:
+    struct Handler {
+        virtual ~Handler() {}
+        virtual void onEvent(const Event& event) = 0;
+        virtual void onMetrics(const std::vector<uint32_t>& values) = 0;
+    };
+    
+    explicit RecordDecoder(Handler* handler);
+    
+    void feed(const uint8_t* data, size_t length);
+    
+    uint64_t getRecordCount() const { return records; }
+    uint64_t getChecksumErrors() const { return checksumErrors; }
+    uint64_t getSkippedBytes() const { return skippedBytes; }
+    
+private:
+    // 同步字节 + 类型 + 长度 + 最长 255 字节负载 + 校验和
+    static const size_t MAX_RECORD_BYTES = 3 + 255 + 1;
+    
+    void process();
+    void dispatch(uint8_t type, const uint8_t* payload, uint8_t length);
+    
+    Handler* handler;
+    std::vector<uint8_t> pending;
+    uint64_t records;
+    uint64_t checksumErrors;
+    uint64_t skippedBytes;
+};
+
+#endif // RECORD_DECODER_H
@@ -0,0 +1,43 @@
+#include "store_index.h"
+#include <algorithm>
+
+StoreIndex::StoreIndex() : rows(0), lastReceived(0) {
+}
+
+void StoreIndex::clear() {
+    blockFirst.clear();
+    channelRows.clear();
+    rows = 0;
+    lastReceived = 0;
+}
+
+void StoreIndex::add(uint64_t row, uint16_t channel, uint64_t receivedUs) {
+    if (row % BLOCK_ROWS == 0) {
+        blockFirst.push_back(receivedUs);
+    }
+    if (channel >= channelRows.size()) {
+        channelRows.resize((size_t)channel + 1);
+    }
+    channelRows[channel].push_back(row);
+    rows = row + 1;
+    lastReceived = receivedUs;
+}
+
+uint64_t StoreIndex::candidateBlock(uint64_t timeUs) const {
+    // 块首时间不小于 timeUs 的第一块之前的那一块；所有块首都不小于时就是第 0 块
+    size_t block = std::lower_bound(blockFirst.begin(), blockFirst.end(), timeUs) - blockFirst.begin();
+    return block > 0 ? block - 1 : 0;
+}
+
+const std::vector<uint64_t>* StoreIndex::postings(uint16_t channel) const {
+    if (channel >= channelRows.size() || channelRows[channel].empty()) return nullptr;
+    return &channelRows[channel];
+}
+
+size_t StoreIndex::getMemoryBytes() const {
+    size_t bytes = blockFirst.capacity() * sizeof(uint64_t);
+    for (size_t i = 0; i < channelRows.size(); i++) {
+        bytes += channelRows[i].capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,50 @@
+#ifndef STORE_INDEX_H
+#define STORE_INDEX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// 查询条件：频点 [firstChannel, lastChannel]、接收时间 [startUs, endUs)、RSSI 不低于 minRssi
+struct StoreQuery {
+    uint16_t firstChannel;
+    uint16_t lastChannel;
+    uint64_t startUs;
+    uint64_t endUs;
+    int16_t minRssi;
+    
+    StoreQuery()
+        : firstChannel(0), lastChannel(UINT16_MAX), startUs(0), endUs(UINT64_MAX),
+          minRssi(INT16_MIN) {}
+};
+
+// 列式存储的内存索引：打开存储时由 channel、received 两列重建，追加时增量维护
+// 主索引：received 单调不减（ColumnStore::append 保证），每 BLOCK_ROWS 行记下块首的接收时间，
+//         二分找到块后再在块内二分，只需读一个块的 received 列
+// 倒排表：每个频点一个按行号递增的数组
+class StoreIndex {
+public:
+    static const uint64_t BLOCK_ROWS = 4096;
+    
+    StoreIndex();
+    
+    void clear();
+    void add(uint64_t row, uint16_t channel, uint64_t receivedUs);
+    
+    uint64_t getRows() const { return rows; }
+    uint64_t getLastReceived() const { return lastReceived; }
+    // 第一条 received >= timeUs 的行落在该块内，或者是下一块的首行
+    uint64_t candidateBlock(uint64_t timeUs) const;
+    // 频点的行号数组；没有记录时返回 nullptr
+    const std::vector<uint64_t>* postings(uint16_t channel) const;
+    uint16_t getChannelCount() const { return (uint16_t)channelRows.size(); }
+    size_t getMemoryBytes() const;
+    
+private:
+    std::vector<uint64_t> blockFirst;
+    std::vector<std::vector<uint64_t> > channelRows;
+    uint64_t rows;
+    uint64_t lastReceived;
+};
+
+#endif // STORE_INDEX_H
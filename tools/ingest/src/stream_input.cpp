@@ -0,0 +1,162 @@
+#include "stream_input.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint64_t monotonicMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t wallClockUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static speed_t baudConstant(uint32_t baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return 0;
+    }
+}
+
+StreamInput::StreamInput(const std::string& device, const std::string& path, uint32_t baud,
+                         bool follow, Aggregator* aggregator)
+    : device(device), path(path), baud(baud), follow(follow), isTty(false), fd(-1),
+      aggregator(aggregator), decoder(this) {
+}
+
+StreamInput::~StreamInput() {
+    if (fd >= 0) close(fd);
+}
+
+bool StreamInput::open(const std::string& storeRoot) {
+    fd = ::open(path.c_str(), O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "[Input] %s: open %s: %s\n", device.c_str(), path.c_str(), strerror(errno));
+        return false;
+    }
+    
+    isTty = isatty(fd);
+    if (isTty && !configureTty()) return false;
+    
+    if (!store.open(storeRoot + "/" + device)) return false;
+    
+    fprintf(stderr, "[Input] %s: %s (%s), %llu rows in store\n", device.c_str(), path.c_str(),
+            isTty ? "tty" : (follow ? "file, follow" : "file, replay"),
+            (unsigned long long)store.getRowCount());
+    publishStats();
+    return true;
+}
+
+bool StreamInput::configureTty() {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        fprintf(stderr, "[Input] %s: tcgetattr: %s\n", device.c_str(), strerror(errno));
+        return false;
+    }
+    
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    
+    // USB CDC 忽略波特率，pty 也不关心；只对真实 UART 有意义
+    speed_t speed = baudConstant(baud);
+    if (speed == 0) {
+        fprintf(stderr, "[Input] %s: unsupported baud %u\n", device.c_str(), baud);
+        return false;
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        fprintf(stderr, "[Input] %s: tcsetattr: %s\n", device.c_str(), strerror(errno));
+        return false;
+    }
+    tcflush(fd, TCIFLUSH);
+    return true;
+}
+
+void StreamInput::run(const std::atomic<bool>& stop) {
+    uint8_t buffer[4096];
+    uint64_t lastFlush = monotonicMs();
+    
+    while (!stop.load()) {
+        bool idle = false;
+        
+        if (isTty) {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            int ready = poll(&pfd, 1, 200);
+            if (ready < 0 && errno != EINTR) break;
+            idle = ready <= 0;
+        }
+        
+        if (!idle) {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                decoder.feed(buffer, (size_t)n);
+            } else if (n < 0 && errno != EINTR && errno != EAGAIN) {
+                fprintf(stderr, "[Input] %s: read: %s\n", device.c_str(), strerror(errno));
+                break;
+            } else if (n == 0) {
+                // 文件读到末尾：回放模式结束，追尾模式等待新数据
+                if (!isTty && !follow) break;
+                idle = true;
+            }
+        }
+        
+        if (idle && !isTty) {
+            usleep(100 * 1000);
+        }
+        
+        uint64_t now = monotonicMs();
+        if (now - lastFlush >= FLUSH_INTERVAL_MS) {
+            store.flush();
+            publishStats();
+            lastFlush = now;
+        }
+    }
+    
+    store.flush();
+    publishStats();
+    fprintf(stderr, "[Input] %s: stopped, %llu records, %llu checksum errors, %llu rows\n",
+            device.c_str(), (unsigned long long)decoder.getRecordCount(),
+            (unsigned long long)decoder.getChecksumErrors(),
+            (unsigned long long)store.getRowCount());
+}
+
+void StreamInput::onEvent(const Event& event) {
+    store.append(event, wallClockUs());
+    aggregator->addEvent(device, event);
+}
+
+void StreamInput::onMetrics(const std::vector<uint32_t>& values) {
+    aggregator->setDeviceMetrics(device, values);
+}
+
+void StreamInput::publishStats() {
+    Aggregator::StreamStats stats;
+    stats.records = decoder.getRecordCount();
+    stats.checksumErrors = decoder.getChecksumErrors();
+    stats.skippedBytes = decoder.getSkippedBytes();
+    stats.storedRows = store.getRowCount() - store.getBufferedRows();
+    aggregator->setStreamStats(device, stats);
+}
@@ -0,0 +1,45 @@
+#ifndef STREAM_INPUT_H
+#define STREAM_INPUT_H
+
+#include "aggregator.h"
+#include "column_store.h"
+#include "record_decoder.h"
+#include <atomic>
+#include <string>
+
+// 单个设备的输入：串口/pty 以原始模式读取，普通文件按回放处理（可选 --follow 追尾）
+class StreamInput : public RecordDecoder::Handler {
+public:
+    StreamInput(const std::string& device, const std::string& path, uint32_t baud,
+                bool follow, Aggregator* aggregator);
+    ~StreamInput();
+    
+    bool open(const std::string& storeRoot);
+    // 阻塞读取直到输入结束或 stop 置位
+    void run(const std::atomic<bool>& stop);
+    
+    const std::string& getDevice() const { return device; }
+    
+    void onEvent(const Event& event);
+    void onMetrics(const std::vector<uint32_t>& values);
+    
+private:
+    // 落盘与统计上报间隔
+    static const uint64_t FLUSH_INTERVAL_MS = 1000;
+    
+    bool configureTty();
+    void publishStats();
+    
+    std::string device;
+    std::string path;
+    uint32_t baud;
+    bool follow;
+    bool isTty;
+    int fd;
+    
+    Aggregator* aggregator;
+    ColumnStore store;
+    RecordDecoder decoder;
+};
+
+#endif // STREAM_INPUT_H
@@ -0,0 +1,187 @@
+// 回放测试：把录制的设备流（含启动日志、错误校验和、设备重启）按小块送入解码器，
+// 检查分帧、聚合导出和列式存储的结果
+#include "aggregator.h"
+#include "column_store.h"
+#include "record_decoder.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static bool readFile(const std::string& path, std::vector<uint8_t>* out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    uint8_t buffer[1024];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        out->insert(out->end(), buffer, buffer + n);
+    }
+    fclose(f);
+    return true;
+}
+
+static bool contains(const std::string& text, const char* line) {
+    return text.find(std::string(line) + "\n") != std::string::npos;
+}
+
+// 与 StreamInput 相同的接法，接收时间用递增的假时钟代替墙钟
+struct ReplayHandler : public RecordDecoder::Handler {
+    Aggregator* aggregator;
+    ColumnStore* store;
+    uint64_t clockUs;
+    std::vector<Event> events;
+    
+    void onEvent(const Event& event) {
+        events.push_back(event);
+        store->append(event, clockUs);
+        aggregator->addEvent("replay", event);
+    }
+    
+    void onMetrics(const std::vector<uint32_t>& values) {
+        aggregator->setDeviceMetrics("replay", values);
+    }
+};
+
+// 每个 HELP/TYPE 之后只能出现本族的样本，且同一族不能出现两次
+static void checkFamiliesContiguous(const std::string& text) {
+    std::vector<std::string> seen;
+    std::string family;
+    size_t pos = 0;
+    
+    while (pos < text.size()) {
+        size_t end = text.find('\n', pos);
+        std::string line = text.substr(pos, end - pos);
+        pos = end + 1;
+    
+        if (line.compare(0, 7, "# TYPE ") == 0) {
+            family = line.substr(7, line.find(' ', 7) - 7);
+            for (size_t i = 0; i < seen.size(); i++) CHECK(seen[i] != family);
+            seen.push_back(family);
+        } else if (line[0] != '#') {
+            std::string name = line.substr(0, line.find_first_of("{ "));
+            bool summaryPart = name == family + "_sum" || name == family + "_count";
+            CHECK(name == family || summaryPart);
+        }
+    }
+}
+
+static uint64_t readColumn(const std::string& dir, const char* name, size_t width, uint64_t row) {
+    std::string path = dir + "/" + name;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return UINT64_MAX;
+    uint8_t bytes[8];
+    ssize_t n = pread(fd, bytes, width, (off_t)(row * width));
+    close(fd);
+    if (n != (ssize_t)width) return UINT64_MAX;
+    
+    uint64_t value = 0;
+    for (size_t b = 0; b < width; b++) value |= (uint64_t)bytes[b] << (8 * b);
+    return value;
+}
+
+int main() {
+    std::vector<uint8_t> stream;
+    if (!readFile(INGEST_TEST_DATA "/replay.bin", &stream)) {
+        fprintf(stderr, "cannot read %s\n", INGEST_TEST_DATA "/replay.bin");
+        return 1;
+    }
+    
+    char dirTemplate[] = "/tmp/lorascope-replay-XXXXXX";
+    if (!mkdtemp(dirTemplate)) return 1;
+    std::string dir = dirTemplate;
+    
+    Aggregator aggregator;
+    ColumnStore store;
+    CHECK(store.open(dir));
+    
+    ReplayHandler handler;
+    handler.aggregator = &aggregator;
+    handler.store = &store;
+    handler.clockUs = 1700000000000000ULL;
+    RecordDecoder decoder(&handler);
+    
+    // 小块送入，覆盖记录跨块和同步字节落在块尾的情况
+    for (size_t pos = 0; pos < stream.size(); pos += 7) {
+        size_t n = stream.size() - pos < 7 ? stream.size() - pos : 7;
+        decoder.feed(&stream[pos], n);
+        handler.clockUs += 100000;
+    }
+    CHECK(store.flush());
+    
+    // 6 个事件 + 2 个指标记录；校验和错误的第 7 个事件被丢弃
+    CHECK(decoder.getRecordCount() == 8);
+    CHECK(decoder.getChecksumErrors() >= 1);
+    CHECK(handler.events.size() == 6);
+    for (size_t i = 0; i < handler.events.size(); i++) {
+        CHECK(handler.events[i].timestampUs != 3200000);
+    }
+    
+    // 设备重启后运行时间从头开始
+    CHECK(handler.events[4].timestampUs < handler.events[3].timestampUs);
+    CHECK(handler.events[0].protocol == 3);
+    CHECK(handler.events[1].duplicate);
+    CHECK(handler.events[2].type == EVENT_RX_CRC_ERROR);
+    
+    std::string text = aggregator.renderPrometheus();
+    checkFamiliesContiguous(text);
+    CHECK(contains(text, "# TYPE lorascope_channel_rssi_dbm summary"));
+    CHECK(contains(text, "lorascope_channel_rssi_dbm_sum{device=\"replay\",channel=\"0\"} -256"));
+    CHECK(contains(text, "lorascope_channel_rssi_dbm_count{device=\"replay\",channel=\"0\"} 3"));
+    CHECK(contains(text, "lorascope_channel_rssi_max_dbm{device=\"replay\",channel=\"2\"} -60"));
+    CHECK(contains(text, "lorascope_channel_events_total{device=\"replay\",channel=\"1\",frequency=\"433375000\",type=\"rx_error\"} 1"));
+    CHECK(contains(text, "lorascope_channel_protocol_frames_total{device=\"replay\",channel=\"0\",protocol=\"lora_aprs\"} 1"));
+    CHECK(contains(text, "lorascope_channel_duplicates_total{device=\"replay\",channel=\"0\"} 1"));
+    CHECK(contains(text, "# TYPE lorascope_device_frames_received_total counter"));
+    CHECK(contains(text, "lorascope_device_frames_received_total{device=\"replay\"} 2"));
+    CHECK(contains(text, "# TYPE lorascope_device_free_heap gauge"));
+    CHECK(contains(text, "lorascope_device_free_heap{device=\"replay\"} 90000"));
+    
+    // 存储：运行时间列原样保存，接收时间列跨重启仍单调
+    CHECK(store.getRowCount() == 6);
+    uint64_t previous = 0;
+    for (uint64_t row = 0; row < 6; row++) {
+        CHECK(readColumn(dir, "time.u64", 8, row) == handler.events[row].timestampUs);
+        CHECK(readColumn(dir, "channel.u16", 2, row) == handler.events[row].channel);
+        uint64_t received = readColumn(dir, "received.u64", 8, row);
+        CHECK(received != UINT64_MAX && received >= previous);
+        previous = received;
+    }
+    store.close();
+    
+    // 旧版本存储没有接收时间列：重新打开时保留已有行，缺失的列补 0
+    std::string receivedPath = dir + "/received.u64";
+    unlink(receivedPath.c_str());
+    CHECK(store.open(dir));
+    CHECK(store.getRowCount() == 6);
+    CHECK(readColumn(dir, "received.u64", 8, 5) == 0);
+    CHECK(readColumn(dir, "time.u64", 8, 5) == handler.events[5].timestampUs);
+    store.close();
+    
+    const char* names[] = {
+        "time.u64", "channel.u16", "rssi.i8", "length.u8", "type.u8", "protocol.u8", "received.u64"
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        unlink((dir + "/" + names[i]).c_str());
+    }
+    rmdir(dir.c_str());
+    
+    if (failures > 0) {
+        fprintf(stderr, "replay_test: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("replay_test: ok\n");
+    return 0;
+}
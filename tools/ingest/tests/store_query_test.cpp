@@ -0,0 +1,170 @@
+// 存储查询测试：写入跨越多个索引块的合成事件（含一次墙钟回拨），
+// 把索引查询的结果与逐行过滤的结果比对，重新打开后（索引由列文件重建）再比对一次
+#include "column_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+static const uint64_t ROWS = 10000;
+static const uint16_t CHANNELS = 40;
+static const uint64_t BASE_US = 1700000000000000ULL;
+
+struct Expected {
+    uint64_t receivedUs;
+    uint64_t timestampUs;
+    uint16_t channel;
+    int8_t rssi;
+};
+
+static std::vector<uint64_t> expectedRows(const std::vector<Expected>& rows, const StoreQuery& query) {
+    std::vector<uint64_t> result;
+    for (uint64_t i = 0; i < rows.size(); i++) {
+        const Expected& row = rows[i];
+        if (row.channel >= query.firstChannel && row.channel <= query.lastChannel &&
+            row.receivedUs >= query.startUs && row.receivedUs < query.endUs && row.rssi >= query.minRssi) {
+            result.push_back(i);
+        }
+    }
+    return result;
+}
+
+static void checkQuery(ColumnStore* store, const std::vector<Expected>& rows, const StoreQuery& query,
+                       bool expectPostings) {
+    std::vector<uint64_t> expected = expectedRows(rows, query);
+    StoreCursor cursor = store->query(query);
+    CHECK(cursor.usesPostings() == expectPostings);
+    
+    StoredEvent event;
+    size_t matched = 0;
+    while (cursor.next(&event)) {
+        CHECK(matched < expected.size() && event.row == expected[matched]);
+        if (event.row < rows.size()) {
+            CHECK(event.receivedUs == rows[event.row].receivedUs);
+            CHECK(event.timestampUs == rows[event.row].timestampUs);
+            CHECK(event.channel == rows[event.row].channel);
+            CHECK(event.rssi == rows[event.row].rssi);
+        }
+        matched++;
+    }
+    CHECK(matched == expected.size());
+    
+    // 倒排表路径只读频点匹配的候选行
+    if (expectPostings && query.minRssi == INT16_MIN) {
+        CHECK(cursor.getRowsRead() == expected.size());
+    }
+}
+
+static void checkQueries(ColumnStore* store, const std::vector<Expected>& rows) {
+    StoreQuery all;
+    checkQuery(store, rows, all, false);
+    
+    // 单个频点：倒排表
+    StoreQuery single;
+    single.firstChannel = 7;
+    single.lastChannel = 7;
+    checkQuery(store, rows, single, true);
+    
+    // 跨越块边界和回拨点的时间窗口，窄频点范围
+    StoreQuery window;
+    window.firstChannel = 3;
+    window.lastChannel = 5;
+    window.startUs = rows[4000].receivedUs;
+    window.endUs = rows[9000].receivedUs;
+    checkQuery(store, rows, window, true);
+    
+    // 宽频点范围加 RSSI 下限：倒排表总长超过时间区间，按时间扫描
+    StoreQuery wide;
+    wide.firstChannel = 0;
+    wide.lastChannel = 30;
+    wide.startUs = rows[100].receivedUs + 1;
+    wide.endUs = rows[5000].receivedUs;
+    wide.minRssi = -80;
+    checkQuery(store, rows, wide, false);
+    
+    // 空结果：时间窗口早于全部数据、频点超出计划
+    StoreQuery before;
+    before.endUs = BASE_US;
+    checkQuery(store, rows, before, false);
+    StoreQuery missing;
+    missing.firstChannel = CHANNELS + 10;
+    checkQuery(store, rows, missing, true);
+}
+
+int main() {
+    char dirTemplate[] = "/tmp/lorascope-query-XXXXXX";
+    if (!mkdtemp(dirTemplate)) return 1;
+    std::string dir = dirTemplate;
+    
+    ColumnStore store;
+    CHECK(store.open(dir));
+    
+    std::vector<Expected> rows;
+    uint64_t clockUs = BASE_US;
+    for (uint64_t i = 0; i < ROWS; i++) {
+        Event event = Event();
+        event.timestampUs = (i % 3000) * 1000;
+        event.channel = (uint16_t)((i * 7 + i / 13) % CHANNELS);
+        event.rssi = (int8_t)(-120 + (int)(i * 37 % 90));
+        event.length = 24;
+    
+        // 第 6000 行处墙钟回拨 1 秒：存储沿用上一行的时间
+        clockUs += i == 6000 ? 0 : 250;
+        uint64_t receivedUs = i == 6000 ? clockUs - 1000000 : clockUs;
+        store.append(event, receivedUs);
+    
+        Expected expected;
+        expected.receivedUs = clockUs;
+        expected.timestampUs = event.timestampUs;
+        expected.channel = event.channel;
+        expected.rssi = event.rssi;
+        rows.push_back(expected);
+    
+        // 查询会先落盘缓冲的行，中途查询不影响后续追加
+        if (i == 2500) {
+            StoreQuery query;
+            query.firstChannel = 1;
+            query.lastChannel = 1;
+            StoreCursor cursor = store.query(query);
+            StoredEvent stored;
+            uint64_t count = 0;
+            while (cursor.next(&stored)) count++;
+            CHECK(count == expectedRows(rows, query).size());
+        }
+    }
+    
+    checkQueries(&store, rows);
+    store.close();
+    
+    // 重新打开：索引由 channel、received 两列重建
+    CHECK(store.open(dir));
+    CHECK(store.getRowCount() == ROWS);
+    CHECK(store.getIndex().getRows() == ROWS);
+    checkQueries(&store, rows);
+    store.close();
+    
+    const char* names[] = {
+        "time.u64", "channel.u16", "rssi.i8", "length.u8", "type.u8", "protocol.u8", "received.u64"
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        unlink((dir + "/" + names[i]).c_str());
+    }
+    rmdir(dir.c_str());
+    
+    if (failures > 0) {
+        fprintf(stderr, "store_query_test: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("store_query_test: ok\n");
+    return 0;
+}